@@ -1,6 +1,21 @@
+#include <math.h>
+#include <pthread.h>
 #include <raylib.h>
-#include <raymath.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "net/pong_netplay.h"
+#include "net/pong_server.h"
+#include "sim/pong.h"
+#include "sim/pong_ai.h"
+#include "sim/pong_clock.h"
+#include "sim/pong_input.h"
+#include "sim/pong_link.h"
+#include "sim/pong_pacer.h"
+#include "sim/pong_replay.h"
+#include "sim/pong_triple.h"
 
 /* 
 *  Template 5.5 - Basic window 
@@ -11,38 +26,220 @@
 *
 *  make build_osx
 *  ./bin/build_osx
+*  ./bin/build_osx --record match.pongrec    (saves this offline session's inputs on exit)
+*  ./bin/build_osx --play match.pongrec      (replays a recording instead of the keyboard;
+*                                             LEFT/RIGHT jump 5 s back/forward)
+*  ./bin/build_osx --host 7777               (online: player 1, waits for a player 2)
+*  ./bin/build_osx --join 10.0.0.2:7777      (online: player 2; either paddle key set works)
+*  ./bin/build_osx --server 10.0.0.2:7777    (online against ./bin/pong_server serve; either key set)
+*  ./bin/build_osx --server 10.0.0.2:7779 --match 42   (match 42 on ./bin/pong_multiserver serve)
+*  ./bin/build_osx --join 10.0.0.2:7777 --netsim bad-wifi   (online through an emulated link, both ways)
+*  ./bin/build_osx --cpu normal              (single player: the CPU plays player 2; easy, normal, hard
+*                                             or reaction_ms,error_px such as 200,60)
+*  ./bin/build_osx --pacing vsync            (start frames right after each swap instead of
+*                                             just before the next vblank; F1 switches live)
+*
+*  The simulation runs on its own thread at PONG_TICK_RATE and hands each tick to
+*  this (the window's) thread through a triple buffer; this thread only pumps
+*  window events, publishes the keys and draws the newest frame at display rate.
+*  Between frames it keeps polling the keyboard about every millisecond (in both
+*  pacing modes) and logs each key change with its time, so a tick applies a
+*  paddle key for the part of the tick it was really down rather than from the
+*  next frame on.
+*
+*  Frames are paced (src/sim/pong_pacer.h): rather than drawing right after a swap
+*  and waiting out the refresh in the next one, the loop keeps polling until just
+*  before the predicted vblank, then latches the keys, runs the newest tick on to
+*  that moment with them (offline) and draws. The bottom line of the screen shows
+*  how long key changes take to reach the screen; the log has it for both modes.
 */
 
-const int screenWidth = 1280;
-const int screenHeight = 720;
+#define NET_INPUT_DELAY 2       // Ticks (8 ms) of local delay that hide most rollbacks
+#define INPUT_POLL_INTERVAL 0.001   // Seconds between keyboard polls while waiting to draw
+#define PACER_SPIN 0.001            // Poll without sleeping this close to the latch (sleeps overshoot)
+#define LATENCY_LOG_INTERVAL 10.0   // Seconds between latency lines in the log
+
+const int screenWidth = ARENA_WIDTH;
+const int screenHeight = ARENA_HEIGHT;
 const char* title = "Pong";
-const float PADDLE_SPEED = 600.0f; 
-const int WINNING_SCORE = 3;
-const float BALL_SPEED_INCREMENT = 1.03f;
-const float BALL_MAX_SPEED = 1500.0f;
-const float MAX_DEFLECTION_ANGLE = 5 * (PI / 12); // 75 degrees in radians
-const float SIDE_PADDING = 32.0f;   // Inset from left/right edges
-
-typedef enum {
-    GAME_START,
-    GAME_SERVE,
-    GAME_PLAYING,
-    GAME_PAUSE,
-    GAME_OVER
-} GameState;
 
+// Set up by main(), then owned by the simulation thread; the atomics are how the
+// window thread talks to it. Absent modes are NULL.
 typedef struct {
-    Vector2 position;
-    Vector2 size;
-    Color color;
-} Paddle;
+    PongState game;
+    PongState previous;
+    PongRecorder *recorder;
+    PongReplay *replay;
+    PongNetplay *net;
+    PongRemote *remote;
+    PongCpu *cpu;
+
+    PongKeyLog keys;                // Timestamped key changes from the window thread
+    _Atomic int seekSeconds;        // Replay scrub request
+    _Atomic bool quit;
+    PongTripleBuffer frames;
+} Session;
+
+// host:port into its parts; false if either is missing
+static bool SplitAddress(const char *address, char *host, size_t cap, uint16_t *port) {
+    const char *colon = strrchr(address, ':');
+    size_t length = colon ? (size_t)(colon - address) : 0;
+    if (!colon || length == 0 || length >= cap) return false;
+
+    memcpy(host, address, length);
+    host[length] = '\0';
+    *port = (uint16_t)atoi(colon + 1);
+    return true;
+}
+
+// Online each side steers its own paddle with either key set
+static PongInput OwnKeys(PongInput input, int player) {
+    PongInput own = input & (PONG_INPUT_SERVE | PONG_INPUT_PAUSE);
+    if (input & (PONG_INPUT_P1_UP | PONG_INPUT_P2_UP)) own |= (player == 0) ? PONG_INPUT_P1_UP : PONG_INPUT_P2_UP;
+    if (input & (PONG_INPUT_P1_DOWN | PONG_INPUT_P2_DOWN)) own |= (player == 0) ? PONG_INPUT_P1_DOWN : PONG_INPUT_P2_DOWN;
+    return own;
+}
 
+// The window thread's view of the keyboard
 typedef struct {
-    Vector2 position;
-    float radius;
-    Vector2 velocity;
-    Color color;
-} Ball;
+    PongInput down;                 // Paddle keys as last pushed to the log
+    double changedAt;               // Oldest paddle key change not on screen yet; 0 if none
+    bool togglePacing;              // F1 pressed
+} KeyState;
+
+// Push every key change since the last call to the log, stamped now: raylib
+// only knows the keys as of its last poll, so stamps are as fine as the polling.
+static void SampleKeys(Session *s, KeyState *keys, bool scrub) {
+    static const struct { int key; PongInput bit; } paddleKeys[] = {
+        { KEY_W, PONG_INPUT_P1_UP }, { KEY_S, PONG_INPUT_P1_DOWN }, { KEY_UP, PONG_INPUT_P2_UP }, { KEY_DOWN, PONG_INPUT_P2_DOWN },
+    };
+    double now = pong_clock_now();
+
+    for (int i = 0; i < 4; i++) {
+        bool isDown = IsKeyDown(paddleKeys[i].key);
+        if (isDown != ((keys->down & paddleKeys[i].bit) != 0) && pong_keylog_push(&s->keys, now, paddleKeys[i].bit, isDown)) {
+            keys->down ^= paddleKeys[i].bit;
+            if (keys->changedAt == 0.0) keys->changedAt = now;
+        }
+    }
+
+    // The press queue also has presses that were released again before this poll
+    for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed()) {
+        if (key == KEY_SPACE) pong_keylog_push(&s->keys, now, PONG_INPUT_SERVE, true);
+        if (key == KEY_P)     pong_keylog_push(&s->keys, now, PONG_INPUT_PAUSE, true);
+        if (key == KEY_F1)    keys->togglePacing = true;
+        if (scrub && (key == KEY_LEFT || key == KEY_RIGHT)) atomic_store(&s->seekSeconds, (key == KEY_RIGHT) ? 5 : -5);
+    }
+}
+
+// Keep polling the keyboard about every millisecond until the given time, sleeping
+// between polls except for the last PACER_SPIN
+static void PollKeysUntil(Session *s, KeyState *keys, bool scrub, double until) {
+    for (double now = pong_clock_now(); now < until; now = pong_clock_now()) {
+        if (until - now > PACER_SPIN) pong_clock_sleep_until(fmin(now + INPUT_POLL_INTERVAL, until - PACER_SPIN));
+        PollInputEvents();
+        SampleKeys(s, keys, scrub);
+    }
+}
+
+static void LogLatency(const PongLatencyStats latency[2], const PongPacer *pacer) {
+    double mean[2], p50[2], p99[2];
+    for (int paced = 0; paced < 2; paced++) pong_latency_summary(&latency[paced], &mean[paced], &p50[paced], &p99[paced]);
+    TraceLog(LOG_INFO, "input to present: paced %.1f ms mean, %.1f p50, %.1f p99 (%d changes); plain vsync %.1f ms mean, "
+             "%.1f p50, %.1f p99 (%d changes); %d of %d frames missed their vblank", mean[1] * 1e3, p50[1] * 1e3, p99[1] * 1e3,
+             latency[1].count, mean[0] * 1e3, p50[0] * 1e3, p99[0] * 1e3, latency[0].count, pacer->missed, pacer->frames);
+}
+
+// Fixed-rate ticks on a thread of their own: a vsync wait or a slow frame on the
+// window thread no longer holds back physics or the network, and every tick reads
+// the key changes that happened during it
+static void *SimThread(void *arg) {
+    Session *s = arg;
+    PongClock clock = { 0 };
+    PongInput pressed = 0;      // SPACE/P presses wait here until a tick consumes them
+    bool desyncReported = false;
+    uint64_t tick = 0;
+    double last = pong_clock_now();
+
+    while (!atomic_load(&s->quit)) {
+        double now = pong_clock_now();
+        int ticks = pong_clock_advance(&clock, now - last);
+        double end = now - clock.accumulator;      // When the last of these ticks ends
+        last = now;
+
+        // Scrubbing: the nearest keyframe plus at most one keyframe interval of ticks
+        int seek = atomic_exchange(&s->seekSeconds, 0);
+        if (seek && s->replay) {
+            int target = (int)s->replay->tick + seek * PONG_TICK_RATE;
+            pong_replay_seek(s->replay, (target > 0) ? (uint32_t)target : 0, &s->game);
+            s->previous = s->game;
+        }
+
+        int ran = 0;
+        for (; ran < ticks; ran++) {
+            double tickEnd = end - (ticks - 1 - ran) * (double)PONG_TICK_DT;
+            PongInput input = pong_keylog_tick(&s->keys, tickEnd - PONG_TICK_DT, tickEnd);
+            pressed |= input & (PONG_INPUT_SERVE | PONG_INPUT_PAUSE);
+            input |= pressed;
+
+            // The session re-simulates whenever the peer's real input differs
+            // from its prediction, so the view can jump by a few pixels
+            if (s->net) {
+                PongState before = s->net->rb.state;
+                if (!pong_netplay_tick(s->net, OwnKeys(input, s->net->host ? 0 : 1))) break;     // Connecting, or waiting for the peer
+                s->previous = before;
+                s->game = s->net->rb.state;
+                pressed = 0;
+
+                const PongDesync *desync = &s->net->rb.desync;
+                if (!desyncReported && desync->status == PONG_DESYNC_FOUND && desync->haveLocal && desync->haveRemote) {
+                    char local[PONG_DESYNC_DUMP_TEXT], peer[PONG_DESYNC_DUMP_TEXT];
+                    pong_desync_dump(&desync->local, local, sizeof(local));
+                    pong_desync_dump(&desync->remote, peer, sizeof(peer));
+                    TraceLog(LOG_ERROR, "DESYNC: the simulations differ from tick %u%s\nthis side:\n%speer:\n%s", desync->divergedAt,
+                             desync->exact ? "" : " or earlier", local, peer);
+                    desyncReported = true;
+                }
+                continue;
+            }
+
+            // Own paddle moves this tick; the ball and opponent follow each snapshot
+            if (s->remote) {
+                PongState before = pong_client_view(&s->remote->client);
+                if (!pong_remote_tick(s->remote, OwnKeys(input, s->remote->client.player))) break;     // Waiting for the match to start
+                s->previous = before;
+                s->game = pong_client_view(&s->remote->client);
+                pressed = 0;
+                continue;
+            }
+
+            pressed = 0;    // A press acts on exactly one tick
+
+            // Playback replaces the keyboard; at the end of the recording the game holds still
+            if (s->replay && !pong_replay_next(s->replay, &input)) {
+                s->previous = s->game;
+                break;
+            }
+            if (s->cpu) input = (input & ~(PongInput)(PONG_INPUT_P2_UP | PONG_INPUT_P2_DOWN | PONG_INPUT_P2_PARTS)) | pong_cpu_input(s->cpu, &s->game);
+            if (s->recorder) pong_record_tick(s->recorder, &s->game, input);
+
+            s->previous = s->game;
+            pong_step(&s->game, input, PONG_TICK_DT);
+        }
+        tick += (uint64_t)ran;
+
+        // The leftover time is how far past the newest tick the display may be
+        PongSimFrame *frame = pong_triple_back(&s->frames);
+        frame->previous = s->previous;
+        frame->current = s->game;
+        frame->tick = tick;
+        frame->time = end;
+        pong_triple_publish(&s->frames);
+
+        pong_clock_sleep_until(now + (PONG_TICK_DT - clock.accumulator));
+    }
+    return NULL;
+}
 
 // Draw a dashed center line
 static void DrawCenterLine(int w, int h, Color color) {
@@ -55,199 +252,204 @@ static void DrawCenterLine(int w, int h, Color color) {
     }
 }
 
-int main(void) {
+int main(int argc, char **argv) {
+    // --- Replay / online mode ---
+    const char *recordPath = NULL;
+    const char *playPath = NULL;
+    const char *hostPort = NULL;
+    const char *joinAddress = NULL;
+    const char *serverAddress = NULL;
+    const char *netsim = NULL;
+    const char *cpuLevel = NULL;
+    const char *pacing = "adaptive";
+    uint32_t matchId = 0;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--play") == 0) playPath = argv[++i];
+        else if (strcmp(argv[i], "--host") == 0) hostPort = argv[++i];
+        else if (strcmp(argv[i], "--join") == 0) joinAddress = argv[++i];
+        else if (strcmp(argv[i], "--server") == 0) serverAddress = argv[++i];
+        else if (strcmp(argv[i], "--match") == 0) matchId = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--netsim") == 0) netsim = argv[++i];
+        else if (strcmp(argv[i], "--cpu") == 0) cpuLevel = argv[++i];
+        else if (strcmp(argv[i], "--pacing") == 0) pacing = argv[++i];
+    }
+
+    // Online ticks come from the rollback session or the server, never through the
+    // recorder or the replay, so the two would silently do nothing
+    if ((recordPath || playPath) && (hostPort || joinAddress || serverAddress)) {
+        TraceLog(LOG_ERROR, "--record and --play work offline only, not with --host, --join or --server");
+        return 1;
+    }
+
+    PongReplay replay = { 0 };
+    if (playPath && (!pong_replay_load(&replay, playPath) || replay.tickRate != PONG_TICK_RATE)) {
+        TraceLog(LOG_ERROR, "Cannot play %s (missing, corrupt, or recorded by a different build)", playPath);
+        return 1;
+    }
+
     // --- Initialization ---
     // Enable V-Sync
     SetConfigFlags(FLAG_VSYNC_HINT);
 
     InitWindow(screenWidth, screenHeight, title);
 
-    // --- Game variables ---
-    Paddle player1 = { {SIDE_PADDING, (screenHeight - 120) * 0.5f}, {16, 120}, DARKGREEN };
-    Paddle player2 = { {screenWidth - SIDE_PADDING - 16, (screenHeight - 120) * 0.5f}, {16, 120}, DARKGREEN };
-    Ball ball = { { (screenWidth / 2) - 9, (screenHeight / 2) - 9}, 8, {2, 2}, DARKGREEN};
-
-    // --- Game state variables ---
-    GameState gameState = GAME_START;
-    int score1 = 0, score2 = 0;
-    int serveDirection = 1;
-    bool serveJustHappened = true;
-
-    // Main game loop
-    while (!WindowShouldClose()) {
-
-        // --- Update ---
-        float dt = GetFrameTime();
-        
-        switch (gameState) {
-            case GAME_START:
-                if (IsKeyPressed(KEY_SPACE)) {
-                    serveJustHappened = true;
-                    gameState = GAME_SERVE;
-                }
-                break;
-            case GAME_SERVE:
-                // Reset ball position if a serve just happened
-                if (serveJustHappened) {
-                    ball.position = (Vector2){ screenWidth/2.0f, screenHeight/2.0f };
-                    ball.velocity = (Vector2){ 0, 0 };
-                    // Does not recenter
-                    serveJustHappened = false;
-                }
-
-                // Allow paddle movement during serve
-                if (IsKeyDown(KEY_W))      player1.position.y -= PADDLE_SPEED * dt;
-                if (IsKeyDown(KEY_S))      player1.position.y += PADDLE_SPEED * dt;
-                if (IsKeyDown(KEY_UP))     player2.position.y -= PADDLE_SPEED * dt;
-                if (IsKeyDown(KEY_DOWN))   player2.position.y += PADDLE_SPEED * dt;
-
-                player1.position.y = Clamp(player1.position.y, 0, screenHeight - player1.size.y);
-                player2.position.y = Clamp(player2.position.y, 0, screenHeight - player2.size.y);
-
-                // Serve the ball
-                if (IsKeyPressed(KEY_SPACE)) {
-                    // Small random angle so serves aren’t identical
-                    float ang = DEG2RAD * (float)GetRandomValue(-20, 20);
-                    Vector2 dir = Vector2Normalize((Vector2){ serveDirection * cosf(ang), sinf(ang) });
-                    ball.velocity = Vector2Scale(dir, 480.0f);  // ~same speed as before
-                    gameState = GAME_PLAYING;
-                }
-                break;
-            case GAME_PLAYING:
-                if (IsKeyPressed(KEY_P)) {
-                    gameState = GAME_PAUSE;
-                    break;
-                }
-
-                if (IsKeyDown(KEY_W)) player1.position.y -= PADDLE_SPEED * dt;
-                if (IsKeyDown(KEY_S)) player1.position.y += PADDLE_SPEED * dt;
+    // --- Game state ---
+    // All rules live in the simulation core (src/sim); this loop only feeds it keys and draws it
+    PongState game;
+    uint64_t seed = playPath ? replay.seed : (uint64_t)GetRandomValue(0, 0x7FFFFFFF);   // Only the seed comes from raylib
+    pong_init(&game, seed);
 
-                if (IsKeyDown(KEY_UP)) player2.position.y -= PADDLE_SPEED * dt;
-                if (IsKeyDown(KEY_DOWN)) player2.position.y += PADDLE_SPEED * dt;
+    PongRecorder recorder;
+    pong_record_init(&recorder, seed, PONG_TICK_RATE);
 
-                player1.position.y = Clamp(player1.position.y, 0, screenHeight - player1.size.y);
-                player2.position.y = Clamp(player2.position.y, 0, screenHeight - player2.size.y);
-
-                ball.position.x += ball.velocity.x * dt;
-                ball.position.y += ball.velocity.y * dt;
+    PongNetplay net = { 0 };
+    bool online = hostPort || joinAddress;
+    if (hostPort && !pong_netplay_host(&net, (uint16_t)atoi(hostPort), seed, NET_INPUT_DELAY)) {
+        TraceLog(LOG_ERROR, "Cannot listen on port %s", hostPort);
+        return 1;
+    }
+    if (joinAddress) {
+        char host[256];
+        uint16_t port;
+        if (!SplitAddress(joinAddress, host, sizeof(host), &port)) {
+            TraceLog(LOG_ERROR, "--join expects host:port");
+            return 1;
+        }
+        if (!pong_netplay_join(&net, host, port, NET_INPUT_DELAY)) {
+            TraceLog(LOG_ERROR, "Cannot reach %s", joinAddress);
+            return 1;
+        }
+    }
 
-                if (ball.position.y - ball.radius <= 0) {
-                    ball.position.y = ball.radius;
-                    ball.velocity.y *= -1;
-                }
+    // Match on a server: it owns the ball and the score, we predict our own paddle
+    PongRemote remote = { 0 };
+    if (serverAddress) {
+        char host[256];
+        uint16_t port;
+        if (!SplitAddress(serverAddress, host, sizeof(host), &port)) {
+            TraceLog(LOG_ERROR, "--server expects host:port");
+            return 1;
+        }
+        if (!pong_remote_connect(&remote, host, port, matchId)) {
+            TraceLog(LOG_ERROR, "Cannot reach %s", serverAddress);
+            return 1;
+        }
+    }
 
-                if (ball.position.y + ball.radius >= screenHeight) {
-                    ball.position.y = screenHeight - ball.radius;
-                    ball.velocity.y *= -1;
-                }
+    // Emulated network between this process and the socket: a profile name or link script
+    PongLink links[2] = { 0 };
+    if (netsim) {
+        PongLinkScript script;
+        if (!pong_link_parse(netsim, &script) || !pong_link_init(&links[0], &script, seed) ||
+            !pong_link_init(&links[1], &script, seed + 1)) {
+            TraceLog(LOG_ERROR, "--netsim: unknown link %s", netsim);
+            return 1;
+        }
+        if (online) pong_udp_shape(&net.udp, &links[0], &links[1]);
+        if (serverAddress) pong_udp_shape(&remote.udp, &links[0], &links[1]);
+    }
 
-                Rectangle ballCollision = {
-                    ball.position.x - ball.radius,
-                    ball.position.y - ball.radius,
-                    ball.radius * 2.0f,
-                    ball.radius * 2.0f
-                };
-
-                Rectangle player1Collision = {
-                    player1.position.x,
-                    player1.position.y,
-                    player1.size.x,
-                    player1.size.y
-                };
-
-                Rectangle player2Collision = {
-                    player2.position.x,
-                    player2.position.y,
-                    player2.size.x,
-                    player2.size.y
-                };
-
-                // Player 1 collision with angle calculation
-                if (CheckCollisionRecs(ballCollision, player1Collision) && ball.velocity.x < 0) {
-                    // Calculate hit position relative to paddle center
-                    float paddleCenterY = player1.position.y + (player1.size.y / 2);
-                    float t = (ball.position.y - paddleCenterY) / (player1.size.y / 2);
-                    t = Clamp(t, -1.0f, 1.0f); // Ensure t is within [-1, 1]
-
-                    // Calculate deflection angle
-                    float deflectionAngle = t * MAX_DEFLECTION_ANGLE;
-
-                    // Calculate speed
-                    float currentSpeed = Vector2Length(ball.velocity);
-                    float newSpeed = fminf(currentSpeed * BALL_SPEED_INCREMENT, BALL_MAX_SPEED);
-
-                    // Update ball velocity based on deflection angle
-                    Vector2 direction = Vector2Normalize((Vector2){ cosf(deflectionAngle), sinf(deflectionAngle) });
-                    ball.velocity = Vector2Scale(direction, newSpeed); 
-
-                    // Nudge ball out of paddle
-                    ball.position.x = player1.position.x + player1.size.x + ball.radius;
-                }
+    // Single player: player 2's keys come from the CPU instead of the keyboard
+    PongCpu cpu;
+    PongCpuConfig cpuConfig;
+    if (cpuLevel && !pong_cpu_parse(cpuLevel, &cpuConfig)) {
+        TraceLog(LOG_ERROR, "--cpu expects easy, normal, hard or reaction_ms,error_px");
+        return 1;
+    }
+    if (cpuLevel) pong_cpu_init(&cpu, 1, cpuConfig, seed);
+
+    // Physics runs at a fixed tick on its own thread; frames only draw what it publishes
+    Session session = {
+        .game = game,
+        .previous = game,
+        .recorder = recordPath ? &recorder : NULL,
+        .replay = playPath ? &replay : NULL,
+        .net = online ? &net : NULL,
+        .remote = serverAddress ? &remote : NULL,
+        .cpu = (cpuLevel && !playPath) ? &cpu : NULL,
+    };
+    PongSimFrame first = { game, game, 0, pong_clock_now() };
+    pong_triple_init(&session.frames, &first);
+    pong_keylog_init(&session.keys);
+
+    pthread_t simThread;
+    if (pthread_create(&simThread, NULL, SimThread, &session) != 0) {
+        TraceLog(LOG_ERROR, "Cannot start the simulation thread");
+        return 1;
+    }
 
-                // Player 2 collision with angle calculation
-                if (CheckCollisionRecs(ballCollision, player2Collision) && ball.velocity.x > 0) {
-                    // Calculate hit position relative to paddle center
-                    float paddleCenterY = player2.position.y + (player2.size.y / 2);
-                    float t = (ball.position.y - paddleCenterY) / (player2.size.y / 2);
-                    t = Clamp(t, -1.0f, 1.0f); // Ensure t is within [-1, 1]
+    int refreshRate = GetMonitorRefreshRate(GetCurrentMonitor());
+    PongPacer pacer;
+    pong_pacer_init(&pacer, 1.0 / ((refreshRate > 0) ? refreshRate : 60), pong_clock_now());
+    bool paced = strcmp(pacing, "vsync") != 0;
+    PongLatencyStats latency[2] = { 0 };    // By paced
+    double nextLog = pong_clock_now() + LATENCY_LOG_INTERVAL;
+    KeyState keys = { 0 };
 
-                    // Calculate deflection angle
-                    float deflectionAngle = t * MAX_DEFLECTION_ANGLE;
+    // Only offline, keyboard-driven matches know every key that moves a paddle
+    bool predictable = !playPath && !online && !serverAddress;
+    PongInput predictKeys = PONG_INPUT_P1_UP | PONG_INPUT_P1_DOWN | (cpuLevel ? 0 : PONG_INPUT_P2_UP | PONG_INPUT_P2_DOWN);
 
-                    // Calculate speed
-                    float currentSpeed = Vector2Length(ball.velocity);
-                    float newSpeed = fminf(currentSpeed * BALL_SPEED_INCREMENT, BALL_MAX_SPEED);
+    // Main game loop
+    while (!WindowShouldClose()) {
 
-                    // Update ball velocity based on deflection angle
-                    Vector2 direction = Vector2Normalize((Vector2){ -cosf(deflectionAngle), sinf(deflectionAngle) });
-                    ball.velocity = Vector2Scale(direction, newSpeed); 
+        // --- Input --- (raylib polls window events inside EndDrawing(), on this thread)
+        // Both modes poll about every millisecond, so every key change is stamped
+        // within a millisecond of happening; only the latch differs. Paced keeps
+        // polling up to the latch, plain vsync latches straight away and polls
+        // after drawing instead (below).
+        SampleKeys(&session, &keys, playPath != NULL);
+        if (paced) PollKeysUntil(&session, &keys, playPath != NULL, pong_pacer_latch_time(&pacer));
+        double latched = pong_clock_now();
+
+        if (keys.togglePacing) {
+            paced = !paced;
+            keys.togglePacing = false;
+            keys.changedAt = 0.0;
+            LogLatency(latency, &pacer);
+        }
 
-                    // Nudge ball out of paddle
-                    ball.position.x = player2.position.x - ball.radius;
-                }
+        const PongSimFrame *frame = pong_triple_latest(&session.frames);
+        PongState view;
+        bool showsChange;
+        if (predictable) {
+            // The newest tick run on to the latch with the keys held now: the
+            // next real tick starts from the same state with the same keys
+            view = frame->current;
+            double ahead = latched - frame->time;
+            ahead = fmin(ahead, PONG_TICK_DT);
+            if (ahead > 0.0) pong_step(&view, keys.down & predictKeys, (float)ahead);
+
+            // The CPU's keys are not known here: its paddle carries on as it last moved
+            if (cpuLevel && ahead > 0.0) {
+                float moved = frame->current.player2.position.y - frame->previous.player2.position.y;
+                view.player2.position.y = frame->current.player2.position.y + moved * (float)(ahead / PONG_TICK_DT);
+            }
+            showsChange = keys.changedAt != 0.0;      // Every change so far is in the view
+        } else {
+            // The newest tick, blended from the one before by how long ago it was due
+            float alpha = (float)((latched - frame->time) / PONG_TICK_DT);
+            alpha = (alpha < 0.0f) ? 0.0f : (alpha > 1.0f) ? 1.0f : alpha;
+            view = pong_interpolate(&frame->previous, &frame->current, alpha);
+            showsChange = keys.changedAt != 0.0 && frame->time > keys.changedAt;
+        }
 
-                if (ball.position.x + ball.radius < 0) {
-                    score2++;
-                    if (score2 >= WINNING_SCORE) {
-                        gameState = GAME_OVER;
-                        break;
-                    }
-                    serveDirection = 1;
-                    serveJustHappened = true;
-                    gameState = GAME_SERVE;
-                }
+        // Changes logged from here on wait for a later frame
+        double shownChangeAt = showsChange ? keys.changedAt : 0.0;
+        if (showsChange) keys.changedAt = 0.0;
 
-                if (ball.position.x - ball.radius > screenWidth) {
-                    score1++;
-                    if (score1 >= WINNING_SCORE) {
-                        gameState = GAME_OVER;
-                        break;
-                    }
-                    serveDirection = -1;
-                    serveJustHappened = true;
-                    gameState = GAME_SERVE;
-                }
-                break;
-            case GAME_PAUSE:
-                if (IsKeyPressed(KEY_P)) {
-                    gameState = GAME_PLAYING; // Resume game
-                }
-                break;
-            case GAME_OVER:
-                if (IsKeyPressed(KEY_SPACE)) {
-                    score1 = 0;
-                    score2 = 0;
-                    serveDirection = (GetRandomValue(0,1) == 0) ? -1 : 1;
-                    gameState = GAME_START;
-                }
-                break;
-        }
+        const Paddle player1 = view.player1;
+        const Paddle player2 = view.player2;
+        const Ball ball = view.ball;
+        const int score1 = view.score1;
+        const int score2 = view.score2;
 
         // --- Drawing ---
         BeginDrawing();
         ClearBackground(GREEN);
 
-        switch (gameState) {
+        switch (view.gameState) {
             case GAME_START:
                 // Bar under the title (longer + thicker)
                 DrawRectangle(screenWidth / 2 - 150, screenHeight / 2 - 60, 300, 6, DARKGREEN);
@@ -264,7 +466,8 @@ int main(void) {
 
                 // Bottom hints
                 DrawText("Player 1: W/S keys", screenWidth / 4 - MeasureText("Player 1: W/S keys", 20) / 2, screenHeight - 40, 20, DARKGREEN);
-                DrawText("Player 2: Up/Down keys", screenWidth * 3 / 4 - MeasureText("Player 2: Up/Down keys", 20) / 2, screenHeight - 40, 20, DARKGREEN);
+                const char *player2Hint = cpuLevel ? "Player 2: CPU" : "Player 2: Up/Down keys";
+                DrawText(player2Hint, screenWidth * 3 / 4 - MeasureText(player2Hint, 20) / 2, screenHeight - 40, 20, DARKGREEN);
 
                 // Pause hint (top center)
                 DrawText("Press P to Pause during play", screenWidth / 2 - MeasureText("Press P to Pause during play", 20) / 2, 20, 20, DARKGREEN);
@@ -274,9 +477,9 @@ int main(void) {
                 // DrawCenterLine(screenWidth, screenHeight, DARKGREEN);
 
                 // Draw paddles and ball
-                DrawRectangleV(player1.position, player1.size, player1.color);
-                DrawRectangleV(player2.position, player2.size, player2.color);
-                DrawCircleV(ball.position, ball.radius, ball.color);
+                DrawRectangleV(player1.position, player1.size, DARKGREEN);
+                DrawRectangleV(player2.position, player2.size, DARKGREEN);
+                DrawCircleV(ball.position, ball.radius, DARKGREEN);
 
                 // Text prompt centered
                 int serveFontSize = 32;
@@ -309,9 +512,9 @@ int main(void) {
                 DrawCenterLine(screenWidth, screenHeight, DARKGREEN);
 
                 // Draw paddles and ball
-                DrawRectangleV(player1.position, player1.size, player1.color);
-                DrawRectangleV(player2.position, player2.size, player2.color);
-                DrawCircleV(ball.position, ball.radius, ball.color);
+                DrawRectangleV(player1.position, player1.size, DARKGREEN);
+                DrawRectangleV(player2.position, player2.size, DARKGREEN);
+                DrawCircleV(ball.position, ball.radius, DARKGREEN);
 
                 // Scores centered
                 {
@@ -337,9 +540,9 @@ int main(void) {
                 // DrawCenterLine(screenWidth, screenHeight, DARKGREEN);
 
                 // Draw paddles and ball
-                DrawRectangleV(player1.position, player1.size, player1.color);
-                DrawRectangleV(player2.position, player2.size, player2.color);
-                DrawCircleV(ball.position, ball.radius, ball.color);
+                DrawRectangleV(player1.position, player1.size, DARKGREEN);
+                DrawRectangleV(player2.position, player2.size, DARKGREEN);
+                DrawCircleV(ball.position, ball.radius, DARKGREEN);
 
                 // Scores centered
                 {
@@ -441,10 +644,50 @@ int main(void) {
                 break;
         }
 
+        // Input to present readout
+        double mean, p50, p99;
+        pong_latency_summary(&latency[paced], &mean, &p50, &p99);
+        const char *readout = TextFormat("input to present %.1f ms (p99 %.1f) %s - F1: %s", p50 * 1e3, p99 * 1e3,
+                                         paced ? "paced" : "plain vsync", paced ? "plain vsync" : "paced");
+        DrawText(readout, screenWidth / 2 - MeasureText(readout, 10) / 2, screenHeight - 14, 10, DARKGREEN);
+
+        double submitted = pong_clock_now();
+
+        // Plain vsync: the swap below would block until the vblank without looking
+        // at the keyboard, so poll through the time the paced loop spends polling
+        if (!paced) PollKeysUntil(&session, &keys, playPath != NULL, pong_pacer_latch_time(&pacer));
         EndDrawing();
+        double presented = pong_clock_now();
+        pong_pacer_frame(&pacer, latched, submitted, presented);
+
+        // A swap returns at the vblank that shows the frame
+        if (showsChange) pong_latency_add(&latency[paced], presented - shownChangeAt);
+        if (presented >= nextLog) {
+            LogLatency(latency, &pacer);
+            nextLog = presented + LATENCY_LOG_INTERVAL;
+        }
     }
 
+    atomic_store(&session.quit, true);
+    pthread_join(simThread, NULL);
     CloseWindow();
+    LogLatency(latency, &pacer);
+
+    if (recordPath && !pong_record_save(&recorder, recordPath)) {
+        TraceLog(LOG_ERROR, "Cannot write %s", recordPath);
+    }
+    pong_record_free(&recorder);
+    pong_replay_free(&replay);
+    if (online) pong_netplay_close(&net);
+    if (serverAddress) pong_remote_close(&remote);
+    if (netsim) {
+        TraceLog(LOG_INFO, "netsim: out %llu sent, %llu lost, %llu duplicated, %llu reordered; in %llu, %llu, %llu, %llu",
+                 (unsigned long long)links[0].sent, (unsigned long long)links[0].lost, (unsigned long long)links[0].duplicated,
+                 (unsigned long long)links[0].reordered, (unsigned long long)links[1].sent, (unsigned long long)links[1].lost,
+                 (unsigned long long)links[1].duplicated, (unsigned long long)links[1].reordered);
+        pong_link_free(&links[0]);
+        pong_link_free(&links[1]);
+    }
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,442 @@
+// epoll, timerfd, eventfd, recvmmsg/sendmmsg and thread pinning are Linux-only;
+// on other systems this file compiles to nothing
+#ifdef __linux__
+
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../sim/pong_clock.h"
+#include "../sim/pong_rng.h"
+#include "pong_multiserver.h"
+
+#define NONE -1
+
+static double NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint32_t HashAddr(const PongUdpAddr *addr) {
+    return (uint32_t)pong_rng_mix((uint64_t)addr->ip << 16 | addr->port);
+}
+
+static bool SameAddr(const PongUdpAddr *a, const PongUdpAddr *b) {
+    return a->ip == b->ip && a->port == b->port;
+}
+
+static int FindMatch(const PongShard *shard, uint32_t id) {
+    int i = shard->idBuckets[pong_rng_mix(id) & (uint64_t)shard->bucketMask];
+    while (i != NONE && shard->matches[i].id != id) i = shard->matches[i].idNext;
+    return i;
+}
+
+// Seat slot (match * 2 + player) of a client address, or NONE
+static int FindSeat(const PongShard *shard, const PongUdpAddr *addr) {
+    int seat = shard->addrBuckets[HashAddr(addr) & (uint32_t)shard->bucketMask];
+    while (seat != NONE) {
+        const PongMatch *match = &shard->matches[seat / 2];
+        if (SameAddr(&match->clients[seat % 2], addr)) return seat;
+        seat = match->addrNext[seat % 2];
+    }
+    return NONE;
+}
+
+static int OpenMatch(PongShard *shard, const PongMultiServer *ms, uint32_t id) {
+    if (shard->freeCount == 0) return NONE;
+    int i = shard->freeList[--shard->freeCount];
+    PongMatch *match = &shard->matches[i];
+
+    memset(match, 0, offsetof(PongMatch, auth));
+    match->id = id;
+    match->live = shard->liveCount;
+    shard->live[shard->liveCount++] = i;
+    pong_authority_init(&match->auth, pong_rng_mix(ms->seed ^ id));
+
+    int *bucket = &shard->idBuckets[pong_rng_mix(id) & (uint64_t)shard->bucketMask];
+    match->idNext = *bucket;
+    *bucket = i;
+    return i;
+}
+
+static void Seat(PongShard *shard, int i, int player, const PongUdpAddr *addr) {
+    PongMatch *match = &shard->matches[i];
+    match->clients[player] = *addr;
+    match->seated++;
+
+    int *bucket = &shard->addrBuckets[HashAddr(addr) & (uint32_t)shard->bucketMask];
+    match->addrNext[player] = *bucket;
+    *bucket = i * 2 + player;
+}
+
+static void CloseMatch(PongShard *shard, int i) {
+    PongMatch *match = &shard->matches[i];
+
+    int *link = &shard->idBuckets[pong_rng_mix(match->id) & (uint64_t)shard->bucketMask];
+    while (*link != i) link = &shard->matches[*link].idNext;
+    *link = match->idNext;
+
+    // Receive-only seats (pong_multiserver_seat) were never linked
+    for (int p = 0; p < match->seated; p++) {
+        int seat = i * 2 + p;
+        link = &shard->addrBuckets[HashAddr(&match->clients[p]) & (uint32_t)shard->bucketMask];
+        while (*link != NONE && *link != seat) link = &shard->matches[*link / 2].addrNext[*link % 2];
+        if (*link == seat) *link = match->addrNext[p];
+    }
+
+    int last = shard->live[--shard->liveCount];
+    shard->live[match->live] = last;
+    shard->matches[last].live = match->live;
+    shard->freeList[shard->freeCount++] = i;
+}
+
+static struct sockaddr_in ToSockaddr(const PongUdpAddr *a) {
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(a->ip);
+    addr.sin_port = htons(a->port);
+    return addr;
+}
+
+// Outgoing datagrams of one tick, flushed PONG_SHARD_BATCH at a time
+typedef struct {
+    struct mmsghdr headers[PONG_SHARD_BATCH];
+    struct iovec vectors[PONG_SHARD_BATCH];
+    struct sockaddr_in addrs[PONG_SHARD_BATCH];
+    unsigned char data[PONG_SHARD_BATCH][PONG_SNAPSHOT_PACKET_MAX];
+    int count;
+} SendBatch;
+
+static void Flush(PongShard *shard, SendBatch *batch) {
+    int sent = 0;
+    while (sent < batch->count) {
+        int n = sendmmsg(shard->udp.fd, batch->headers + sent, (unsigned int)(batch->count - sent), 0);
+        if (n <= 0) {
+            shard->sendErrors += (uint64_t)(batch->count - sent);     // Socket buffer full: dropped, like the network would
+            break;
+        }
+        sent += n;
+    }
+    shard->packetsOut += (uint64_t)sent;
+    batch->count = 0;
+}
+
+static void Queue(PongShard *shard, SendBatch *batch, const PongUdpAddr *to, const unsigned char *data, size_t size) {
+    if (size == 0) return;
+    if (batch->count == PONG_SHARD_BATCH) Flush(shard, batch);
+    int k = batch->count++;
+    memcpy(batch->data[k], data, size);
+    batch->addrs[k] = ToSockaddr(to);
+    batch->vectors[k] = (struct iovec){ batch->data[k], size };
+    batch->headers[k] = (struct mmsghdr){ .msg_hdr = { .msg_name = &batch->addrs[k], .msg_namelen = sizeof(batch->addrs[k]),
+                                                       .msg_iov = &batch->vectors[k], .msg_iovlen = 1 } };
+}
+
+static void HandlePacket(PongShard *shard, const PongMultiServer *ms, SendBatch *batch,
+                         const PongUdpAddr *from, const unsigned char *data, size_t size) {
+    int seat = FindSeat(shard, from);
+    uint32_t id;
+
+    if (pong_authority_read_join(data, size, &id)) {
+        if (seat == NONE) {
+            if (id % (uint32_t)ms->shardCount != (uint32_t)shard->index) return;     // Wrong port for this match
+            int i = FindMatch(shard, id);
+            if (i == NONE) i = OpenMatch(shard, ms, id);
+            if (i == NONE || shard->matches[i].seated == 2) return;
+            seat = i * 2 + shard->matches[i].seated;
+            Seat(shard, i, seat % 2, from);
+        }
+
+        // Repeats are answered again in case the WELCOME was lost
+        PongMatch *match = &shard->matches[seat / 2];
+        unsigned char welcome[PONG_SNAPSHOT_PACKET_MAX];
+        Queue(shard, batch, from, welcome, pong_authority_write_welcome(&match->auth, seat % 2, welcome, sizeof(welcome)));
+        match->idleTicks = 0;
+    } else if (seat != NONE) {
+        PongMatch *match = &shard->matches[seat / 2];
+        if (pong_authority_read_input(&match->auth, seat % 2, data, size)) match->idleTicks = 0;
+    }
+}
+
+static void Receive(PongShard *shard, const PongMultiServer *ms, SendBatch *batch) {
+    unsigned char buffers[PONG_SHARD_BATCH][PONG_AUTHORITY_PACKET_MAX];
+    struct mmsghdr headers[PONG_SHARD_BATCH];
+    struct iovec vectors[PONG_SHARD_BATCH];
+    struct sockaddr_in addrs[PONG_SHARD_BATCH];
+
+    for (;;) {
+        for (int k = 0; k < PONG_SHARD_BATCH; k++) {
+            vectors[k] = (struct iovec){ buffers[k], sizeof(buffers[k]) };
+            headers[k] = (struct mmsghdr){ .msg_hdr = { .msg_name = &addrs[k], .msg_namelen = sizeof(addrs[k]),
+                                                        .msg_iov = &vectors[k], .msg_iovlen = 1 } };
+        }
+
+        int n = recvmmsg(shard->udp.fd, headers, PONG_SHARD_BATCH, MSG_DONTWAIT, NULL);
+        if (n <= 0) break;
+
+        shard->packetsIn += (uint64_t)n;
+        for (int k = 0; k < n; k++) {
+            PongUdpAddr from = { ntohl(addrs[k].sin_addr.s_addr), ntohs(addrs[k].sin_port) };
+            HandlePacket(shard, ms, batch, &from, buffers[k], headers[k].msg_len);
+        }
+        if (n < PONG_SHARD_BATCH) break;
+    }
+    Flush(shard, batch);
+}
+
+static void Tick(PongShard *shard, const PongMultiServer *ms, SendBatch *batch) {
+    double start = NowNs();
+    uint32_t timeoutTicks = (uint32_t)(PONG_MATCH_TIMEOUT * ms->tickRate);
+
+    for (int k = 0; k < shard->liveCount; k++) {
+        int i = shard->live[k];
+        PongMatch *match = &shard->matches[i];
+
+        if (!ms->botInput && ++match->idleTicks > timeoutTicks) {
+            CloseMatch(shard, i);
+            k--;        // The last live match moved into slot k
+            continue;
+        }
+        if (match->seated < 2) continue;
+
+        for (int s = 0; s < ms->stepsPerTick; s++) {
+            if (ms->botInput) {
+                for (int p = 0; p < 2; p++) {
+                    pong_authority_queue_input(&match->auth, p, ms->botInput(ms->botUser, match->id, p, &match->auth.state));
+                }
+            }
+            pong_authority_step(&match->auth);
+        }
+
+        for (int p = 0; p < 2; p++) {
+            unsigned char snapshot[PONG_SNAPSHOT_PACKET_MAX];
+            Queue(shard, batch, &match->clients[p], snapshot, pong_authority_write_snapshot(&match->auth, p, snapshot, sizeof(snapshot)));
+        }
+    }
+    Flush(shard, batch);
+
+    double ns = NowNs() - start;
+    shard->samples[shard->ticks % PONG_SHARD_SAMPLES] = (ns < 4e9) ? (uint32_t)ns : UINT32_MAX;
+    shard->ticks++;
+}
+
+typedef struct {
+    PongMultiServer *ms;
+    PongShard *shard;
+} ShardArgs;
+
+static void *ShardMain(void *arg) {
+    ShardArgs args = *(ShardArgs *)arg;
+    free(arg);
+    PongShard *shard = args.shard;
+    SendBatch *batch = calloc(1, sizeof(SendBatch));
+    if (!batch) return NULL;
+
+    // One shard per core; more shards than cores wrap around
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores > 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(shard->index % cores, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    for (;;) {
+        struct epoll_event events[3];
+        int n = epoll_wait(shard->epollFd, events, 3, -1);
+        bool tick = false, stop = false;
+
+        for (int e = 0; e < n; e++) {
+            if (events[e].data.fd == shard->wakeFd) stop = true;
+            else if (events[e].data.fd == shard->udp.fd) Receive(shard, args.ms, batch);
+            else if (events[e].data.fd == shard->timerFd) {
+                uint64_t expirations = 0;
+                if (read(shard->timerFd, &expirations, sizeof(expirations)) == sizeof(expirations) && expirations > 0) {
+                    shard->overruns += expirations - 1;
+                    tick = true;
+                }
+            }
+        }
+        if (stop) break;
+        if (tick) Tick(shard, args.ms, batch);
+    }
+
+    free(batch);
+    return NULL;
+}
+
+static void FreeShard(PongShard *shard) {
+    pong_udp_close(&shard->udp);
+    if (shard->epollFd >= 0) close(shard->epollFd);
+    if (shard->timerFd >= 0) close(shard->timerFd);
+    if (shard->wakeFd >= 0) close(shard->wakeFd);
+    free(shard->matches);
+    free(shard->live);
+    free(shard->freeList);
+    free(shard->idBuckets);
+    free(shard->addrBuckets);
+    free(shard->samples);
+}
+
+static bool InitShard(PongShard *shard, int index, uint16_t port, int capacity, int tickRate) {
+    *shard = (PongShard){ .index = index, .epollFd = -1, .timerFd = -1, .wakeFd = -1 };
+    if (!pong_udp_open(&shard->udp, port)) return false;
+
+    int buckets = 1;
+    while (buckets < capacity * 2) buckets *= 2;
+    shard->bucketMask = buckets - 1;
+    shard->capacity = capacity;
+    shard->matches = malloc((size_t)capacity * sizeof(PongMatch));
+    shard->live = malloc((size_t)capacity * sizeof(int));
+    shard->freeList = malloc((size_t)capacity * sizeof(int));
+    shard->idBuckets = malloc((size_t)buckets * sizeof(int));
+    shard->addrBuckets = malloc((size_t)buckets * sizeof(int));
+    shard->samples = calloc(PONG_SHARD_SAMPLES, sizeof(uint32_t));
+    if (!shard->matches || !shard->live || !shard->freeList || !shard->idBuckets || !shard->addrBuckets || !shard->samples) return false;
+
+    for (int i = 0; i < capacity; i++) shard->freeList[i] = capacity - 1 - i;
+    shard->freeCount = capacity;
+    for (int b = 0; b < buckets; b++) shard->idBuckets[b] = shard->addrBuckets[b] = NONE;
+
+    shard->epollFd = epoll_create1(0);
+    shard->timerFd = timerfd_create(CLOCK_MONOTONIC, 0);
+    shard->wakeFd = eventfd(0, 0);
+    if (shard->epollFd < 0 || shard->timerFd < 0 || shard->wakeFd < 0) return false;
+
+    long periodNs = 1000000000L / tickRate;
+    struct itimerspec period = { { 0, periodNs }, { 0, periodNs } };
+    if (timerfd_settime(shard->timerFd, 0, &period, NULL) < 0) return false;
+
+    int fds[3] = { shard->udp.fd, shard->timerFd, shard->wakeFd };
+    for (int f = 0; f < 3; f++) {
+        struct epoll_event event = { .events = EPOLLIN, .data.fd = fds[f] };
+        if (epoll_ctl(shard->epollFd, EPOLL_CTL_ADD, fds[f], &event) < 0) return false;
+    }
+    return true;
+}
+
+bool pong_multiserver_init(PongMultiServer *ms, uint16_t basePort, int shards, int matchesPerShard, int tickRate, uint64_t seed) {
+    memset(ms, 0, sizeof(*ms));
+    if (shards <= 0 || matchesPerShard <= 0 || tickRate <= 0 || PONG_TICK_RATE % tickRate != 0) return false;
+
+    ms->shards = calloc((size_t)shards, sizeof(PongShard));
+    if (!ms->shards) return false;
+    ms->shardCount = shards;
+    ms->tickRate = tickRate;
+    ms->stepsPerTick = PONG_TICK_RATE / tickRate;
+    ms->seed = seed;
+
+    for (int i = 0; i < shards; i++) {
+        uint16_t port = basePort ? (uint16_t)(basePort + i) : 0;
+        if (!InitShard(&ms->shards[i], i, port, matchesPerShard, tickRate)) {
+            for (int j = 0; j <= i; j++) FreeShard(&ms->shards[j]);
+            free(ms->shards);
+            memset(ms, 0, sizeof(*ms));
+            return false;
+        }
+    }
+    return true;
+}
+
+void pong_multiserver_free(PongMultiServer *ms) {
+    pong_multiserver_stop(ms);
+    for (int i = 0; i < ms->shardCount; i++) FreeShard(&ms->shards[i]);
+    free(ms->shards);
+    memset(ms, 0, sizeof(*ms));
+}
+
+bool pong_multiserver_seat(PongMultiServer *ms, uint32_t match, const PongUdpAddr *player1, const PongUdpAddr *player2) {
+    PongShard *shard = &ms->shards[match % (uint32_t)ms->shardCount];
+    if (FindMatch(shard, match) != NONE) return false;
+
+    int i = OpenMatch(shard, ms, match);
+    if (i == NONE) return false;
+
+    // Receive-only seats never send, so they stay out of the address table
+    PongMatch *m = &shard->matches[i];
+    m->clients[0] = *player1;
+    m->clients[1] = *player2;
+    m->seated = 2;
+    m->addrNext[0] = m->addrNext[1] = NONE;
+    return true;
+}
+
+bool pong_multiserver_start(PongMultiServer *ms) {
+    for (int i = 0; i < ms->shardCount; i++) {
+        PongShard *shard = &ms->shards[i];
+        ShardArgs *args = malloc(sizeof(ShardArgs));
+        if (!args) return false;
+        *args = (ShardArgs){ ms, shard };
+
+        if (pthread_create(&shard->thread, NULL, ShardMain, args) != 0) {
+            free(args);
+            return false;
+        }
+        shard->started = true;
+    }
+    return true;
+}
+
+void pong_multiserver_stop(PongMultiServer *ms) {
+    for (int i = 0; i < ms->shardCount; i++) {
+        PongShard *shard = &ms->shards[i];
+        if (!shard->started) continue;
+
+        uint64_t one = 1;
+        if (write(shard->wakeFd, &one, sizeof(one)) != sizeof(one)) continue;
+        pthread_join(shard->thread, NULL);
+        shard->started = false;
+    }
+}
+
+uint16_t pong_multiserver_port(const PongMultiServer *ms, uint32_t match) {
+    return pong_udp_port(&ms->shards[match % (uint32_t)ms->shardCount].udp);
+}
+
+static int CompareU32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void pong_multiserver_report(const PongMultiServer *ms, int index, PongShardReport *report) {
+    const PongShard *shard = &ms->shards[index];
+    memset(report, 0, sizeof(*report));
+    report->ticks = shard->ticks;
+    report->overruns = shard->overruns;
+    report->matches = shard->liveCount;
+    report->packetsIn = shard->packetsIn;
+    report->packetsOut = shard->packetsOut;
+    report->sendErrors = shard->sendErrors;
+
+    size_t count = (shard->ticks < PONG_SHARD_SAMPLES) ? (size_t)shard->ticks : PONG_SHARD_SAMPLES;
+    uint32_t *sorted = malloc(count * sizeof(uint32_t));
+    if (count == 0 || !sorted) {
+        free(sorted);
+        return;
+    }
+
+    memcpy(sorted, shard->samples, count * sizeof(uint32_t));
+    qsort(sorted, count, sizeof(uint32_t), CompareU32);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++) sum += sorted[i];
+    report->meanUs = sum / (double)count * 1e-3;
+    report->p50Us = sorted[count * 50 / 100] * 1e-3;
+    report->p90Us = sorted[count * 90 / 100] * 1e-3;
+    report->p99Us = sorted[count * 99 / 100] * 1e-3;
+    report->p999Us = sorted[count * 999 / 1000] * 1e-3;
+    report->maxUs = sorted[count - 1] * 1e-3;
+    free(sorted);
+}
+
+#endif // __linux__
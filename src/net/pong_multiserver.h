@@ -0,0 +1,123 @@
+#ifndef PONG_MULTISERVER_H
+#define PONG_MULTISERVER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "../sim/pong_authority.h"
+#include "pong_udp.h"
+
+/*
+*  Multi-match server (Linux)
+*  ----------------------------------------------------------------------------------
+*  Thousands of authoritative matches (src/sim/pong_authority.h) in one process.
+*  Matches are sharded by id across one thread per core: shard i owns every match
+*  with id % shards == i and listens on its own UDP port, basePort + i, so a client
+*  for match m connects to basePort + m % shards and sends JOIN with m. Each shard
+*  thread is pinned to a core and runs an epoll loop over its socket and a timerfd
+*  at the server tick rate; nothing is shared between shards, so there are no
+*  locks on the hot path.
+*
+*  On every server tick a shard steps each started match PONG_TICK_RATE / tickRate
+*  times (the rules always run at the 240 Hz the game uses), sends both players a
+*  snapshot with sendmmsg() and records how long the whole tick took. A match is
+*  created by its first JOIN and closed when neither player has sent anything for
+*  PONG_MATCH_TIMEOUT seconds.
+*
+*  PongMultiServer ms;
+*  pong_multiserver_init(&ms, 7777, shards, matchesPerShard, 120, seed);
+*  pong_multiserver_start(&ms);
+*  ...
+*  pong_multiserver_stop(&ms);
+*  pong_multiserver_report(&ms, shard, &report);
+*  pong_multiserver_free(&ms);
+*/
+
+#define PONG_SHARD_SAMPLES 16384    // Tick durations kept per shard for the percentiles
+#define PONG_SHARD_BATCH   64       // Datagrams per recvmmsg()/sendmmsg() call
+#define PONG_MATCH_TIMEOUT 30       // Seconds without a packet from either player
+
+// Load testing: supplies inputs for seated matches instead of the network.
+typedef PongInput (*PongBotInput)(void *user, uint32_t match, int player, const PongState *state);
+
+typedef struct {
+    uint32_t id;
+    int seated;                     // Players that have joined
+    PongUdpAddr clients[2];
+    uint32_t idleTicks;             // Server ticks since either player was heard
+    int live;                       // Position in the shard's live list
+    int idNext;                     // Hash chains
+    int addrNext[2];
+    PongAuthority auth;
+} PongMatch;
+
+typedef struct {
+    int index;
+    PongUdp udp;
+    int epollFd;
+    int timerFd;
+    int wakeFd;                     // eventfd: stop request
+    pthread_t thread;
+    bool started;
+
+    PongMatch *matches;
+    int capacity;
+    int *live;                      // Indices of open matches, dense
+    int liveCount;
+    int *freeList;
+    int freeCount;
+    int *idBuckets;                 // Match id -> match index chains
+    int *addrBuckets;               // Client address -> match * 2 + player chains
+    int bucketMask;
+
+    // Counters (written by the shard thread only)
+    uint32_t *samples;              // Tick durations, ns, ring of PONG_SHARD_SAMPLES
+    uint64_t ticks;
+    uint64_t overruns;              // Timer expirations missed because a tick ran long
+    uint64_t packetsIn;
+    uint64_t packetsOut;
+    uint64_t sendErrors;
+} PongShard;
+
+typedef struct {
+    PongShard *shards;
+    int shardCount;
+    int tickRate;                   // Server ticks per second
+    int stepsPerTick;               // Simulation ticks per server tick
+    uint64_t seed;                  // Match seeds derive from this and the match id
+    PongBotInput botInput;          // NULL: inputs come from the network
+    void *botUser;
+} PongMultiServer;
+
+typedef struct {
+    uint64_t ticks;
+    uint64_t overruns;
+    int matches;                    // Open at the time of the report
+    double meanUs;
+    double p50Us, p90Us, p99Us, p999Us, maxUs;  // Over the last PONG_SHARD_SAMPLES ticks
+    uint64_t packetsIn;
+    uint64_t packetsOut;
+    uint64_t sendErrors;
+} PongShardReport;
+
+// Allocate shards and open their sockets (basePort 0: any free ports). tickRate
+// must divide PONG_TICK_RATE. No threads run yet.
+bool pong_multiserver_init(PongMultiServer *ms, uint16_t basePort, int shards, int matchesPerShard, int tickRate, uint64_t seed);
+void pong_multiserver_free(PongMultiServer *ms);
+
+// Before start: open match id with both seats taken by addresses that only
+// receive snapshots. With botInput set the match plays by itself. False if the
+// shard is full.
+bool pong_multiserver_seat(PongMultiServer *ms, uint32_t match, const PongUdpAddr *player1, const PongUdpAddr *player2);
+
+// Start one pinned thread per shard / stop and join them.
+bool pong_multiserver_start(PongMultiServer *ms);
+void pong_multiserver_stop(PongMultiServer *ms);
+
+uint16_t pong_multiserver_port(const PongMultiServer *ms, uint32_t match);
+
+// Tick-time percentiles and counters of a shard. Exact after stop; while running
+// the figures may be a tick stale.
+void pong_multiserver_report(const PongMultiServer *ms, int shard, PongShardReport *report);
+
+#endif // PONG_MULTISERVER_H
@@ -0,0 +1,76 @@
+#include <string.h>
+
+#include "pong_netplay.h"
+
+bool pong_netplay_host(PongNetplay *net, uint16_t port, uint64_t seed, int inputDelay) {
+    memset(net, 0, sizeof(*net));
+    if (!pong_udp_open(&net->udp, port)) return false;
+
+    net->host = true;
+    net->seed = seed;
+    pong_rollback_init(&net->rb, seed, 0, inputDelay);
+    return true;
+}
+
+bool pong_netplay_join(PongNetplay *net, const char *host, uint16_t port, int inputDelay) {
+    memset(net, 0, sizeof(*net));
+    if (!pong_udp_open(&net->udp, 0)) return false;
+    if (!pong_udp_connect(&net->udp, host, port)) {
+        pong_udp_close(&net->udp);
+        return false;
+    }
+
+    net->rb.inputDelay = inputDelay;    // Kept until the seed arrives
+    return true;
+}
+
+void pong_netplay_close(PongNetplay *net) {
+    pong_udp_close(&net->udp);
+    memset(net, 0, sizeof(*net));
+}
+
+static void Receive(PongNetplay *net) {
+    unsigned char packet[PONG_ROLLBACK_PACKET_MAX];
+    int size;
+
+    // Host: the first datagram tells us who player 2 is
+    if (net->host && !net->started) {
+        PongUdpAddr from;
+        if (pong_udp_recv_from(&net->udp, packet, sizeof(packet), &from) <= 0) return;
+        if (!pong_udp_connect_addr(&net->udp, &from)) return;
+        net->started = true;
+    }
+
+    while ((size = pong_udp_recv(&net->udp, packet, sizeof(packet))) > 0) {
+        uint64_t seed;
+        if (pong_rollback_read_hello(packet, (size_t)size, &seed)) {
+            if (!net->host && !net->started) {
+                net->seed = seed;
+                pong_rollback_init(&net->rb, seed, 1, net->rb.inputDelay);
+                net->started = true;
+            }
+        } else if (net->started && pong_rollback_read_packet(&net->rb, packet, (size_t)size)) {
+            net->peerSeen = true;
+        }
+    }
+}
+
+bool pong_netplay_tick(PongNetplay *net, PongInput local) {
+    unsigned char packet[PONG_ROLLBACK_PACKET_MAX];
+    Receive(net);
+
+    // Joiner knocks (HELLO with no seed) until the host answers
+    if (!net->started) {
+        if (!net->host) pong_udp_send(&net->udp, packet, pong_rollback_write_hello(0, packet, sizeof(packet)));
+        return false;
+    }
+    if (net->host && !net->peerSeen) pong_udp_send(&net->udp, packet, pong_rollback_write_hello(net->seed, packet, sizeof(packet)));
+
+    pong_rollback_add_local(&net->rb, local);
+    pong_udp_send(&net->udp, packet, pong_rollback_write_packet(&net->rb, packet, sizeof(packet)));
+    bool advanced = pong_rollback_advance(&net->rb);
+
+    size_t desync = pong_rollback_write_desync(&net->rb, packet, sizeof(packet));
+    if (desync) pong_udp_send(&net->udp, packet, desync);
+    return advanced;
+}
@@ -0,0 +1,39 @@
+#ifndef PONG_NETPLAY_H
+#define PONG_NETPLAY_H
+
+#include "../sim/pong_rollback.h"
+#include "pong_udp.h"
+
+/*
+*  Two-player online match
+*  ----------------------------------------------------------------------------------
+*  Glues a rollback session to a UDP socket. The host (player 1) listens on a
+*  port and picks the seed; the joiner (player 2) knocks with HELLO until the
+*  host answers with the seed, and both sides start at tick 0:
+*
+*  pong_netplay_host(&net, 7777, seed);        pong_netplay_join(&net, "10.0.0.2", 7777);
+*  every tick: if (pong_netplay_tick(&net, keys)) draw net.rb.state;
+*/
+
+typedef struct {
+    PongUdp udp;
+    PongRollback rb;
+    bool host;
+    bool started;           // Seed agreed, rollback session running
+    bool peerSeen;          // Host: the joiner's inputs have arrived, stop sending HELLO
+    uint64_t seed;
+} PongNetplay;
+
+// Listen on port as player 1.
+bool pong_netplay_host(PongNetplay *net, uint16_t port, uint64_t seed, int inputDelay);
+
+// Connect to a host as player 2; the session starts once the host answers.
+bool pong_netplay_join(PongNetplay *net, const char *host, uint16_t port, int inputDelay);
+
+void pong_netplay_close(PongNetplay *net);
+
+// Exchange packets, hand the local keys to the session and simulate one tick.
+// False if no tick was simulated: still connecting, or too far ahead of the peer.
+bool pong_netplay_tick(PongNetplay *net, PongInput local);
+
+#endif // PONG_NETPLAY_H
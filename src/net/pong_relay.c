@@ -0,0 +1,269 @@
+// sendmmsg() is Linux-only; elsewhere each datagram is its own sendmsg()
+#ifdef __linux__
+#define _GNU_SOURCE
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "../sim/pong_rng.h"
+#include "pong_relay.h"
+
+#define NONE -1
+
+// Datagrams of one send call. Every header's iovec is one of the two below,
+// which point into the shared frames.
+struct PongRelayBatch {
+#ifdef __linux__
+    struct mmsghdr headers[PONG_RELAY_BATCH];
+#else
+    struct msghdr headers[PONG_RELAY_BATCH];
+#endif
+    struct sockaddr_in addrs[PONG_RELAY_BATCH];
+    size_t sizes[PONG_RELAY_BATCH];
+    struct iovec full;
+    struct iovec delta;
+    int count;
+};
+
+#ifdef __linux__
+#define HEADER(batch, k) (&(batch)->headers[k].msg_hdr)
+#else
+#define HEADER(batch, k) (&(batch)->headers[k])
+#endif
+
+static uint32_t HashAddr(const PongUdpAddr *addr) {
+    return (uint32_t)pong_rng_mix((uint64_t)addr->ip << 16 | addr->port);
+}
+
+static int *Bucket(PongRelay *relay, const PongUdpAddr *addr) {
+    return &relay->buckets[HashAddr(addr) & (uint32_t)relay->bucketMask];
+}
+
+static int FindSpectator(PongRelay *relay, const PongUdpAddr *addr) {
+    int i = *Bucket(relay, addr);
+    while (i != NONE && (relay->spectators[i].addr.ip != addr->ip || relay->spectators[i].addr.port != addr->port)) {
+        i = relay->spectators[i].next;
+    }
+    return i;
+}
+
+static void Unlink(PongRelay *relay, int i) {
+    int *link = Bucket(relay, &relay->spectators[i].addr);
+    while (*link != i) link = &relay->spectators[*link].next;
+    *link = relay->spectators[i].next;
+}
+
+// Keep the table dense: the last spectator moves into the hole
+static void RemoveSpectator(PongRelay *relay, int i) {
+    Unlink(relay, i);
+    int last = --relay->count;
+    if (i == last) return;
+
+    Unlink(relay, last);
+    relay->spectators[i] = relay->spectators[last];
+    int *bucket = Bucket(relay, &relay->spectators[i].addr);
+    relay->spectators[i].next = *bucket;
+    *bucket = i;
+}
+
+bool pong_relay_open(PongRelay *relay, uint16_t port, uint32_t match, int capacity) {
+    memset(relay, 0, sizeof(*relay));
+    relay->udp.fd = -1;
+    if (capacity <= 0) return false;
+
+    int buckets = 1;
+    while (buckets < capacity * 2) buckets <<= 1;
+
+    relay->match = match;
+    relay->capacity = capacity;
+    relay->bucketMask = buckets - 1;
+    relay->spectators = malloc((size_t)capacity * sizeof(PongSpectatorSlot));
+    relay->buckets = malloc((size_t)buckets * sizeof(int));
+    relay->batch = calloc(1, sizeof(struct PongRelayBatch));
+    if (!relay->spectators || !relay->buckets || !relay->batch || !pong_udp_open(&relay->udp, port)) {
+        pong_relay_close(relay);
+        return false;
+    }
+    for (int b = 0; b < buckets; b++) relay->buckets[b] = NONE;
+
+    // Acknowledgements from thousands of spectators arrive in bursts; best effort
+    int rcvbuf = 4 << 20;
+    setsockopt(relay->udp.fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    return true;
+}
+
+void pong_relay_close(PongRelay *relay) {
+    pong_udp_close(&relay->udp);
+    free(relay->spectators);
+    free(relay->buckets);
+    free(relay->batch);
+    memset(relay, 0, sizeof(*relay));
+    relay->udp.fd = -1;
+}
+
+void pong_relay_poll(PongRelay *relay) {
+    unsigned char packet[64];
+    PongUdpAddr from;
+    int n;
+    while ((n = pong_udp_recv_from(&relay->udp, packet, sizeof(packet), &from)) > 0) {
+        uint32_t match, tick;
+        bool needKey;
+        if (!pong_spectate_read(packet, (size_t)n, &match, &tick, &needKey) || match != relay->match) continue;
+
+        int i = FindSpectator(relay, &from);
+        if (i == NONE) {
+            if (relay->count == relay->capacity) continue;
+            i = relay->count++;
+            int *bucket = Bucket(relay, &from);
+            relay->spectators[i] = (PongSpectatorSlot){ .addr = from, .acked = relay->tick, .keyTick = relay->tick,
+                                                        .needKey = true, .next = *bucket };
+            *bucket = i;
+            relay->joins++;
+        }
+
+        PongSpectatorSlot *s = &relay->spectators[i];
+        s->heard = relay->tick;
+        if (tick && (int32_t)(tick - s->acked) > 0) s->acked = tick;
+        if (needKey) s->needKey = true;
+    }
+}
+
+static void Flush(PongRelay *relay) {
+    struct PongRelayBatch *batch = relay->batch;
+    int sent = 0;
+#ifdef __linux__
+    while (sent < batch->count) {
+        int n = sendmmsg(relay->udp.fd, batch->headers + sent, (unsigned int)(batch->count - sent), 0);
+        if (n <= 0) break;     // Socket buffer full: the rest are dropped, like the network would
+        sent += n;
+    }
+#else
+    for (int k = 0; k < batch->count; k++) {
+        if (sendmsg(relay->udp.fd, HEADER(batch, k), 0) >= 0) sent++;
+    }
+#endif
+    for (int k = 0; k < sent; k++) relay->bytes += batch->sizes[k];
+    relay->frames += (uint64_t)sent;
+    relay->sendErrors += (uint64_t)(batch->count - sent);
+    batch->count = 0;
+}
+
+static void Queue(PongRelay *relay, const PongSpectatorSlot *s, struct iovec *frame) {
+    struct PongRelayBatch *batch = relay->batch;
+    if (batch->count == PONG_RELAY_BATCH) Flush(relay);
+
+    int k = batch->count++;
+    batch->addrs[k] = (struct sockaddr_in){ .sin_family = AF_INET, .sin_port = htons(s->addr.port),
+                                            .sin_addr.s_addr = htonl(s->addr.ip) };
+    batch->sizes[k] = frame->iov_len;
+    *HEADER(batch, k) = (struct msghdr){ .msg_name = &batch->addrs[k], .msg_namelen = sizeof(struct sockaddr_in),
+                                         .msg_iov = frame, .msg_iovlen = 1 };
+}
+
+static void QueueKey(PongRelay *relay, PongSpectatorSlot *s) {
+    Queue(relay, s, &relay->batch->full);
+    s->keyTick = relay->tick;
+    s->needKey = false;
+    relay->keyframes++;
+}
+
+void pong_relay_send(PongRelay *relay, PongFrame *full, PongFrame *delta) {
+
+    struct PongRelayBatch *batch = relay->batch;
+    batch->full = (struct iovec){ full->data, full->size };
+    batch->delta = delta ? (struct iovec){ delta->data, delta->size } : batch->full;
+    relay->tick = full->tick;
+
+    for (int i = 0; i < relay->count; i++) {
+        PongSpectatorSlot *s = &relay->spectators[i];
+        if (relay->tick - s->heard > PONG_RELAY_TIMEOUT) {
+            RemoveSpectator(relay, i--);
+            relay->timeouts++;
+            continue;
+        }
+
+        if (s->catchingUp) {
+            // Back once it has decoded a keyframe sent since it fell behind
+            if ((int32_t)(s->acked - s->keyTick) < 0) {
+                if (relay->tick - s->keyTick >= PONG_RELAY_CATCHUP_TICKS) QueueKey(relay, s);
+                continue;
+            }
+            s->catchingUp = false;
+            s->needKey = true;
+        } else if (relay->tick - s->acked > PONG_RELAY_MAX_LAG) {
+            s->catchingUp = true;
+            relay->catchups++;
+            QueueKey(relay, s);
+            continue;
+        }
+
+        if (s->needKey || !delta) QueueKey(relay, s);
+        else Queue(relay, s, &batch->delta);
+    }
+    Flush(relay);
+}
+
+bool pong_spectator_connect(PongSpectator *spectator, const char *host, uint16_t port, uint32_t match) {
+    memset(spectator, 0, sizeof(*spectator));
+    if (!pong_udp_open(&spectator->udp, 0)) return false;
+    if (!pong_udp_connect(&spectator->udp, host, port)) {
+        pong_udp_close(&spectator->udp);
+        return false;
+    }
+
+    pong_watcher_init(&spectator->watcher);
+    spectator->match = match;
+    return true;
+}
+
+void pong_spectator_close(PongSpectator *spectator) {
+    pong_udp_close(&spectator->udp);
+    memset(spectator, 0, sizeof(*spectator));
+}
+
+static void SendSpectate(PongSpectator *spectator, bool needKey) {
+    unsigned char packet[PONG_SPECTATE_BYTES];
+    size_t size = pong_spectate_write(spectator->match, &spectator->watcher, needKey, packet, sizeof(packet));
+    pong_udp_send(&spectator->udp, packet, size);
+}
+
+int pong_spectator_tick(PongSpectator *spectator) {
+    PongWatcher *watcher = &spectator->watcher;
+    uint64_t keyframes = watcher->keyframes;
+    int decoded = 0;
+    bool stuck = false;
+
+    unsigned char packet[PONG_FRAME_MAX];
+    int n;
+    while ((n = pong_udp_recv(&spectator->udp, packet, sizeof(packet))) > 0) {
+        spectator->packets++;
+        PongFrameResult result = pong_watcher_read(watcher, packet, (size_t)n);
+        if (result == PONG_FRAME_DECODED) {
+            decoded++;
+            stuck = false;
+            spectator->asked = false;
+        } else if (result == PONG_FRAME_GAP) {
+            stuck = true;
+        }
+    }
+
+    spectator->quiet = decoded ? 0 : spectator->quiet + 1;
+    if (!watcher->synced || spectator->quiet % PONG_SPECTATE_RETRY == PONG_SPECTATE_RETRY - 1) {
+        // Joining, or nothing for a while: the relay may have dropped us
+        SendSpectate(spectator, true);
+    } else if (stuck) {
+        // Once per tick it is stuck at; the relay's catch-up covers a lost keyframe
+        if (!spectator->asked) SendSpectate(spectator, true);
+        spectator->asked = true;
+    } else if (watcher->keyframes != keyframes || watcher->tick - spectator->ackTick >= PONG_SPECTATE_ACK_TICKS) {
+        SendSpectate(spectator, false);
+        spectator->ackTick = watcher->tick;
+    }
+    return decoded;
+}
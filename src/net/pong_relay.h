@@ -0,0 +1,104 @@
+#ifndef PONG_RELAY_H
+#define PONG_RELAY_H
+
+#include "../sim/pong_clock.h"
+#include "../sim/pong_spectate.h"
+#include "pong_udp.h"
+
+/*
+*  Spectator relay
+*  ----------------------------------------------------------------------------------
+*  Fans one match's stream (src/sim/pong_spectate.h) out to thousands of
+*  spectators over UDP. A spectator sends SPECTATE to join and then every
+*  PONG_SPECTATE_ACK_TICKS with the newest tick it decoded; the relay sends it
+*  every frame. Nothing is encoded or copied per spectator: each datagram's
+*  iovec points at the shared frame, and the datagrams go out
+*  PONG_RELAY_BATCH per sendmmsg() call (one sendmsg() each outside Linux).
+*
+*  No spectator has a queue. One that falls behind - it reports a gap, or has
+*  not acknowledged anything for PONG_RELAY_MAX_LAG ticks - stops getting deltas
+*  and gets a keyframe every PONG_RELAY_CATCHUP_TICKS instead; the first
+*  acknowledgement of one puts it back on the delta stream from the current
+*  keyframe. A slow reader costs the relay one small datagram every quarter of a
+*  second, however far behind it is.
+*
+*  relay:                                      spectator:
+*  pong_relay_open(&relay, 7800, match, 10000);   pong_spectator_connect(&spectator, "10.0.0.2", 7800, match);
+*  every frame:                                every frame:
+*    pong_stream_push(&stream, &state, tick);    pong_spectator_tick(&spectator);
+*    pong_relay_poll(&relay);                    draw spectator.watcher.state
+*    pong_relay_send(&relay, stream.full, stream.delta);
+*/
+
+#define PONG_RELAY_BATCH          256                   // Datagrams per sendmmsg() call
+#define PONG_RELAY_MAX_LAG        PONG_TICK_RATE        // Ticks without an acknowledgement before catch-up (1 s)
+#define PONG_RELAY_CATCHUP_TICKS  (PONG_TICK_RATE / 4)  // Keyframe interval for a spectator catching up
+#define PONG_RELAY_TIMEOUT        (10 * PONG_TICK_RATE) // Ticks without a packet before a spectator is dropped
+#define PONG_SPECTATE_ACK_TICKS   (PONG_TICK_RATE / 8)  // How often a spectator acknowledges
+#define PONG_SPECTATE_RETRY       32                    // Spectator ticks without a frame before it knocks again
+
+typedef struct {
+    PongUdpAddr addr;
+    uint32_t acked;                 // Newest tick the spectator has decoded (as of joining, until it says)
+    uint32_t heard;                 // Relay tick it last sent anything
+    uint32_t keyTick;               // Tick of the last keyframe sent to it
+    bool catchingUp;
+    bool needKey;                   // Send the next keyframe instead of the delta
+    int next;                       // Address hash chain
+} PongSpectatorSlot;
+
+struct PongRelayBatch;
+
+typedef struct {
+    PongUdp udp;
+    uint32_t match;
+    uint32_t tick;                  // Tick of the newest frame sent
+
+    PongSpectatorSlot *spectators;  // Dense
+    int count;
+    int capacity;
+    int *buckets;
+    int bucketMask;
+    struct PongRelayBatch *batch;
+
+    // Counters
+    uint64_t joins;
+    uint64_t timeouts;
+    uint64_t catchups;              // Times a spectator fell behind
+    uint64_t frames;                // Datagrams sent, keyframes included
+    uint64_t keyframes;
+    uint64_t bytes;
+    uint64_t sendErrors;
+} PongRelay;
+
+typedef struct {
+    PongUdp udp;
+    PongWatcher watcher;
+    uint32_t match;
+    uint32_t ackTick;               // Watcher tick of the last acknowledgement
+    bool asked;                     // Keyframe already requested at the watcher's current tick
+    uint32_t quiet;                 // Ticks since a frame was decoded
+    uint64_t packets;
+} PongSpectator;
+
+// Listen on port for spectators of match, at most capacity of them.
+bool pong_relay_open(PongRelay *relay, uint16_t port, uint32_t match, int capacity);
+void pong_relay_close(PongRelay *relay);
+
+// Read every waiting SPECTATE packet.
+void pong_relay_poll(PongRelay *relay);
+
+// Send the frame of one tick to every spectator: delta to those following the
+// stream, full to the rest (delta may be NULL: everyone gets full). Both are
+// borrowed: the caller keeps them alive until this returns.
+void pong_relay_send(PongRelay *relay, PongFrame *full, PongFrame *delta);
+
+bool pong_spectator_connect(PongSpectator *spectator, const char *host, uint16_t port, uint32_t match);
+void pong_spectator_close(PongSpectator *spectator);
+
+// Call once per frame: decode every waiting frame and acknowledge (or ask for a
+// keyframe). Returns how many frames were decoded. Until the first it sends
+// SPECTATE every call to join, and again after PONG_SPECTATE_RETRY quiet calls.
+int pong_spectator_tick(PongSpectator *spectator);
+
+#endif // PONG_RELAY_H
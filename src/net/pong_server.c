@@ -0,0 +1,99 @@
+#include <string.h>
+
+#include "pong_server.h"
+
+bool pong_server_open(PongServer *server, uint16_t port, uint64_t seed) {
+    memset(server, 0, sizeof(*server));
+    if (!pong_udp_open(&server->udp, port)) return false;
+    pong_authority_init(&server->auth, seed);
+    return true;
+}
+
+void pong_server_close(PongServer *server) {
+    pong_udp_close(&server->udp);
+    memset(server, 0, sizeof(*server));
+}
+
+static int FindClient(const PongServer *server, const PongUdpAddr *addr) {
+    for (int i = 0; i < server->joined; i++) {
+        if (server->clients[i].ip == addr->ip && server->clients[i].port == addr->port) return i;
+    }
+    return -1;
+}
+
+static void Receive(PongServer *server) {
+    unsigned char packet[PONG_AUTHORITY_PACKET_MAX];
+    PongUdpAddr from;
+    int size;
+
+    while ((size = pong_udp_recv_from(&server->udp, packet, sizeof(packet), &from)) > 0) {
+        int player = FindClient(server, &from);
+        uint32_t match;
+
+        // JOIN from a new address takes the next free seat; repeats are answered
+        // again in case the WELCOME was lost
+        if (pong_authority_read_join(packet, (size_t)size, &match)) {
+            if (player < 0 && server->joined < 2) {
+                player = server->joined++;
+                server->clients[player] = from;
+            }
+            if (player >= 0) {
+                unsigned char welcome[16];
+                size_t length = pong_authority_write_welcome(&server->auth, player, welcome, sizeof(welcome));
+                pong_udp_send_to(&server->udp, &from, welcome, length);
+            }
+        } else if (player >= 0) {
+            pong_authority_read_input(&server->auth, player, packet, (size_t)size);
+        }
+    }
+}
+
+bool pong_server_tick(PongServer *server) {
+    Receive(server);
+    if (server->joined < 2) return false;
+
+    pong_authority_step(&server->auth);
+
+    for (int player = 0; player < 2; player++) {
+        unsigned char snapshot[PONG_SNAPSHOT_PACKET_MAX];
+        size_t size = pong_authority_write_snapshot(&server->auth, player, snapshot, sizeof(snapshot));
+        pong_udp_send_to(&server->udp, &server->clients[player], snapshot, size);
+    }
+    return true;
+}
+
+bool pong_remote_connect(PongRemote *remote, const char *host, uint16_t port, uint32_t match) {
+    memset(remote, 0, sizeof(*remote));
+    if (!pong_udp_open(&remote->udp, 0)) return false;
+    if (!pong_udp_connect(&remote->udp, host, port)) {
+        pong_udp_close(&remote->udp);
+        return false;
+    }
+
+    pong_client_init(&remote->client);
+    remote->match = match;
+    return true;
+}
+
+void pong_remote_close(PongRemote *remote) {
+    pong_udp_close(&remote->udp);
+    memset(remote, 0, sizeof(*remote));
+}
+
+bool pong_remote_tick(PongRemote *remote, PongInput keys) {
+    unsigned char packet[PONG_AUTHORITY_PACKET_MAX];
+    int size;
+
+    while ((size = pong_udp_recv(&remote->udp, packet, sizeof(packet))) > 0) {
+        pong_client_read(&remote->client, packet, (size_t)size);
+    }
+
+    if (!remote->client.joined) {
+        pong_udp_send(&remote->udp, packet, pong_client_write_join(remote->match, packet, sizeof(packet)));
+        return false;
+    }
+
+    bool stepped = pong_client_input(&remote->client, keys);
+    pong_udp_send(&remote->udp, packet, pong_client_write_input(&remote->client, packet, sizeof(packet)));
+    return stepped;
+}
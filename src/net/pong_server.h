@@ -0,0 +1,49 @@
+#ifndef PONG_SERVER_H
+#define PONG_SERVER_H
+
+#include "../sim/pong_authority.h"
+#include "pong_udp.h"
+
+/*
+*  Authoritative match over UDP
+*  ----------------------------------------------------------------------------------
+*  Both ends of src/sim/pong_authority.h on a socket. The server listens on a
+*  port; the first two addresses to send JOIN become player 1 and player 2, and
+*  the match starts once both are in. Every tick after that it steps the match
+*  and sends each client its snapshot. A client knocks with JOIN until WELCOME
+*  arrives, then sends its unapplied inputs every tick.
+*
+*  server:                                 client:
+*  pong_server_open(&server, 7777, seed);  pong_remote_connect(&remote, "10.0.0.2", 7777, 0);
+*  every tick: pong_server_tick(&server);  every tick: pong_remote_tick(&remote, keys);
+*                                                      draw pong_client_view(&remote.client)
+*/
+
+typedef struct {
+    PongUdp udp;
+    PongAuthority auth;
+    PongUdpAddr clients[2];
+    int joined;                 // Clients known so far
+} PongServer;
+
+typedef struct {
+    PongUdp udp;
+    PongClient client;
+    uint32_t match;             // Asked for in JOIN; only multi-match servers look at it
+} PongRemote;
+
+bool pong_server_open(PongServer *server, uint16_t port, uint64_t seed);
+void pong_server_close(PongServer *server);
+
+// Read every waiting packet, then step the match and send snapshots if both
+// players are in. False while still waiting for players.
+bool pong_server_tick(PongServer *server);
+
+bool pong_remote_connect(PongRemote *remote, const char *host, uint16_t port, uint32_t match);
+void pong_remote_close(PongRemote *remote);
+
+// Read snapshots, apply this tick's keys to the prediction and send the
+// unapplied inputs. False until the match has started.
+bool pong_remote_tick(PongRemote *remote, PongInput keys);
+
+#endif // PONG_SERVER_H
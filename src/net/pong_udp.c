@@ -0,0 +1,176 @@
+#define _POSIX_C_SOURCE 200809L
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pong_udp.h"
+
+bool pong_udp_open(PongUdp *udp, uint16_t port) {
+    *udp = (PongUdp){ .fd = -1 };
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return false;
+
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0 ||
+        bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return false;
+    }
+
+    udp->fd = fd;
+    return true;
+}
+
+void pong_udp_close(PongUdp *udp) {
+    if (udp->fd >= 0) close(udp->fd);
+    *udp = (PongUdp){ .fd = -1 };
+}
+
+uint16_t pong_udp_port(const PongUdp *udp) {
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    if (getsockname(udp->fd, (struct sockaddr *)&addr, &length) < 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+static double NowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec * 1e-6;
+}
+
+// Shaped packets carry their address in the tag; 0 = the connected peer
+static uint64_t AddrTag(const PongUdpAddr *a) {
+    return (uint64_t)1 << 48 | (uint64_t)a->ip << 16 | a->port;
+}
+
+static PongUdpAddr TagAddr(uint64_t tag) {
+    return (PongUdpAddr){ (uint32_t)(tag >> 16), (uint16_t)tag };
+}
+
+static struct sockaddr_in ToSockaddr(const PongUdpAddr *a) {
+    struct sockaddr_in addr = { 0 };
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(a->ip);
+    addr.sin_port = htons(a->port);
+    return addr;
+}
+
+bool pong_udp_connect(PongUdp *udp, const char *host, uint16_t port) {
+    struct addrinfo hints = { 0 }, *result = NULL;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if (getaddrinfo(host, NULL, &hints, &result) != 0 || !result) return false;
+
+    struct sockaddr_in addr;
+    memcpy(&addr, result->ai_addr, sizeof(addr));
+    addr.sin_port = htons(port);
+    freeaddrinfo(result);
+
+    if (connect(udp->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) return false;
+    udp->connected = true;
+    return true;
+}
+
+bool pong_udp_connect_addr(PongUdp *udp, const PongUdpAddr *peer) {
+    struct sockaddr_in addr = ToSockaddr(peer);
+    if (connect(udp->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) return false;
+    udp->connected = true;
+    return true;
+}
+
+static bool RawSend(PongUdp *udp, const PongUdpAddr *to, const void *data, size_t size) {
+    if (!to) return udp->connected && send(udp->fd, data, size, 0) == (ssize_t)size;
+    struct sockaddr_in addr = ToSockaddr(to);
+    return sendto(udp->fd, data, size, 0, (struct sockaddr *)&addr, sizeof(addr)) == (ssize_t)size;
+}
+
+// Nothing to read. ECONNREFUSED: an ICMP error for an earlier send (the peer's
+// port is not open yet), which for a datagram game is the same as silence.
+static int NothingWaiting(void) {
+    return (errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED) ? 0 : -1;
+}
+
+static int RawRecv(PongUdp *udp, void *buffer, size_t cap, PongUdpAddr *from) {
+    struct sockaddr_in addr;
+    socklen_t length = sizeof(addr);
+    ssize_t n = recvfrom(udp->fd, buffer, cap, 0, (struct sockaddr *)&addr, &length);
+    if (n < 0) return NothingWaiting();
+
+    if (from) *from = (PongUdpAddr){ ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port) };
+    return (int)n;
+}
+
+// Put on the wire whatever the outbound link has let through
+static void Pump(PongUdp *udp, double now) {
+    PongLinkPacket packet;
+    while (pong_link_due(udp->outbound, now, &packet)) {
+        PongUdpAddr to = TagAddr(packet.tag);
+        RawSend(udp, packet.tag ? &to : NULL, packet.data, packet.size);
+    }
+}
+
+static bool Send(PongUdp *udp, const PongUdpAddr *to, const void *data, size_t size) {
+    if (!udp->outbound) return RawSend(udp, to, data, size);
+
+    // Accepted by the network; whether it arrives is the link's business
+    double now = NowMs();
+    if (!to && !udp->connected) return false;
+    pong_link_send(udp->outbound, now, data, size, to ? AddrTag(to) : 0);
+    Pump(udp, now);
+    return true;
+}
+
+static int Recv(PongUdp *udp, void *buffer, size_t cap, PongUdpAddr *from) {
+    if (!udp->outbound && !udp->inbound) return RawRecv(udp, buffer, cap, from);
+
+    double now = NowMs();
+    if (udp->outbound) Pump(udp, now);
+    if (!udp->inbound) return RawRecv(udp, buffer, cap, from);
+
+    // Everything the socket holds goes on the inbound link first
+    unsigned char data[PONG_LINK_MTU];
+    PongUdpAddr sender;
+    int n;
+    while ((n = RawRecv(udp, data, sizeof(data), &sender)) > 0) pong_link_send(udp->inbound, now, data, (size_t)n, AddrTag(&sender));
+
+    PongLinkPacket packet;
+    if (!pong_link_due(udp->inbound, now, &packet)) return n;
+    if (from) *from = TagAddr(packet.tag);
+    size_t size = (packet.size < cap) ? packet.size : cap;
+    memcpy(buffer, packet.data, size);
+    return (int)size;
+}
+
+bool pong_udp_send(PongUdp *udp, const void *data, size_t size) {
+    return Send(udp, NULL, data, size);
+}
+
+int pong_udp_recv(PongUdp *udp, void *buffer, size_t cap) {
+    return Recv(udp, buffer, cap, NULL);
+}
+
+int pong_udp_recv_from(PongUdp *udp, void *buffer, size_t cap, PongUdpAddr *from) {
+    return Recv(udp, buffer, cap, from);
+}
+
+bool pong_udp_send_to(PongUdp *udp, const PongUdpAddr *to, const void *data, size_t size) {
+    return Send(udp, to, data, size);
+}
+
+void pong_udp_shape(PongUdp *udp, PongLink *outbound, PongLink *inbound) {
+    udp->outbound = outbound;
+    udp->inbound = inbound;
+}
@@ -0,0 +1,61 @@
+#ifndef PONG_UDP_H
+#define PONG_UDP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../sim/pong_link.h"
+
+/*
+*  UDP sockets
+*  ----------------------------------------------------------------------------------
+*  The smallest wrapper the netplay code needs: a non-blocking IPv4 datagram
+*  socket with an optional default peer. Sends never block (a full socket buffer
+*  drops the packet, like the network would), receives return 0 when nothing is
+*  waiting. POSIX sockets only, so it builds on Linux and macOS alike.
+*
+*  For testing on a real socket without a real network, pong_udp_shape() routes
+*  sends and receives through emulated links (src/sim/pong_link.h) on the
+*  monotonic clock: packets are held in process until the link lets them go.
+*/
+
+typedef struct {
+    int fd;
+    bool connected;
+    PongLink *outbound;             // Emulated links, NULL = none (owned by the caller)
+    PongLink *inbound;
+} PongUdp;
+
+// IPv4 address and port, host byte order
+typedef struct {
+    uint32_t ip;
+    uint16_t port;
+} PongUdpAddr;
+
+// Bind to port on all interfaces (0 = any free port).
+bool pong_udp_open(PongUdp *udp, uint16_t port);
+void pong_udp_close(PongUdp *udp);
+
+// Port the socket is bound to.
+uint16_t pong_udp_port(const PongUdp *udp);
+
+// Send to / receive from host:port only from now on.
+bool pong_udp_connect(PongUdp *udp, const char *host, uint16_t port);
+
+// Send one datagram to the connected peer. False if it was dropped.
+bool pong_udp_send(PongUdp *udp, const void *data, size_t size);
+
+// Next waiting datagram: its size, 0 if none, -1 on error.
+int pong_udp_recv(PongUdp *udp, void *buffer, size_t cap);
+
+// Unconnected use (hosts, servers): who sent it / where to send.
+int pong_udp_recv_from(PongUdp *udp, void *buffer, size_t cap, PongUdpAddr *from);
+bool pong_udp_send_to(PongUdp *udp, const PongUdpAddr *to, const void *data, size_t size);
+bool pong_udp_connect_addr(PongUdp *udp, const PongUdpAddr *peer);
+
+// Shape this socket's traffic; either link may be NULL. Held packets move
+// whenever the socket sends or receives.
+void pong_udp_shape(PongUdp *udp, PongLink *outbound, PongLink *inbound);
+
+#endif // PONG_UDP_H
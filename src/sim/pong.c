@@ -0,0 +1,354 @@
+#include "pong.h"
+#include "pong_bytes.h"
+#include "pong_fastmath.h"
+#include "pong_fixed.h"
+#include "pong_rng.h"
+
+#define RAYMATH_STATIC_INLINE   // Header-only math so the headless build needs no raylib library
+#include <raymath.h>
+
+static const float screenWidth = ARENA_WIDTH;
+static const float screenHeight = ARENA_HEIGHT;
+
+const PongRules pong_default_rules = {
+    .paddleSpeed = PADDLE_SPEED,
+    .ballSpeedIncrement = BALL_SPEED_INCREMENT,
+    .ballMaxSpeed = BALL_MAX_SPEED,
+    .ballServeSpeed = BALL_SERVE_SPEED,
+    .maxDeflectionAngle = MAX_DEFLECTION_ANGLE,
+};
+
+void pong_init(PongState *state, uint64_t seed) {
+    *state = (PongState){
+        .player1 = { {PADDLE1_X, (screenHeight - PADDLE_HEIGHT) * 0.5f}, {PADDLE_WIDTH, PADDLE_HEIGHT} },
+        .player2 = { {PADDLE2_X, (screenHeight - PADDLE_HEIGHT) * 0.5f}, {PADDLE_WIDTH, PADDLE_HEIGHT} },
+        .ball = { {(screenWidth / 2) - 9, (screenHeight / 2) - 9}, BALL_RADIUS, {2, 2} },
+        .gameState = GAME_START,
+        .score1 = 0,
+        .score2 = 0,
+        .serveDirection = 1,
+        .serveJustHappened = true,
+        .rngKey = pong_rng_key(seed),
+        .rngCounter = 0,
+    };
+}
+
+int pong_random_value(PongState *state, int min, int max) {
+    return pong_rng_range(state->rngKey, state->rngCounter++, min, max);
+}
+
+void pong_state_pack(const PongState *state, unsigned char *out) {
+    pong_put_float(out + 0, state->ball.position.x);
+    pong_put_float(out + 4, state->ball.position.y);
+    pong_put_float(out + 8, state->ball.velocity.x);
+    pong_put_float(out + 12, state->ball.velocity.y);
+    pong_put_float(out + 16, state->player1.position.y);
+    pong_put_float(out + 20, state->player2.position.y);
+    pong_put_u32(out + 24, state->rngCounter);
+    pong_put_u16(out + 28, (uint32_t)state->score1);
+    pong_put_u16(out + 30, (uint32_t)state->score2);
+    out[32] = (unsigned char)state->gameState;
+    out[33] = (unsigned char)(signed char)state->serveDirection;
+    out[34] = state->serveJustHappened ? 1 : 0;
+    out[35] = 0;
+}
+
+bool pong_state_unpack(PongState *state, const unsigned char *in) {
+    if (in[32] > GAME_OVER || in[34] > 1) return false;
+
+    state->ball.position = (Vector2){ pong_get_float(in + 0), pong_get_float(in + 4) };
+    state->ball.velocity = (Vector2){ pong_get_float(in + 8), pong_get_float(in + 12) };
+    state->player1.position.y = pong_get_float(in + 16);
+    state->player2.position.y = pong_get_float(in + 20);
+    state->rngCounter = pong_get_u32(in + 24);
+    state->score1 = (int)pong_get_u16(in + 28);
+    state->score2 = (int)pong_get_u16(in + 30);
+    state->gameState = (GameState)in[32];
+    state->serveDirection = (signed char)in[33];
+    state->serveJustHappened = in[34] != 0;
+    return true;
+}
+
+// A paddle key's travel this tick: all of it unless it was only down for part
+static float KeyTravel(PongInput input, PongInput key, float travel) {
+    unsigned int missed = pong_input_missed(input, key);
+    return missed ? travel * (float)(PONG_INPUT_PART_STEPS - missed) * (1.0f / PONG_INPUT_PART_STEPS) : travel;
+}
+
+static void MovePaddles(PongState *state, PongInput input, float dt, const PongRules *rules) {
+    Paddle *player1 = &state->player1;
+    Paddle *player2 = &state->player2;
+    float travel = rules->paddleSpeed * dt;
+
+    if (input & PONG_INPUT_P1_UP)   player1->position.y -= KeyTravel(input, PONG_INPUT_P1_UP, travel);
+    if (input & PONG_INPUT_P1_DOWN) player1->position.y += KeyTravel(input, PONG_INPUT_P1_DOWN, travel);
+    if (input & PONG_INPUT_P2_UP)   player2->position.y -= KeyTravel(input, PONG_INPUT_P2_UP, travel);
+    if (input & PONG_INPUT_P2_DOWN) player2->position.y += KeyTravel(input, PONG_INPUT_P2_DOWN, travel);
+
+    player1->position.y = Clamp(player1->position.y, 0, screenHeight - player1->size.y);
+    player2->position.y = Clamp(player2->position.y, 0, screenHeight - player2->size.y);
+}
+
+// Unit vector at angle (radians, within +-PI/2) from the x axis; side picks +x or -x
+static Vector2 Direction(float angle, float side) {
+#ifdef PONG_LIBM_TRIG
+    return Vector2Normalize((Vector2){ side * cosf(angle), sinf(angle) });
+#else
+    return (Vector2){ side * pong_fast_cos(angle), pong_fast_sin(angle) };
+#endif
+}
+
+// Bounce off a paddle: angle from where the ball hit, speed up to the cap.
+// side is +1 when the ball should leave to the right (player 1), -1 for player 2.
+static void DeflectOffPaddle(Ball *ball, const Paddle *paddle, float side, const PongRules *rules) {
+    // Calculate hit position relative to paddle center
+    float paddleCenterY = paddle->position.y + (paddle->size.y / 2);
+    float t = (ball->position.y - paddleCenterY) / (paddle->size.y / 2);
+    t = Clamp(t, -1.0f, 1.0f); // Ensure t is within [-1, 1]
+
+    // Calculate deflection angle
+    float deflectionAngle = t * rules->maxDeflectionAngle;
+
+    // Calculate speed
+    float currentSpeed = Vector2Length(ball->velocity);
+    float newSpeed = fminf(currentSpeed * rules->ballSpeedIncrement, rules->ballMaxSpeed);
+
+    // Update ball velocity based on deflection angle
+    ball->velocity = Vector2Scale(Direction(deflectionAngle, side), newSpeed);
+}
+
+// Time at which a circle at p moving with v first touches rect, within [0, maxT].
+// The rectangle grown by r is slab-tested first; an entry point beyond both faces
+// is a corner approach, which is re-solved against the circle around that corner.
+static float SweepCircleRect(Vector2 p, Vector2 v, float r, Rectangle rect, float maxT) {
+    float minX = rect.x - r, maxX = rect.x + rect.width + r;
+    float minY = rect.y - r, maxY = rect.y + rect.height + r;
+    float tEnter = -INFINITY, tExit = INFINITY;
+
+    if (v.x != 0.0f) {
+        float t1 = (minX - p.x) / v.x, t2 = (maxX - p.x) / v.x;
+        tEnter = fmaxf(tEnter, fminf(t1, t2));
+        tExit = fminf(tExit, fmaxf(t1, t2));
+    } else if (p.x < minX || p.x > maxX) return -1.0f;
+
+    if (v.y != 0.0f) {
+        float t1 = (minY - p.y) / v.y, t2 = (maxY - p.y) / v.y;
+        tEnter = fmaxf(tEnter, fminf(t1, t2));
+        tExit = fminf(tExit, fmaxf(t1, t2));
+    } else if (p.y < minY || p.y > maxY) return -1.0f;
+
+    if (tEnter > tExit || tExit < 0.0f || tEnter > maxT) return -1.0f;
+    if (tEnter < 0.0f) tEnter = 0.0f;   // Already inside the grown rectangle
+
+    Vector2 c = { p.x + v.x * tEnter, p.y + v.y * tEnter };
+    bool withinX = (c.x >= rect.x && c.x <= rect.x + rect.width);
+    bool withinY = (c.y >= rect.y && c.y <= rect.y + rect.height);
+    if (withinX || withinY) return tEnter;
+
+    // Corner region: solve |p + v*t - corner| = r for the first root
+    Vector2 corner = { (c.x < rect.x) ? rect.x : rect.x + rect.width,
+                       (c.y < rect.y) ? rect.y : rect.y + rect.height };
+    Vector2 d = { p.x - corner.x, p.y - corner.y };
+    float a = v.x * v.x + v.y * v.y;
+    float b = d.x * v.x + d.y * v.y;
+    float k = d.x * d.x + d.y * d.y - r * r;
+    float disc = b * b - a * k;
+    if (k <= 0.0f) return tEnter;                               // Already touching the corner
+    if (a == 0.0f || b >= 0.0f || disc < 0.0f) return -1.0f;    // Moving away or passing by
+
+    float t = (-b - sqrtf(disc)) / a;
+    if (t < tEnter) t = tEnter;     // Rounding can put the root a hair before the slab entry
+    return (t <= maxT) ? t : -1.0f;
+}
+
+// True when the ball's circle overlaps the paddle right now
+static bool BallTouchesPaddle(const Ball *ball, const Paddle *paddle) {
+    float nearestX = Clamp(ball->position.x, paddle->position.x, paddle->position.x + paddle->size.x);
+    float nearestY = Clamp(ball->position.y, paddle->position.y, paddle->position.y + paddle->size.y);
+    float dx = ball->position.x - nearestX, dy = ball->position.y - nearestY;
+    return dx * dx + dy * dy < ball->radius * ball->radius;
+}
+
+static void HitPlayer1(Ball *ball, const Paddle *player1, const PongRules *rules) {
+    DeflectOffPaddle(ball, player1, 1.0f, rules);
+
+    // Nudge ball out of paddle
+    ball->position.x = player1->position.x + player1->size.x + ball->radius;
+}
+
+static void HitPlayer2(Ball *ball, const Paddle *player2, const PongRules *rules) {
+    DeflectOffPaddle(ball, player2, -1.0f, rules);
+
+    // Nudge ball out of paddle
+    ball->position.x = player2->position.x - ball->radius;
+}
+
+typedef enum {
+    SWEEP_NONE,
+    SWEEP_TOP,
+    SWEEP_BOTTOM,
+    SWEEP_PLAYER1,
+    SWEEP_PLAYER2
+} SweepEvent;
+
+// Move the ball through dt seconds, resolving every wall bounce and paddle hit in
+// the order they happen. With no contact this is exactly position += velocity * dt,
+// so a fast ball can no longer step over a paddle between two ticks.
+static void SweepBall(PongState *state, float dt, const PongRules *rules) {
+    const Paddle *player1 = &state->player1;
+    const Paddle *player2 = &state->player2;
+    Ball *ball = &state->ball;
+
+    // A paddle moved onto the ball: bounce it the way the old overlap test did
+    if (ball->velocity.x < 0 && BallTouchesPaddle(ball, player1)) HitPlayer1(ball, player1, rules);
+    if (ball->velocity.x > 0 && BallTouchesPaddle(ball, player2)) HitPlayer2(ball, player2, rules);
+
+    float remaining = dt;
+
+    for (int events = 0; events < PONG_MAX_SWEEP_EVENTS; events++) {
+        float r = ball->radius;
+        float hitTime = remaining;
+        SweepEvent event = SWEEP_NONE;
+
+        if (ball->velocity.y < 0) {
+            float t = fmaxf((r - ball->position.y) / ball->velocity.y, 0.0f);
+            if (t <= hitTime) { hitTime = t; event = SWEEP_TOP; }
+        }
+        if (ball->velocity.y > 0) {
+            float t = fmaxf((screenHeight - r - ball->position.y) / ball->velocity.y, 0.0f);
+            if (t <= hitTime) { hitTime = t; event = SWEEP_BOTTOM; }
+        }
+        if (ball->velocity.x < 0) {
+            Rectangle rect = { player1->position.x, player1->position.y, player1->size.x, player1->size.y };
+            float t = SweepCircleRect(ball->position, ball->velocity, r, rect, hitTime);
+            if (t >= 0.0f) { hitTime = t; event = SWEEP_PLAYER1; }
+        }
+        if (ball->velocity.x > 0) {
+            Rectangle rect = { player2->position.x, player2->position.y, player2->size.x, player2->size.y };
+            float t = SweepCircleRect(ball->position, ball->velocity, r, rect, hitTime);
+            if (t >= 0.0f) { hitTime = t; event = SWEEP_PLAYER2; }
+        }
+
+        ball->position.x += ball->velocity.x * hitTime;
+        ball->position.y += ball->velocity.y * hitTime;
+        remaining -= hitTime;
+
+        switch (event) {
+            case SWEEP_NONE:
+                return;
+            case SWEEP_TOP:
+                ball->position.y = r;
+                ball->velocity.y *= -1;
+                break;
+            case SWEEP_BOTTOM:
+                ball->position.y = screenHeight - r;
+                ball->velocity.y *= -1;
+                break;
+            case SWEEP_PLAYER1:
+                HitPlayer1(ball, player1, rules);
+                break;
+            case SWEEP_PLAYER2:
+                HitPlayer2(ball, player2, rules);
+                break;
+        }
+    }
+
+    // Event budget spent (ball pinned between paddle and wall): finish the step in a straight line
+    ball->position.x += ball->velocity.x * remaining;
+    ball->position.y = Clamp(ball->position.y + ball->velocity.y * remaining, ball->radius, screenHeight - ball->radius);
+}
+
+static void UpdatePlaying(PongState *state, PongInput input, float dt, const PongRules *rules) {
+    Ball *ball = &state->ball;
+
+    if (input & PONG_INPUT_PAUSE) {
+        state->gameState = GAME_PAUSE;
+        return;
+    }
+
+    MovePaddles(state, input, dt, rules);
+    SweepBall(state, dt, rules);
+
+    if (ball->position.x + ball->radius < 0) {
+        state->score2++;
+        if (state->score2 >= WINNING_SCORE) {
+            state->gameState = GAME_OVER;
+            return;
+        }
+        state->serveDirection = 1;
+        state->serveJustHappened = true;
+        state->gameState = GAME_SERVE;
+    }
+
+    if (ball->position.x - ball->radius > screenWidth) {
+        state->score1++;
+        if (state->score1 >= WINNING_SCORE) {
+            state->gameState = GAME_OVER;
+            return;
+        }
+        state->serveDirection = -1;
+        state->serveJustHappened = true;
+        state->gameState = GAME_SERVE;
+    }
+}
+
+void pong_rules_step(PongState *state, PongInput input, float dt, const PongRules *rules) {
+    Ball *ball = &state->ball;
+
+    switch (state->gameState) {
+        case GAME_START:
+            if (input & PONG_INPUT_SERVE) {
+                state->serveJustHappened = true;
+                state->gameState = GAME_SERVE;
+            }
+            break;
+        case GAME_SERVE:
+            // Reset ball position if a serve just happened
+            if (state->serveJustHappened) {
+                ball->position = (Vector2){ screenWidth/2.0f, screenHeight/2.0f };
+                ball->velocity = (Vector2){ 0, 0 };
+                // Does not recenter
+                state->serveJustHappened = false;
+            }
+
+            // Allow paddle movement during serve
+            MovePaddles(state, input, dt, rules);
+
+            // Serve the ball
+            if (input & PONG_INPUT_SERVE) {
+                // Small random angle so serves aren’t identical
+                float ang = DEG2RAD * (float)pong_random_value(state, -20, 20);
+                ball->velocity = Vector2Scale(Direction(ang, (float)state->serveDirection), rules->ballServeSpeed);
+                state->gameState = GAME_PLAYING;
+            }
+            break;
+        case GAME_PLAYING:
+            UpdatePlaying(state, input, dt, rules);
+            break;
+        case GAME_PAUSE:
+            if (input & PONG_INPUT_PAUSE) {
+                state->gameState = GAME_PLAYING; // Resume game
+            }
+            break;
+        case GAME_OVER:
+            if (input & PONG_INPUT_SERVE) {
+                state->score1 = 0;
+                state->score2 = 0;
+                state->serveDirection = (pong_random_value(state, 0, 1) == 0) ? -1 : 1;
+                state->gameState = GAME_START;
+            }
+            break;
+    }
+}
+
+void pong_float_step(PongState *state, PongInput input, float dt) {
+    pong_rules_step(state, input, dt, &pong_default_rules);
+}
+
+void pong_step(PongState *state, PongInput input, float dt) {
+#ifdef PONG_FIXED_POINT
+    pong_fixed_step(state, input, dt);
+#else
+    pong_float_step(state, input, dt);
+#endif
+}
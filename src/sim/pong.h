@@ -0,0 +1,146 @@
+#ifndef PONG_H
+#define PONG_H
+
+#include <raylib.h>     // Vector2 only - the simulation never calls into raylib
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+*  Pong simulation core
+*  ----------------------------------------------------------------------------------
+*  Everything the game needs to advance a match, with no window, no clock and no
+*  keyboard. The caller owns a PongState, builds a PongInput bitmask for the step
+*  and passes the elapsed time in seconds:
+*
+*  PongState state;
+*  pong_init(&state, seed);
+*  pong_step(&state, PONG_INPUT_SERVE, 1.0f / 120.0f);
+*/
+
+// Arena and gameplay constants (shared by the game and the headless tools)
+#define ARENA_WIDTH           1280
+#define ARENA_HEIGHT          720
+#define PADDLE_WIDTH          16.0f
+#define PADDLE_HEIGHT         120.0f
+#define BALL_RADIUS           8.0f
+#define PADDLE_SPEED          600.0f
+#define WINNING_SCORE         3
+#define BALL_SPEED_INCREMENT  1.03f
+#define BALL_MAX_SPEED        1500.0f
+#define BALL_SERVE_SPEED      480.0f
+#define MAX_DEFLECTION_ANGLE  (5 * (PI / 12))   // 75 degrees in radians
+#define SIDE_PADDING          32.0f             // Inset from left/right edges
+#define PADDLE1_X             SIDE_PADDING
+#define PADDLE2_X             (ARENA_WIDTH - SIDE_PADDING - PADDLE_WIDTH)
+#define PONG_MAX_SWEEP_EVENTS 8                 // Bounces/hits resolved inside one step
+
+typedef enum {
+    GAME_START,
+    GAME_SERVE,
+    GAME_PLAYING,
+    GAME_PAUSE,
+    GAME_OVER
+} GameState;
+
+// One bit per key the game reads. Paddle bits are "held", SERVE/PAUSE are "pressed this step".
+typedef enum {
+    PONG_INPUT_P1_UP   = 1 << 0,    // W
+    PONG_INPUT_P1_DOWN = 1 << 1,    // S
+    PONG_INPUT_P2_UP   = 1 << 2,    // UP
+    PONG_INPUT_P2_DOWN = 1 << 3,    // DOWN
+    PONG_INPUT_SERVE   = 1 << 4,    // SPACE
+    PONG_INPUT_PAUSE   = 1 << 5     // P
+} PongInputBits;
+
+typedef unsigned int PongInput;
+
+// Sub-tick holds: a paddle key down for only part of a tick says which part, as
+// the sixteenths of the tick it was NOT down, in a 4-bit field per key from
+// PONG_INPUT_PART_SHIFT (P1_UP, P1_DOWN, P2_UP, P2_DOWN, like the key bits). The
+// paddle then moves that share of a tick's travel. 0 - the whole tick - is what
+// every whole-tick source sends; the batch rules and the network only carry 0.
+#define PONG_INPUT_PART_SHIFT 8
+#define PONG_INPUT_PART_STEPS 16
+#define PONG_INPUT_P1_PARTS   (0xFFu << PONG_INPUT_PART_SHIFT)
+#define PONG_INPUT_P2_PARTS   (0xFFu << (PONG_INPUT_PART_SHIFT + 8))
+
+// The part field of the paddle key `key` (one of the four paddle bits).
+static inline unsigned int pong_input_missed(PongInput input, PongInput key) {
+    int index = (key == PONG_INPUT_P1_UP) ? 0 : (key == PONG_INPUT_P1_DOWN) ? 1 : (key == PONG_INPUT_P2_UP) ? 2 : 3;
+    return (input >> (PONG_INPUT_PART_SHIFT + 4 * index)) & 15u;
+}
+
+static inline PongInput pong_input_with_missed(PongInput input, PongInput key, unsigned int missed) {
+    int index = (key == PONG_INPUT_P1_UP) ? 0 : (key == PONG_INPUT_P1_DOWN) ? 1 : (key == PONG_INPUT_P2_UP) ? 2 : 3;
+    int shift = PONG_INPUT_PART_SHIFT + 4 * index;
+    return (input & ~(15u << shift)) | (missed & 15u) << shift;
+}
+
+typedef struct {
+    Vector2 position;
+    Vector2 size;
+} Paddle;
+
+typedef struct {
+    Vector2 position;
+    float radius;
+    Vector2 velocity;
+} Ball;
+
+typedef struct {
+    Paddle player1;
+    Paddle player2;
+    Ball ball;
+
+    GameState gameState;
+    int score1;
+    int score2;
+    int serveDirection;
+    bool serveJustHappened;
+
+    uint64_t rngKey;            // Per-match random stream (pong_rng.h): serve angles, replay direction
+    uint32_t rngCounter;        // Draws taken so far; set it to jump anywhere in the stream
+} PongState;
+
+// The gameplay constants above that the float rules can also take at run time,
+// for tuning sweeps. pong_step() and everything networked always play
+// pong_default_rules; the fixed-point and batch rules know only those.
+typedef struct {
+    float paddleSpeed;          // px/s
+    float ballSpeedIncrement;   // Speed factor per paddle hit
+    float ballMaxSpeed;         // px/s
+    float ballServeSpeed;       // px/s
+    float maxDeflectionAngle;   // Radians, below PI/2
+} PongRules;
+
+extern const PongRules pong_default_rules;
+
+// Reset a match to the start screen. Matches with the same seed and inputs play
+// out identically; any seed (0 included) is fine.
+void pong_init(PongState *state, uint64_t seed);
+
+// Advance the match by dt seconds with the given input bits held/pressed.
+// Builds with -DPONG_FIXED_POINT run the integer rules (pong_fixed.h) instead of floats.
+void pong_step(PongState *state, PongInput input, float dt);
+
+// The float rules, whatever the build mode (comparisons, benchmarks).
+void pong_float_step(PongState *state, PongInput input, float dt);
+
+// The float rules with other constants.
+void pong_rules_step(PongState *state, PongInput input, float dt, const PongRules *rules);
+
+// Uniform integer in [min, max]: the next draw of the match's own stream.
+int pong_random_value(PongState *state, int min, int max);
+
+// Portable image of everything that changes during a match (ball, paddle y,
+// scores, gameState, serve fields, RNG counter), little-endian, for recordings
+// and network messages.
+#define PONG_STATE_BYTES 36
+void pong_state_pack(const PongState *state, unsigned char *out);
+
+// Overwrites the changing fields of state; the rest (paddle x and sizes, ball
+// radius, RNG key) should already come from pong_init(). False if the image
+// holds an impossible gameState.
+bool pong_state_unpack(PongState *state, const unsigned char *in);
+
+#endif // PONG_H
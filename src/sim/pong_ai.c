@@ -0,0 +1,103 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pong_ai.h"
+#include "pong_clock.h"
+#include "pong_rng.h"
+
+const PongCpuLevel pong_cpu_levels[] = {
+    { "easy",   { 0.35f, 100.0f } },
+    { "normal", { 0.25f, 80.0f } },
+    { "hard",   { 0.15f, 55.0f } },
+};
+const int pong_cpu_level_count = (int)(sizeof(pong_cpu_levels) / sizeof(pong_cpu_levels[0]));
+
+bool pong_predict_intercept(const Ball *ball, int player, PongIntercept *out) {
+    double r = ball->radius;
+    double vx = ball->velocity.x;
+    double faceX = (player == 0) ? PADDLE1_X + PADDLE_WIDTH + r : PADDLE2_X - r;
+    if ((player == 0) ? vx >= 0.0 : vx <= 0.0) return false;
+
+    double t = (faceX - ball->position.x) / vx;
+    if (t < 0.0) return false;      // Already past the face
+
+    // The centre lives in [r, height - r]; unfolded, each wall bounce is one more span
+    double span = ARENA_HEIGHT - 2.0 * r;
+    double y = ball->position.y - r + ball->velocity.y * t;
+    double folds = floor(y / span);
+    double m = y - 2.0 * span * floor(y / (2.0 * span));     // In [0, 2 span)
+
+    out->y = (float)(r + ((m <= span) ? m : 2.0 * span - m));
+    out->time = (float)t;
+    out->bounces = (int)fabs(folds);
+    return true;
+}
+
+bool pong_cpu_parse(const char *text, PongCpuConfig *config) {
+    for (int i = 0; i < pong_cpu_level_count; i++) {
+        if (strcmp(pong_cpu_levels[i].name, text) == 0) {
+            *config = pong_cpu_levels[i].config;
+            return true;
+        }
+    }
+
+    char *end;
+    float reactionMs = strtof(text, &end);
+    if (end == text || *end != ',' || reactionMs < 0.0f) return false;
+    const char *errorText = end + 1;
+    float error = strtof(errorText, &end);
+    if (end == errorText || *end != '\0' || error < 0.0f) return false;
+
+    *config = (PongCpuConfig){ reactionMs * 0.001f, error };
+    return true;
+}
+
+void pong_cpu_init(PongCpu *cpu, int player, PongCpuConfig config, uint64_t seed) {
+    memset(cpu, 0, sizeof(*cpu));
+    cpu->config = config;
+    cpu->player = player ? 1 : 0;
+    cpu->key = pong_rng_key(seed);
+    cpu->reactIn = -1;
+    cpu->target = ARENA_HEIGHT * 0.5f;
+}
+
+// Uniform in [-1, 1]
+static float Spread(PongCpu *cpu) {
+    return (float)pong_rng_draw(cpu->key, cpu->draws++) * (2.0f / 4294967295.0f) - 1.0f;
+}
+
+// The course it has just noticed: meet the ball if it is coming, else wait in the middle
+static void Plan(PongCpu *cpu, const Ball *ball) {
+    PongIntercept hit;
+    if (pong_predict_intercept(ball, cpu->player, &hit)) cpu->target = hit.y + Spread(cpu) * cpu->config.error;
+    else cpu->target = ARENA_HEIGHT * 0.5f;
+}
+
+PongInput pong_cpu_input(PongCpu *cpu, const PongState *state) {
+    const Ball *ball = &state->ball;
+
+    if (state->gameState == GAME_PLAYING) {
+        // A serve or a paddle hit (not a wall bounce: the prediction already unfolds those)
+        bool newCourse = (ball->velocity.x > 0.0f) != (cpu->seenVelocity.x > 0.0f) || cpu->seenVelocity.x == 0.0f;
+        if (newCourse) {
+            cpu->seenVelocity = ball->velocity;
+            cpu->reactIn = (int)(cpu->config.reaction * PONG_TICK_RATE + 0.5f);
+        }
+        if (cpu->reactIn >= 0 && cpu->reactIn-- == 0) Plan(cpu, ball);
+    } else {
+        cpu->seenVelocity = (Vector2){ 0.0f, 0.0f };
+        cpu->reactIn = -1;
+        cpu->target = ARENA_HEIGHT * 0.5f;
+    }
+    return pong_cpu_keys(cpu, state);
+}
+
+PongInput pong_cpu_keys(const PongCpu *cpu, const PongState *state) {
+    const Paddle *paddle = (cpu->player == 0) ? &state->player1 : &state->player2;
+    float center = paddle->position.y + paddle->size.y * 0.5f;
+    PongInput input = 0;
+    if (cpu->target < center - PONG_CPU_DEAD_ZONE) input |= (cpu->player == 0) ? PONG_INPUT_P1_UP : PONG_INPUT_P2_UP;
+    if (cpu->target > center + PONG_CPU_DEAD_ZONE) input |= (cpu->player == 0) ? PONG_INPUT_P1_DOWN : PONG_INPUT_P2_DOWN;
+    return input;
+}
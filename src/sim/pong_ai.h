@@ -0,0 +1,79 @@
+#ifndef PONG_AI_H
+#define PONG_AI_H
+
+#include "pong.h"
+
+/*
+*  Trajectory prediction and CPU opponent
+*  ----------------------------------------------------------------------------------
+*  Between paddles the ball only moves in a straight line and mirrors off the top
+*  and bottom walls, so where it meets a paddle has a closed form: unfold the
+*  walls (reflect the arena about each wall, repeatedly, so the path is one
+*  straight line), go straight to the paddle's x, and fold the y back. No stepping,
+*  a few flops whatever the distance or number of bounces.
+*
+*  PongIntercept hit;
+*  if (pong_predict_intercept(&state.ball, 1, &hit)) ... hit.y, hit.time;
+*
+*  A PongCpu plays one paddle from it like a person would: it notices the ball
+*  changing course only after a reaction delay, then misjudges the intercept by
+*  up to a set error, and walks its paddle there with the normal key bits.
+*  Its randomness is its own seeded stream, so a recording or a rollback replay of
+*  a CPU match sees the same keys.
+*
+*  PongCpu cpu;
+*  pong_cpu_init(&cpu, 1, pong_cpu_levels[1].config, seed);
+*  every tick: input |= pong_cpu_input(&cpu, &state);
+*/
+
+#define PONG_CPU_DEAD_ZONE 2.0f     // px; closer to its target than this a CPU paddle stays put
+
+typedef struct {
+    float y;                        // Ball centre when it reaches the paddle face
+    float time;                     // Seconds from now
+    int bounces;                    // Wall bounces on the way
+} PongIntercept;
+
+typedef struct {
+    float reaction;                 // Seconds before a change of course is noticed
+    float error;                    // Aim off by up to this many px (uniform), either way
+} PongCpuConfig;
+
+typedef struct {
+    const char *name;
+    PongCpuConfig config;
+} PongCpuLevel;
+
+typedef struct {
+    PongCpuConfig config;
+    int player;                     // 0 = player 1, 1 = player 2
+    uint64_t key;                   // Aim error stream (pong_rng)
+    uint32_t draws;
+
+    Vector2 seenVelocity;           // Ball velocity of the last course it reacted to
+    int reactIn;                    // Ticks until it notices the new course, -1 if nothing pending
+    float target;                   // Where its paddle centre is heading
+} PongCpu;
+
+// Built-in opponents: easy, normal, hard.
+extern const PongCpuLevel pong_cpu_levels[];
+extern const int pong_cpu_level_count;
+
+// Where and when the ball reaches player's paddle face (the x where it would be
+// deflected), assuming nothing moves it first. False when it is moving away or
+// not at all. Paddle corners are ignored: the face is treated as unbounded.
+bool pong_predict_intercept(const Ball *ball, int player, PongIntercept *out);
+
+// A level name ("normal") or "reaction_ms,error_px" ("150,20"). False if neither.
+bool pong_cpu_parse(const char *text, PongCpuConfig *config);
+
+void pong_cpu_init(PongCpu *cpu, int player, PongCpuConfig config, uint64_t seed);
+
+// This tick's paddle keys for the CPU's player (never SERVE or PAUSE).
+PongInput pong_cpu_input(PongCpu *cpu, const PongState *state);
+
+// The keys for the current target without looking at the ball: what
+// pong_cpu_input() presses on a tick where nothing new is noticed.
+PongInput pong_cpu_keys(const PongCpu *cpu, const PongState *state);
+
+#endif // PONG_AI_H
@@ -0,0 +1,252 @@
+#include <math.h>
+#include <string.h>
+
+#include "pong_authority.h"
+#include "pong_bytes.h"
+#include "pong_clock.h"
+#include "pong_rollback.h"
+
+#define JOIN_SIZE    5
+#define WELCOME_SIZE 10
+#define INPUT_HEADER_SIZE 11
+#define SNAPSHOT_HEADER_SIZE 11
+
+static PongInput PlayerKeys(int player) {
+    return (player == 0) ? PONG_INPUT_P1_KEYS : PONG_INPUT_P2_KEYS;
+}
+
+static PongInput HeldKeys(int player) {
+    return (player == 0) ? (PONG_INPUT_P1_UP | PONG_INPUT_P1_DOWN) : (PONG_INPUT_P2_UP | PONG_INPUT_P2_DOWN);
+}
+
+static float OwnPaddleY(const PongState *state, int player) {
+    return (player == 0) ? state->player1.position.y : state->player2.position.y;
+}
+
+// The match rules on both ends: a normal step, then onto the snapshot grid
+static void Step(PongState *state, PongInput input) {
+    pong_step(state, input, PONG_TICK_DT);
+    pong_snapshot_quantize(state);
+}
+
+static void InitState(PongState *state, uint64_t seed) {
+    pong_init(state, seed);
+    pong_snapshot_quantize(state);
+}
+
+void pong_authority_init(PongAuthority *auth, uint64_t seed) {
+    memset(auth, 0, sizeof(*auth));
+    InitState(&auth->state, seed);
+    auth->seed = seed;
+    auth->history[0] = auth->state;
+}
+
+bool pong_authority_read_input(PongAuthority *auth, int player, const unsigned char *data, size_t size) {
+    if (size < INPUT_HEADER_SIZE || data[0] != PONG_PACKET_CLIENT_INPUT) return false;
+
+    uint32_t first = pong_get_u32(data + 1);
+    uint32_t count = pong_get_u16(data + 5);
+    uint32_t seen = pong_get_u32(data + 7);
+    if (size != INPUT_HEADER_SIZE + count) return false;
+
+    PongInputQueue *queue = &auth->queues[player ? 1 : 0];
+    if (seen > queue->seen && seen <= auth->tick + 1) queue->seen = seen;
+
+    // Contiguous only, like the rollback session: the client resends until acknowledged
+    PongInput keys = PlayerKeys(player ? 1 : 0);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t seq = first + i;
+        if (seq < queue->received) continue;
+        if (seq > queue->received || queue->received - queue->next >= PONG_AUTHORITY_RING) break;
+
+        queue->inputs[seq % PONG_AUTHORITY_RING] = data[INPUT_HEADER_SIZE + i] & keys;
+        queue->received++;
+    }
+
+    return true;
+}
+
+void pong_authority_queue_input(PongAuthority *auth, int player, PongInput input) {
+    PongInputQueue *queue = &auth->queues[player ? 1 : 0];
+    if (queue->received - queue->next >= PONG_AUTHORITY_RING) return;
+
+    queue->inputs[queue->received % PONG_AUTHORITY_RING] = input & PlayerKeys(player ? 1 : 0);
+    queue->received++;
+}
+
+// Next input for player, or their held paddle keys again if nothing new has arrived
+static PongInput TakeInput(PongInputQueue *queue, int player) {
+    // A burst after a stall would otherwise play out late for the rest of the match
+    if (queue->received - queue->next > PONG_AUTHORITY_BACKLOG) {
+        uint32_t skip = queue->received - queue->next - PONG_AUTHORITY_BACKLOG;
+        queue->last = queue->inputs[(queue->next + skip - 1) % PONG_AUTHORITY_RING];
+        queue->next += skip;
+        queue->skipped += skip;
+    }
+
+    if (queue->next < queue->received) {
+        queue->last = queue->inputs[queue->next % PONG_AUTHORITY_RING];
+        queue->next++;
+        return queue->last;
+    }
+
+    if (queue->received > 0) queue->starved++;
+    return queue->last & HeldKeys(player);
+}
+
+void pong_authority_step(PongAuthority *auth) {
+    PongInput input = TakeInput(&auth->queues[0], 0) | TakeInput(&auth->queues[1], 1);
+    Step(&auth->state, input);
+    auth->tick++;
+    auth->history[auth->tick % PONG_AUTHORITY_HISTORY] = auth->state;
+}
+
+size_t pong_authority_write_snapshot(const PongAuthority *auth, int player, unsigned char *out, size_t cap) {
+    if (cap < SNAPSHOT_HEADER_SIZE) return 0;
+    const PongInputQueue *queue = &auth->queues[player ? 1 : 0];
+    int opponent = player ? 0 : 1;
+
+    // Delta against the newest snapshot the client has, while it is still in the history
+    const PongState *base = NULL;
+    uint32_t age = 0;
+    if (queue->seen > 0 && auth->tick - (queue->seen - 1) < PONG_AUTHORITY_HISTORY) {
+        age = auth->tick - (queue->seen - 1);
+        base = &auth->history[(queue->seen - 1) % PONG_AUTHORITY_HISTORY];
+    }
+
+    size_t size = pong_snapshot_encode(&auth->state, age ? base : NULL, age, out + SNAPSHOT_HEADER_SIZE, cap - SNAPSHOT_HEADER_SIZE);
+    if (size == 0) return 0;
+
+    out[0] = PONG_PACKET_SNAPSHOT;
+    pong_put_u32(out + 1, auth->tick);
+    pong_put_u32(out + 5, queue->next);
+    out[9] = (unsigned char)(auth->queues[opponent].last & HeldKeys(opponent));
+    out[10] = (unsigned char)age;
+    return SNAPSHOT_HEADER_SIZE + size;
+}
+
+size_t pong_authority_write_welcome(const PongAuthority *auth, int player, unsigned char *out, size_t cap) {
+    if (cap < WELCOME_SIZE) return 0;
+    out[0] = PONG_PACKET_WELCOME;
+    out[1] = (unsigned char)(player ? 1 : 0);
+    pong_put_u32(out + 2, (uint32_t)auth->seed);
+    pong_put_u32(out + 6, (uint32_t)(auth->seed >> 32));
+    return WELCOME_SIZE;
+}
+
+void pong_client_init(PongClient *client) {
+    memset(client, 0, sizeof(*client));
+}
+
+size_t pong_client_write_join(uint32_t match, unsigned char *out, size_t cap) {
+    if (cap < JOIN_SIZE) return 0;
+    out[0] = PONG_PACKET_JOIN;
+    pong_put_u32(out + 1, match);
+    return JOIN_SIZE;
+}
+
+bool pong_authority_read_join(const unsigned char *data, size_t size, uint32_t *match) {
+    if (size != JOIN_SIZE || data[0] != PONG_PACKET_JOIN) return false;
+    *match = pong_get_u32(data + 1);
+    return true;
+}
+
+// Prediction = last snapshot + every input the server has not applied yet
+static void Reconcile(PongClient *client) {
+    client->predicted = client->server;
+    for (uint32_t seq = client->acked; seq < client->sent; seq++) {
+        Step(&client->predicted, client->inputs[seq % PONG_AUTHORITY_RING] | client->opponent);
+        client->predictedY[seq % PONG_AUTHORITY_RING] = OwnPaddleY(&client->predicted, client->player);
+    }
+}
+
+static bool ReadSnapshot(PongClient *client, const unsigned char *data, size_t size) {
+    uint32_t tick = pong_get_u32(data + 1);
+    uint32_t ack = pong_get_u32(data + 5);
+    uint32_t age = data[10];
+
+    // Reordered or duplicated snapshots are older than what we have
+    if (client->snapshots > 0 && tick <= client->serverTick) return true;
+    if (ack < client->acked || ack > client->sent || age > tick) return false;
+
+    // A delta needs its baseline; one we no longer hold means the snapshot is lost
+    PongState state = client->server;     // Sizes and RNG key from pong_init() at WELCOME
+    const PongState *base = NULL;
+    if (age > 0) {
+        uint32_t slot = (tick - age) % PONG_AUTHORITY_HISTORY;
+        if (client->receivedTick[slot] != tick - age + 1) return false;
+        base = &client->received[slot];
+    }
+    if (!pong_snapshot_decode(&state, base, age, data + SNAPSHOT_HEADER_SIZE, size - SNAPSHOT_HEADER_SIZE)) return false;
+
+    // Did our own paddle end up where we said it would after the last applied input?
+    if (ack > client->acked) {
+        float error = fabsf(OwnPaddleY(&state, client->player) - client->predictedY[(ack - 1) % PONG_AUTHORITY_RING]);
+        if (error > 0.0f) {
+            client->corrections++;
+            if (error > client->maxCorrection) client->maxCorrection = error;
+        }
+    }
+
+    client->server = state;
+    client->serverTick = tick;
+    client->acked = ack;
+    client->opponent = data[9] & HeldKeys(1 - client->player);
+    client->received[tick % PONG_AUTHORITY_HISTORY] = state;
+    client->receivedTick[tick % PONG_AUTHORITY_HISTORY] = tick + 1;
+    client->snapshots++;
+    client->snapshotBytes += size - SNAPSHOT_HEADER_SIZE;
+    Reconcile(client);
+    return true;
+}
+
+bool pong_client_read(PongClient *client, const unsigned char *data, size_t size) {
+    if (size == WELCOME_SIZE && data[0] == PONG_PACKET_WELCOME) {
+        if (!client->joined) {
+            client->player = data[1] ? 1 : 0;
+            client->seed = pong_get_u32(data + 2) | (uint64_t)pong_get_u32(data + 6) << 32;
+            client->joined = true;
+            InitState(&client->server, client->seed);
+            client->predicted = client->server;
+        }
+        return true;
+    }
+
+    if (size > SNAPSHOT_HEADER_SIZE && data[0] == PONG_PACKET_SNAPSHOT && client->joined) return ReadSnapshot(client, data, size);
+    return false;
+}
+
+bool pong_client_input(PongClient *client, PongInput keys) {
+    if (client->snapshots == 0 || client->sent - client->acked >= PONG_AUTHORITY_RING) return false;
+
+    PongInput input = keys & PlayerKeys(client->player);
+    uint32_t slot = client->sent % PONG_AUTHORITY_RING;
+    client->inputs[slot] = input;
+    client->sent++;
+
+    Step(&client->predicted, input | client->opponent);
+    client->predictedY[slot] = OwnPaddleY(&client->predicted, client->player);
+    return true;
+}
+
+size_t pong_client_write_input(const PongClient *client, unsigned char *out, size_t cap) {
+    uint32_t first = client->acked;
+    uint32_t count = client->sent - first;
+    if (cap < INPUT_HEADER_SIZE + count) return 0;
+
+    out[0] = PONG_PACKET_CLIENT_INPUT;
+    pong_put_u32(out + 1, first);
+    pong_put_u16(out + 5, count);
+    pong_put_u32(out + 7, client->snapshots ? client->serverTick + 1 : 0);
+    for (uint32_t i = 0; i < count; i++) out[INPUT_HEADER_SIZE + i] = (unsigned char)client->inputs[(first + i) % PONG_AUTHORITY_RING];
+
+    return INPUT_HEADER_SIZE + count;
+}
+
+PongState pong_client_view(const PongClient *client) {
+    PongState view = client->predicted;
+    view.score1 = client->server.score1;
+    view.score2 = client->server.score2;
+    view.gameState = client->server.gameState;
+    return view;
+}
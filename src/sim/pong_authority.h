@@ -0,0 +1,132 @@
+#ifndef PONG_AUTHORITY_H
+#define PONG_AUTHORITY_H
+
+#include <stddef.h>
+
+#include "pong.h"
+#include "pong_snapshot.h"
+
+/*
+*  Authoritative server and predicting client
+*  ----------------------------------------------------------------------------------
+*  The alternative to peer-to-peer rollback: one server owns the match. It runs
+*  pong_step() at the fixed tick with the inputs the two clients sent, decides
+*  every hit, goal and WINNING_SCORE check, and sends each client a snapshot of
+*  the result every tick.
+*
+*  A client never waits for the server to see its own paddle move. Each local
+*  tick it applies its keys to a predicted copy of the match straight away, then
+*  on every snapshot it reconciles: start again from the server's state, drop the
+*  inputs the server says it has applied, re-apply the ones still in flight. The
+*  opponent's keys are predicted as whatever the server last saw them hold.
+*  Scores and the game state shown are always the server's.
+*
+*  Snapshots use the delta codec in pong_snapshot.h against the newest snapshot
+*  the client reports having, so the server quantizes its state after every
+*  step and the client's prediction does too.
+*
+*  Like the rollback session this is transport-agnostic: packets in, packets out.
+*
+*  server:                                     client:
+*  pong_authority_init(&auth, seed);           pong_client_init(&client);
+*  per packet: pong_authority_read_input()     per packet: pong_client_read()
+*  per tick:   pong_authority_step(&auth);     per tick:   pong_client_input(&client, keys);
+*              send write_snapshot() to both               send pong_client_write_input();
+*                                                          draw pong_client_view()
+*/
+
+#define PONG_AUTHORITY_RING    256      // Inputs kept per client (in flight + queued)
+#define PONG_AUTHORITY_BACKLOG 24       // Queued inputs (100 ms) beyond this are skipped to cap latency
+#define PONG_AUTHORITY_HISTORY 32       // Past states kept as delta baselines (133 ms)
+#define PONG_AUTHORITY_PACKET_MAX (11 + PONG_AUTHORITY_RING)
+#define PONG_SNAPSHOT_PACKET_MAX  (11 + PONG_SNAPSHOT_MAX)
+
+// Message types (rollback uses 1 and 2)
+typedef enum {
+    PONG_PACKET_JOIN = 16,          // Client -> server: let me into this match
+    PONG_PACKET_WELCOME,            // Server -> client: your player number and the seed
+    PONG_PACKET_CLIENT_INPUT,       // Client -> server: inputs not yet applied
+    PONG_PACKET_SNAPSHOT            // Server -> client: state, tick, inputs applied
+} PongServerPacketType;
+
+typedef struct {
+    PongInput inputs[PONG_AUTHORITY_RING];
+    uint32_t received;              // Inputs 0 .. received - 1 have arrived
+    uint32_t next;                  // Next input the server applies
+    uint32_t seen;                  // The client has the snapshot of tick seen - 1 (0: none yet)
+    PongInput last;                 // Last one applied; its held keys repeat when the queue is dry
+    uint64_t starved;               // Ticks run without a fresh input
+    uint64_t skipped;               // Inputs dropped to keep the queue short
+} PongInputQueue;
+
+typedef struct {
+    PongState state;
+    uint32_t tick;
+    uint64_t seed;
+    PongInputQueue queues[2];       // Player 1, player 2
+    PongState history[PONG_AUTHORITY_HISTORY];  // State at each recent tick, by tick
+} PongAuthority;
+
+typedef struct {
+    int player;                     // 0 or 1, from WELCOME
+    bool joined;
+    uint64_t seed;
+
+    PongState server;               // Latest snapshot
+    uint32_t serverTick;
+    uint32_t acked;                 // The server has applied our inputs below this
+    PongInput opponent;             // Opponent's keys as of the snapshot
+    PongState received[PONG_AUTHORITY_HISTORY];     // Snapshots by tick: delta baselines
+    uint32_t receivedTick[PONG_AUTHORITY_HISTORY];  // Tick + 1 of each, 0 if empty
+
+    PongInput inputs[PONG_AUTHORITY_RING];
+    float predictedY[PONG_AUTHORITY_RING];  // Own paddle y we predicted after each input
+    uint32_t sent;                  // Inputs issued so far
+
+    PongState predicted;            // Server state + inputs still in flight
+
+    // Counters
+    uint64_t snapshots;
+    uint64_t snapshotBytes;         // Encoded state bytes received
+    uint64_t corrections;           // Snapshots where our own paddle was not where we predicted
+    float maxCorrection;            // Largest such error, px
+} PongClient;
+
+void pong_authority_init(PongAuthority *auth, uint64_t seed);
+
+// Queue the inputs in a CLIENT_INPUT packet from player (0 or 1).
+bool pong_authority_read_input(PongAuthority *auth, int player, const unsigned char *data, size_t size);
+
+// Queue one input for a player that is not on the network (bots, load tests).
+void pong_authority_queue_input(PongAuthority *auth, int player, PongInput input);
+
+// One tick: take the next input from each queue and step the match.
+void pong_authority_step(PongAuthority *auth);
+
+// Snapshot for player: state (delta against what they last reported having),
+// tick, how many of their inputs are applied.
+size_t pong_authority_write_snapshot(const PongAuthority *auth, int player, unsigned char *out, size_t cap);
+size_t pong_authority_write_welcome(const PongAuthority *auth, int player, unsigned char *out, size_t cap);
+
+// JOIN: which match the client asks for (servers hosting one match ignore it).
+bool pong_authority_read_join(const unsigned char *data, size_t size, uint32_t *match);
+
+void pong_client_init(PongClient *client);
+size_t pong_client_write_join(uint32_t match, unsigned char *out, size_t cap);
+
+// WELCOME or SNAPSHOT from the server. False if it is neither or malformed.
+bool pong_client_read(PongClient *client, const unsigned char *data, size_t size);
+
+// This tick's keys: applied to the prediction at once. Only own-paddle, serve
+// and pause bits are kept. False before the first snapshot (the match has not
+// started) or with a full ring of inputs the server has not applied (the tick
+// is dropped).
+bool pong_client_input(PongClient *client, PongInput keys);
+
+// Every input the server has not applied yet.
+size_t pong_client_write_input(const PongClient *client, unsigned char *out, size_t cap);
+
+// What to draw: predicted paddles and ball, the server's scores and game state.
+PongState pong_client_view(const PongClient *client);
+
+#endif // PONG_AUTHORITY_H
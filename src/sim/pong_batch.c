@@ -0,0 +1,246 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "pong_batch.h"
+#include "pong_simd.h"
+
+#define PADDLE_MAX_Y   (ARENA_HEIGHT - PADDLE_HEIGHT)
+
+static void *AllocLanes(int capacity, size_t elementSize) {
+    size_t bytes = (size_t)capacity * elementSize;
+    bytes = (bytes + PONG_BATCH_ALIGN - 1) / PONG_BATCH_ALIGN * PONG_BATCH_ALIGN;
+    void *p = aligned_alloc(PONG_BATCH_ALIGN, bytes);
+    if (p) memset(p, 0, bytes);
+    return p;
+}
+
+bool pong_batch_init(PongBatch *batch, int count, uint64_t seed) {
+    memset(batch, 0, sizeof(*batch));
+    if (count <= 0) return false;
+
+    int capacity = (count + PONG_BATCH_LANES - 1) / PONG_BATCH_LANES * PONG_BATCH_LANES;
+    batch->count = count;
+    batch->capacity = capacity;
+    batch->simd = pong_simd_best();
+
+    batch->ballX = AllocLanes(capacity, sizeof(PongLaneValue));
+    batch->ballY = AllocLanes(capacity, sizeof(PongLaneValue));
+    batch->ballVX = AllocLanes(capacity, sizeof(PongLaneValue));
+    batch->ballVY = AllocLanes(capacity, sizeof(PongLaneValue));
+    batch->paddle1Y = AllocLanes(capacity, sizeof(PongLaneValue));
+    batch->paddle2Y = AllocLanes(capacity, sizeof(PongLaneValue));
+    batch->score1 = AllocLanes(capacity, sizeof(int));
+    batch->score2 = AllocLanes(capacity, sizeof(int));
+    batch->gameState = AllocLanes(capacity, sizeof(unsigned char));
+    batch->serveDirection = AllocLanes(capacity, sizeof(signed char));
+    batch->serveJustHappened = AllocLanes(capacity, sizeof(unsigned char));
+    batch->rngKey = AllocLanes(capacity, sizeof(uint64_t));
+    batch->rngCounter = AllocLanes(capacity, sizeof(uint32_t));
+    batch->slow = AllocLanes(capacity, sizeof(unsigned char));
+
+    if (!batch->ballX || !batch->ballY || !batch->ballVX || !batch->ballVY ||
+        !batch->paddle1Y || !batch->paddle2Y || !batch->score1 || !batch->score2 ||
+        !batch->gameState || !batch->serveDirection || !batch->serveJustHappened ||
+        !batch->rngKey || !batch->rngCounter || !batch->slow) {
+        pong_batch_free(batch);
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        PongState state;
+        pong_init(&state, seed + (uint64_t)i);
+        pong_batch_set(batch, i, &state);
+    }
+
+    return true;
+}
+
+void pong_batch_free(PongBatch *batch) {
+    free(batch->ballX);
+    free(batch->ballY);
+    free(batch->ballVX);
+    free(batch->ballVY);
+    free(batch->paddle1Y);
+    free(batch->paddle2Y);
+    free(batch->score1);
+    free(batch->score2);
+    free(batch->gameState);
+    free(batch->serveDirection);
+    free(batch->serveJustHappened);
+    free(batch->rngKey);
+    free(batch->rngCounter);
+    free(batch->slow);
+    memset(batch, 0, sizeof(*batch));
+}
+
+void pong_batch_get(const PongBatch *batch, int lane, PongState *state) {
+    pong_init(state, 1);    // Fixed fields: paddle x, sizes, ball radius
+
+    state->player1.position.y = pong_lane_to_float(batch->paddle1Y[lane]);
+    state->player2.position.y = pong_lane_to_float(batch->paddle2Y[lane]);
+    state->ball.position = (Vector2){ pong_lane_to_float(batch->ballX[lane]), pong_lane_to_float(batch->ballY[lane]) };
+    state->ball.velocity = (Vector2){ pong_lane_to_float(batch->ballVX[lane]), pong_lane_to_float(batch->ballVY[lane]) };
+    state->gameState = (GameState)batch->gameState[lane];
+    state->score1 = batch->score1[lane];
+    state->score2 = batch->score2[lane];
+    state->serveDirection = batch->serveDirection[lane];
+    state->serveJustHappened = batch->serveJustHappened[lane] != 0;
+    state->rngKey = batch->rngKey[lane];
+    state->rngCounter = batch->rngCounter[lane];
+}
+
+void pong_batch_set(PongBatch *batch, int lane, const PongState *state) {
+    batch->paddle1Y[lane] = pong_lane_from_float(state->player1.position.y);
+    batch->paddle2Y[lane] = pong_lane_from_float(state->player2.position.y);
+    batch->ballX[lane] = pong_lane_from_float(state->ball.position.x);
+    batch->ballY[lane] = pong_lane_from_float(state->ball.position.y);
+    batch->ballVX[lane] = pong_lane_from_float(state->ball.velocity.x);
+    batch->ballVY[lane] = pong_lane_from_float(state->ball.velocity.y);
+    batch->gameState[lane] = (unsigned char)state->gameState;
+    batch->score1[lane] = state->score1;
+    batch->score2[lane] = state->score2;
+    batch->serveDirection[lane] = (signed char)state->serveDirection;
+    batch->serveJustHappened[lane] = state->serveJustHappened ? 1 : 0;
+    batch->rngKey[lane] = state->rngKey;
+    batch->rngCounter[lane] = state->rngCounter;
+}
+
+#ifndef PONG_FIXED_POINT
+
+// Bitwise select: keeps the stores unconditional, which is what lets the loop
+// below vectorise (a "fast ? new : old" store gets sunk into a branch instead).
+static inline float SelectBits(unsigned int mask, float a, float b) {
+    unsigned int ua, ub;
+    memcpy(&ua, &a, sizeof(ua));
+    memcpy(&ub, &b, sizeof(ub));
+    unsigned int r = (ua & mask) | (ub & ~mask);
+    float f;
+    memcpy(&f, &r, sizeof(f));
+    return f;
+}
+
+// Scalar fallback for open play away from every contact: paddles move, the ball
+// flies straight. Branch-free so the compiler can vectorise it; produces the same
+// bits as pong_step() would for these lanes.
+static void StepFastLanes(int count, const PongInput *restrict inputs, float dt,
+                          float *restrict ballX, float *restrict ballY,
+                          const float *restrict ballVX, const float *restrict ballVY,
+                          float *restrict paddle1Y, float *restrict paddle2Y,
+                          const unsigned char *restrict gameState, unsigned char *restrict slow) {
+    const float paddleStep = PADDLE_SPEED * dt;
+    const float r = BALL_RADIUS;
+    const float lowY = r + FAST_PATH_MARGIN;
+    const float highY = ARENA_HEIGHT - r - FAST_PATH_MARGIN;
+    const float leftX = PADDLE1_X + PADDLE_WIDTH + r + FAST_PATH_MARGIN;
+    const float rightX = PADDLE2_X - r - FAST_PATH_MARGIN;
+
+    for (int i = 0; i < count; i++) {
+        PongInput in = inputs[i];
+        float p1Old = paddle1Y[i], p2Old = paddle2Y[i];
+        float x0 = ballX[i], y0 = ballY[i];
+
+        // Key bits as 0/1 factors: p - step*0 and p + step*0 leave p bit-identical
+        float p1Up = (float)(in & PONG_INPUT_P1_UP), p1Down = (float)((in & PONG_INPUT_P1_DOWN) >> 1);
+        float p2Up = (float)((in & PONG_INPUT_P2_UP) >> 2), p2Down = (float)((in & PONG_INPUT_P2_DOWN) >> 3);
+
+        float p1 = p1Old - paddleStep * p1Up;
+        p1 = p1 + paddleStep * p1Down;
+        p1 = (p1 < 0.0f) ? 0.0f : p1;
+        p1 = (p1 > PADDLE_MAX_Y) ? PADDLE_MAX_Y : p1;
+
+        float p2 = p2Old - paddleStep * p2Up;
+        p2 = p2 + paddleStep * p2Down;
+        p2 = (p2 < 0.0f) ? 0.0f : p2;
+        p2 = (p2 > PADDLE_MAX_Y) ? PADDLE_MAX_Y : p2;
+
+        float x1 = x0 + ballVX[i] * dt;
+        float y1 = y0 + ballVY[i] * dt;
+
+        int playing = (gameState[i] == GAME_PLAYING) & ((in & PONG_INPUT_PAUSE) == 0);
+        int clear = (y1 > lowY) & (y1 < highY) &
+                    (x0 > leftX) & (x1 > leftX) & (x0 < rightX) & (x1 < rightX);
+        int fast = playing & clear;
+        unsigned int mask = 0u - (unsigned int)fast;
+
+        paddle1Y[i] = SelectBits(mask, p1, p1Old);
+        paddle2Y[i] = SelectBits(mask, p2, p2Old);
+        ballX[i] = SelectBits(mask, x1, x0);
+        ballY[i] = SelectBits(mask, y1, y0);
+        slow[i] = (unsigned char)!fast;
+    }
+}
+
+#endif // PONG_FIXED_POINT
+
+#ifdef PONG_FIXED_POINT
+
+// Open play clear of the paddle columns that the kernels left (the portable loop
+// leaves every wall bounce), stepped by the integer rules straight on the lanes
+// instead of through a PongState.
+static bool StepOpenLane(PongBatch *batch, int lane, PongInput input, float dt) {
+    if (batch->gameState[lane] != GAME_PLAYING || (input & PONG_INPUT_PAUSE)) return false;
+
+    PongFixedBodies bodies = {
+        batch->ballX[lane], batch->ballY[lane], batch->ballVX[lane], batch->ballVY[lane],
+        batch->paddle1Y[lane], batch->paddle2Y[lane],
+    };
+    if (!pong_fixed_step_open(&bodies, input, pong_fixed_time(dt), (PongFixed)(FAST_PATH_MARGIN * PONG_FIXED_ONE))) return false;
+
+    batch->ballX[lane] = bodies.ballX;
+    batch->ballY[lane] = bodies.ballY;
+    batch->ballVY[lane] = bodies.velocityY;
+    batch->paddle1Y[lane] = bodies.paddle1Y;
+    batch->paddle2Y[lane] = bodies.paddle2Y;
+    return true;
+}
+
+#endif // PONG_FIXED_POINT
+
+// Step lanes [first, first + count); touches nothing outside that range.
+static void StepRange(PongBatch *batch, int first, int count, const PongInput *inputs, float dt) {
+#ifdef PONG_FIXED_POINT
+    pong_simd_step(batch->simd, batch, first, count, inputs, dt);   // Covers every lane
+#else
+    // Vector kernel for whole groups of lanes, the scalar loop for the tail
+    int done = pong_simd_step(batch->simd, batch, first, count, inputs, dt);
+    int tail = first + done;
+
+    StepFastLanes(count - done, inputs + tail, dt, batch->ballX + tail, batch->ballY + tail,
+                  batch->ballVX + tail, batch->ballVY + tail, batch->paddle1Y + tail, batch->paddle2Y + tail,
+                  batch->gameState + tail, batch->slow + tail);
+#endif
+
+    for (int i = first; i < first + count; i++) {
+        if (!batch->slow[i]) continue;
+
+        PongInput input = inputs[i] & ~(PONG_INPUT_P1_PARTS | PONG_INPUT_P2_PARTS);
+#ifdef PONG_FIXED_POINT
+        if (StepOpenLane(batch, i, input, dt)) continue;
+#endif
+
+        PongState state;
+        pong_batch_get(batch, i, &state);
+        pong_step(&state, input, dt);
+        pong_batch_set(batch, i, &state);
+    }
+}
+
+void pong_batch_step(PongBatch *batch, const PongInput *inputs, float dt) {
+    StepRange(batch, 0, batch->count, inputs, dt);
+}
+
+typedef struct {
+    PongBatch *batch;
+    const PongInput *inputs;
+    float dt;
+} ParallelStep;
+
+static void StepChunk(void *user, int first, int count) {
+    ParallelStep *job = user;
+    StepRange(job->batch, first, count, job->inputs, job->dt);
+}
+
+void pong_batch_step_parallel(PongBatch *batch, PongPool *pool, const PongInput *inputs, float dt) {
+    ParallelStep job = { batch, inputs, dt };
+    pong_pool_run(pool, batch->count, PONG_BATCH_CHUNK, StepChunk, &job);
+}
@@ -0,0 +1,97 @@
+#ifndef PONG_BATCH_H
+#define PONG_BATCH_H
+
+#include "pong.h"
+#include "pong_fixed.h"
+#include "pong_pool.h"
+
+/*
+*  Batched simulation
+*  ----------------------------------------------------------------------------------
+*  N independent matches in structure-of-arrays layout. Each lane follows exactly
+*  the rules of pong_step(); the batch only changes how the work is laid out:
+*
+*  - Lanes in open play (the vast majority of ticks) are stepped by a vector
+*    kernel: straight flight, one wall bounce, or a clean hit on a paddle face.
+*  - Every other lane (serves, pauses, contacts, goals) is gathered into a
+*    PongState, stepped by pong_step() and scattered back.
+*
+*  Lanes never interact, so pong_batch_step_parallel() can hand out chunks of
+*  PONG_BATCH_CHUNK lanes to a thread pool and still produce exactly the bits
+*  pong_batch_step() would.
+*
+*  Paddle x, paddle size and ball radius are the same for every match and are not
+*  stored per lane. Positions and velocities are stored in the number type the
+*  rules run in: floats, or in PONG_FIXED_POINT builds the Q20.12 integers of
+*  pong_fixed.h, so the kernels never convert. pong_batch_get()/pong_batch_set()
+*  convert to and from PongState's floats.
+*/
+
+// Instruction set used for the open-play lanes. pong_batch_init() picks the best
+// one the CPU supports at run time; it can be lowered afterwards (benchmarks, debugging).
+typedef enum {
+    PONG_SIMD_SCALAR,
+    PONG_SIMD_SSE2,         // 4 lanes per instruction
+    PONG_SIMD_AVX2          // 8 lanes per instruction
+} PongSimdLevel;
+
+#define PONG_BATCH_ALIGN 64         // Array alignment in bytes (one cache line / AVX-512 vector)
+#define PONG_BATCH_LANES 16         // Capacity is rounded up to a multiple of this
+
+// Lanes per thread-pool chunk: about 30 KB of lane state, so a chunk stays in L1/L2
+// while it is stepped, and a multiple of 64 so no two chunks share a cache line
+#define PONG_BATCH_CHUNK 1024
+
+#ifdef PONG_FIXED_POINT
+typedef PongFixed PongLaneValue;
+static inline float pong_lane_to_float(PongLaneValue x) { return pong_fixed_to_float(x); }
+static inline PongLaneValue pong_lane_from_float(float f) { return pong_fixed_from_float(f); }
+#else
+typedef float PongLaneValue;
+static inline float pong_lane_to_float(PongLaneValue x) { return x; }
+static inline PongLaneValue pong_lane_from_float(float f) { return f; }
+#endif
+
+typedef struct {
+    int count;
+    int capacity;
+    PongSimdLevel simd;
+
+    // Per-lane state, one array per field
+    PongLaneValue *ballX;
+    PongLaneValue *ballY;
+    PongLaneValue *ballVX;
+    PongLaneValue *ballVY;
+    PongLaneValue *paddle1Y;
+    PongLaneValue *paddle2Y;
+    int *score1;
+    int *score2;
+    unsigned char *gameState;           // GameState
+    signed char *serveDirection;        // -1 or 1
+    unsigned char *serveJustHappened;
+    uint64_t *rngKey;
+    uint32_t *rngCounter;
+
+    unsigned char *slow;                // Scratch: lanes left for pong_step() this tick
+} PongBatch;
+
+// Allocate count matches at the start screen; lane i is seeded with seed + i.
+bool pong_batch_init(PongBatch *batch, int count, uint64_t seed);
+void pong_batch_free(PongBatch *batch);
+
+// Advance every match by dt seconds; inputs holds one PongInput per lane. Keys
+// count for the whole tick: the sub-tick part fields are ignored.
+void pong_batch_step(PongBatch *batch, const PongInput *inputs, float dt);
+
+// Same result as pong_batch_step(), with the lanes spread over the pool's threads.
+void pong_batch_step_parallel(PongBatch *batch, PongPool *pool, const PongInput *inputs, float dt);
+
+// Best instruction set this CPU can run, and a printable name for a level.
+PongSimdLevel pong_simd_best(void);
+const char *pong_simd_name(PongSimdLevel level);
+
+// Copy one lane out to / in from the scalar representation.
+void pong_batch_get(const PongBatch *batch, int lane, PongState *state);
+void pong_batch_set(PongBatch *batch, int lane, const PongState *state);
+
+#endif // PONG_BATCH_H
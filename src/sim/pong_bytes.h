@@ -0,0 +1,45 @@
+#ifndef PONG_BYTES_H
+#define PONG_BYTES_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+*  Little-endian fields for files and packets
+*  ----------------------------------------------------------------------------------
+*  Recordings and network messages are read on other machines, so multi-byte
+*  fields are written byte by byte in little-endian order and floats as their
+*  IEEE-754 bits - never as raw structs.
+*/
+
+static inline void pong_put_u16(unsigned char *out, uint32_t v) {
+    out[0] = (unsigned char)v;
+    out[1] = (unsigned char)(v >> 8);
+}
+
+static inline void pong_put_u32(unsigned char *out, uint32_t v) {
+    for (int i = 0; i < 4; i++) out[i] = (unsigned char)(v >> (8 * i));
+}
+
+static inline uint32_t pong_get_u16(const unsigned char *in) {
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8;
+}
+
+static inline uint32_t pong_get_u32(const unsigned char *in) {
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+static inline void pong_put_float(unsigned char *out, float f) {
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    pong_put_u32(out, v);
+}
+
+static inline float pong_get_float(const unsigned char *in) {
+    uint32_t v = pong_get_u32(in);
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+#endif // PONG_BYTES_H
@@ -0,0 +1,56 @@
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+
+#include "pong_clock.h"
+
+#define RAYMATH_STATIC_INLINE
+#include <raymath.h>
+
+int pong_clock_advance(PongClock *clock, double frameTime) {
+    if (frameTime < 0.0) frameTime = 0.0;
+    if (frameTime > PONG_MAX_FRAME_TIME) frameTime = PONG_MAX_FRAME_TIME;
+
+    clock->accumulator += frameTime;
+
+    int ticks = (int)(clock->accumulator / (double)PONG_TICK_DT);
+    clock->accumulator -= ticks * (double)PONG_TICK_DT;
+
+    // Guard against the division landing a hair under a whole tick
+    if (clock->accumulator < 0.0) clock->accumulator = 0.0;
+
+    return ticks;
+}
+
+float pong_clock_alpha(const PongClock *clock) {
+    float alpha = (float)(clock->accumulator / (double)PONG_TICK_DT);
+    return Clamp(alpha, 0.0f, 1.0f);
+}
+
+double pong_clock_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+void pong_clock_sleep_until(double deadline) {
+    double wait = deadline - pong_clock_now();
+    if (wait <= 0.0) return;
+
+    struct timespec ts = { (time_t)wait, (long)((wait - (double)(time_t)wait) * 1e9) };
+    nanosleep(&ts, NULL);
+}
+
+PongState pong_interpolate(const PongState *previous, const PongState *current, float alpha) {
+    PongState view = *current;
+
+    view.player1.position = Vector2Lerp(previous->player1.position, current->player1.position, alpha);
+    view.player2.position = Vector2Lerp(previous->player2.position, current->player2.position, alpha);
+
+    // The ball only moves smoothly in play; a serve re-centres it and blending
+    // across that would streak it over the court
+    if (previous->gameState == GAME_PLAYING && current->gameState == GAME_PLAYING) {
+        view.ball.position = Vector2Lerp(previous->ball.position, current->ball.position, alpha);
+    }
+
+    return view;
+}
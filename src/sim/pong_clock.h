@@ -0,0 +1,42 @@
+#ifndef PONG_CLOCK_H
+#define PONG_CLOCK_H
+
+#include "pong.h"
+
+/*
+*  Fixed-timestep clock
+*  ----------------------------------------------------------------------------------
+*  The simulation always advances in PONG_TICK_DT steps, whatever the display does.
+*  Each frame the real elapsed time goes into an accumulator and is paid out as
+*  whole ticks; the fraction left over is the interpolation factor for drawing.
+*
+*  int ticks = pong_clock_advance(&clock, GetFrameTime());
+*  for (int i = 0; i < ticks; i++) { previous = state; pong_step(&state, input, PONG_TICK_DT); }
+*  PongState view = pong_interpolate(&previous, &state, pong_clock_alpha(&clock));
+*/
+
+#define PONG_TICK_RATE       240                        // Simulation ticks per second
+#define PONG_TICK_DT         (1.0f / PONG_TICK_RATE)
+#define PONG_MAX_FRAME_TIME  0.25                       // Longer frames (hitches, breakpoints) are clipped
+
+typedef struct {
+    double accumulator;     // Unsimulated time, always in [0, PONG_TICK_DT) after advance
+} PongClock;
+
+// Add one frame of real time; returns how many ticks to run this frame.
+int pong_clock_advance(PongClock *clock, double frameTime);
+
+// How far between the last two ticks the display is, in [0, 1).
+float pong_clock_alpha(const PongClock *clock);
+
+// Seconds on a monotonic clock, the same for every thread.
+double pong_clock_now(void);
+
+// Sleep until pong_clock_now() reaches deadline (returns at once if it has).
+void pong_clock_sleep_until(double deadline);
+
+// State to draw: positions blended between the last two ticks. The ball is only
+// blended while in play, so it snaps instead of sliding when re-centred for a serve.
+PongState pong_interpolate(const PongState *previous, const PongState *current, float alpha);
+
+#endif // PONG_CLOCK_H
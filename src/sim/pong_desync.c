@@ -0,0 +1,271 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pong_bytes.h"
+#include "pong_desync.h"
+#include "pong_rng.h"
+
+#define DESYNC_HEADER_SIZE 8        // type, from u32, count u16, exact u8
+#define DUMP_SIZE (8 + PONG_STATE_BYTES)    // type, kind u8, tick u32, haveYours u8, exact u8, image
+#define RESEND_EVERY 16             // write() calls between repeats of an unanswered packet
+
+typedef enum {
+    DUMP_CLEAN = 0,                 // The queried hashes all matched below tick
+    DUMP_STATE = 1                  // Our state at the first tick that did not
+} DumpKind;
+
+// Random key words for the hash, one per state word
+static const uint32_t hashKeys[22] = {
+    0x910a2dec, 0x975835de, 0x1a57fd71, 0xe1e0e3d8, 0x24dd8eba, 0x3ae94d3d, 0x7a1ec2ad, 0xc3a3c7c9,
+    0x5c3a1d4f, 0x4d1b8e37, 0x8f2e6b13, 0xb7e9c4a1, 0x2a6d3f85, 0x6e41b07d, 0xd8c5e219, 0x1f7a9c63,
+    0xa4b2f05b, 0x39e8d6c7, 0xf05d4a2b, 0x8c17e3f1, 0x5b8e21d9, 0xc6f3a947,
+};
+
+// The paddles, the ball, gameState, the scores and serveDirection are 17 four-byte
+// fields in a row with no padding, so they load as one block
+#define HASH_BLOCK_WORDS 17
+_Static_assert(offsetof(PongState, serveDirection) == (HASH_BLOCK_WORDS - 1) * 4, "PongState layout changed: update pong_state_hash");
+
+static uint32_t Bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+// NH: pairs of keyed words multiplied to 64 bits and summed, then one finaliser.
+// Eleven independent multiplies, no branches, no loop-carried chain but the add.
+uint32_t pong_state_hash(const PongState *state) {
+    uint32_t w[22];
+    memcpy(w, state, HASH_BLOCK_WORDS * 4);
+    w[17] = state->serveJustHappened ? 1 : 0;
+    w[18] = state->rngCounter;
+    w[19] = (uint32_t)state->rngKey;
+    w[20] = (uint32_t)(state->rngKey >> 32);
+    w[21] = 0;
+
+    uint64_t sum = 0;
+    for (int i = 0; i < 22; i += 2) sum += (uint64_t)(w[i] + hashKeys[i]) * (uint64_t)(w[i + 1] + hashKeys[i + 1]);
+    return (uint32_t)(pong_rng_mix(sum) >> 32);
+}
+
+// Oldest tick still in the history
+static uint32_t OldestTick(const PongDesync *d) {
+    return (d->end > PONG_DESYNC_HISTORY) ? d->end - PONG_DESYNC_HISTORY : 0;
+}
+
+static bool Recorded(const PongDesync *d, uint32_t tick) {
+    return tick < d->end && tick >= OldestTick(d);
+}
+
+void pong_desync_init(PongDesync *d, const PongState *initial) {
+    memset(d, 0, sizeof(*d));
+    pong_desync_record(d, initial);
+}
+
+static void Found(PongDesync *d, uint32_t tick, bool exact) {
+    d->status = PONG_DESYNC_FOUND;
+    d->divergedAt = tick;
+    d->exact = exact;
+    d->haveLocal = Recorded(d, tick);
+    if (d->haveLocal) d->local = d->states[tick % PONG_DESYNC_HISTORY];
+    d->haveRemote = false;
+    d->quiet = 0;
+}
+
+// Both sides have recorded tick: compare the rolling hashes
+static void Compare(PongDesync *d, uint32_t tick, uint32_t rolling) {
+    if (d->status != PONG_DESYNC_NONE) return;
+
+    if (d->rolling[tick % PONG_DESYNC_HISTORY] == rolling) {
+        if (tick + 1 > d->agreed) d->agreed = tick + 1;
+    } else {
+        d->status = PONG_DESYNC_SUSPECT;
+        d->suspectTick = tick;
+        d->quiet = 0;
+    }
+}
+
+void pong_desync_record(PongDesync *d, const PongState *state) {
+    uint32_t tick = d->end++;
+    uint32_t hash = pong_state_hash(state);
+    d->running = (uint32_t)(pong_rng_mix((uint64_t)d->running << 32 | hash) >> 32);
+
+    d->hashes[tick % PONG_DESYNC_HISTORY] = hash;
+    d->rolling[tick % PONG_DESYNC_HISTORY] = d->running;
+    d->states[tick % PONG_DESYNC_HISTORY] = *state;
+
+    if (d->peerPending && d->peerTick == tick) {
+        d->peerPending = false;
+        Compare(d, tick, d->peerRolling);
+    }
+}
+
+bool pong_desync_latest(const PongDesync *d, uint32_t *tick, uint32_t *rolling) {
+    if (d->end == 0) return false;
+    *tick = d->end - 1;
+    *rolling = d->running;
+    return true;
+}
+
+void pong_desync_peer(PongDesync *d, uint32_t tick, uint32_t rolling) {
+    if (tick >= d->end) {
+        // Ahead of us: keep the newest and compare once we get there
+        if (!d->peerPending || tick > d->peerTick) {
+            d->peerTick = tick;
+            d->peerRolling = rolling;
+            d->peerPending = true;
+        }
+    } else if (tick >= OldestTick(d)) {
+        Compare(d, tick, rolling);
+    }
+}
+
+// The peer's per-tick hashes: find the first of them that differs from ours
+static bool ReadQuery(PongDesync *d, const unsigned char *data, size_t size) {
+    uint32_t from = pong_get_u32(data + 1);
+    uint32_t count = pong_get_u16(data + 5);
+    bool exact = data[7] != 0;
+    if (size != DESYNC_HEADER_SIZE + 4 * (size_t)count) return false;
+
+    // Ticks that fell out of our history cannot be compared; past our end we have no hash yet
+    uint32_t t = from;
+    if (t < OldestTick(d)) {
+        t = OldestTick(d);
+        exact = false;
+    }
+    for (; t < from + count && t < d->end; t++) {
+        if (d->hashes[t % PONG_DESYNC_HISTORY] == pong_get_u32(data + DESYNC_HEADER_SIZE + 4 * (t - from))) continue;
+
+        if (d->status != PONG_DESYNC_FOUND || t < d->divergedAt) Found(d, t, exact);
+        d->cleanThrough = 0;
+        d->replyPending = true;
+        return true;
+    }
+
+    if (t > d->agreed && d->status == PONG_DESYNC_NONE) d->agreed = t;
+    d->cleanThrough = t;
+    d->replyPending = true;
+    return true;
+}
+
+static bool ReadDump(PongDesync *d, const unsigned char *data, size_t size) {
+    if (size != DUMP_SIZE) return false;
+    uint32_t tick = pong_get_u32(data + 2);
+
+    if (data[1] == DUMP_CLEAN) {
+        if (d->status != PONG_DESYNC_SUSPECT) return true;
+        if (tick > d->agreed) d->agreed = tick;
+        d->quiet = 0;
+        // Every tick up to the suspect one matched: the rolling hashes disagreed about
+        // history neither side still has. Nothing left to find.
+        if (d->agreed > d->suspectTick) d->status = PONG_DESYNC_NONE;
+        return true;
+    }
+
+    // Unpack over a state of ours: the fields the image leaves out never change
+    PongState remote = d->states[(Recorded(d, tick) ? tick : d->end - 1) % PONG_DESYNC_HISTORY];
+    if (data[1] != DUMP_STATE || !pong_state_unpack(&remote, data + 8)) return false;
+
+    // Both sides searched at once and found different ticks: the earlier one wins
+    if (d->status != PONG_DESYNC_FOUND || tick < d->divergedAt) Found(d, tick, data[7] != 0);
+    if (tick == d->divergedAt) {
+        d->remote = remote;
+        d->haveRemote = true;
+    }
+    if (!data[6]) {
+        d->cleanThrough = 0;
+        d->replyPending = true;
+    }
+    return true;
+}
+
+bool pong_desync_read(PongDesync *d, const unsigned char *data, size_t size) {
+    if (size >= DESYNC_HEADER_SIZE && data[0] == PONG_PACKET_DESYNC) return ReadQuery(d, data, size);
+    if (size >= 1 && data[0] == PONG_PACKET_DUMP) return ReadDump(d, data, size);
+    return false;
+}
+
+static size_t WriteDump(const PongDesync *d, DumpKind kind, unsigned char *out, size_t cap) {
+    if (cap < DUMP_SIZE) return 0;
+    memset(out, 0, DUMP_SIZE);
+    out[0] = PONG_PACKET_DUMP;
+    out[1] = (unsigned char)kind;
+    if (kind == DUMP_CLEAN) {
+        pong_put_u32(out + 2, d->cleanThrough);
+        return DUMP_SIZE;
+    }
+
+    pong_put_u32(out + 2, d->divergedAt);
+    out[6] = d->haveRemote ? 1 : 0;
+    out[7] = d->exact ? 1 : 0;
+    pong_state_pack(&d->local, out + 8);
+    return DUMP_SIZE;
+}
+
+static size_t WriteQuery(PongDesync *d, unsigned char *out, size_t cap) {
+    uint32_t from = d->agreed;
+    bool exact = true;
+    if (from < OldestTick(d)) {
+        from = OldestTick(d);
+        exact = false;
+    }
+
+    uint32_t count = d->suspectTick + 1 - from;
+    if (count > PONG_DESYNC_QUERY) count = PONG_DESYNC_QUERY;
+    if (cap < DESYNC_HEADER_SIZE + 4 * (size_t)count) return 0;
+
+    out[0] = PONG_PACKET_DESYNC;
+    pong_put_u32(out + 1, from);
+    pong_put_u16(out + 5, count);
+    out[7] = exact ? 1 : 0;
+    for (uint32_t i = 0; i < count; i++) pong_put_u32(out + DESYNC_HEADER_SIZE + 4 * i, d->hashes[(from + i) % PONG_DESYNC_HISTORY]);
+    return DESYNC_HEADER_SIZE + 4 * (size_t)count;
+}
+
+size_t pong_desync_write(PongDesync *d, unsigned char *out, size_t cap) {
+    if (d->replyPending) {
+        if (d->cleanThrough) {
+            d->replyPending = false;
+            return WriteDump(d, DUMP_CLEAN, out, cap);
+        }
+        if (d->status == PONG_DESYNC_FOUND && d->haveLocal) {
+            d->replyPending = false;
+            return WriteDump(d, DUMP_STATE, out, cap);
+        }
+        d->replyPending = false;
+    }
+
+    // Our own question or dump, repeated until the answer arrives
+    bool waiting = (d->status == PONG_DESYNC_SUSPECT) || (d->status == PONG_DESYNC_FOUND && d->haveLocal && !d->haveRemote);
+    if (!waiting || d->quiet++ % RESEND_EVERY != 0) return 0;
+
+    return (d->status == PONG_DESYNC_SUSPECT) ? WriteQuery(d, out, cap) : WriteDump(d, DUMP_STATE, out, cap);
+}
+
+static int Float(char *out, size_t cap, const char *name, float value) {
+    return snprintf(out, cap, "  %-18s %.9g (%08x)\n", name, value, Bits(value));
+}
+
+void pong_desync_dump(const PongState *state, char *out, size_t cap) {
+    static const char *gameStates[] = { "start", "serve", "playing", "pause", "over" };
+    const struct { const char *name; float value; } floats[] = {
+        { "player1.position.y", state->player1.position.y },
+        { "player2.position.y", state->player2.position.y },
+        { "ball.position.x", state->ball.position.x },
+        { "ball.position.y", state->ball.position.y },
+        { "ball.velocity.x", state->ball.velocity.x },
+        { "ball.velocity.y", state->ball.velocity.y },
+    };
+
+    size_t used = 0;
+    for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]) && used < cap; i++) {
+        used += (size_t)Float(out + used, cap - used, floats[i].name, floats[i].value);
+    }
+    if (used >= cap) return;
+
+    const char *gameState = ((unsigned)state->gameState <= GAME_OVER) ? gameStates[state->gameState] : "?";
+    snprintf(out + used, cap - used, "  %-18s %s, score %d:%d, serve %+d%s, rng draw %u, hash %08x\n", "game",
+             gameState, state->score1, state->score2, state->serveDirection, state->serveJustHappened ? " (just served)" : "",
+             state->rngCounter, pong_state_hash(state));
+}
@@ -0,0 +1,104 @@
+#ifndef PONG_DESYNC_H
+#define PONG_DESYNC_H
+
+#include <stddef.h>
+
+#include "pong.h"
+
+/*
+*  Desync detection
+*  ----------------------------------------------------------------------------------
+*  Two simulations fed the same inputs must stay bit-identical; when they do
+*  not (a compiler, a CPU, an uninitialised field) this finds the first tick
+*  where they parted and shows both states there.
+*
+*  pong_state_hash() reduces every field of a PongState that the rules read or
+*  write - both Paddle structs, the Ball, scores, gameState, serve fields and the
+*  RNG counter, floats by their bits - to 32 bits in a few nanoseconds, so it can
+*  run on every tick of every match. A detector records the hash of each state
+*  in order and chains them into a rolling hash: equal rolling hashes at tick n
+*  mean the whole history up to n agreed.
+*
+*  Peers exchange just the newest rolling hash (pong_rollback puts it in every
+*  input packet). When one differs, the side that noticed sends its per-tick
+*  hashes since the last tick both agreed on (DESYNC); the other finds the first
+*  that differs and both trade their state at that tick (DUMP). The detector
+*  keeps the last PONG_DESYNC_HISTORY states for this.
+*
+*  Like the rollback session it is transport-agnostic:
+*
+*  pong_desync_init(&d, &state);                   // state 0
+*  per tick:    pong_desync_record(&d, &state);    // states 1, 2, ... in order
+*  per packet:  pong_desync_peer(&d, tick, rolling) / pong_desync_read(&d, data, size)
+*  per tick:    send pong_desync_write(&d, buf, sizeof(buf)) if not 0
+*  d.status == PONG_DESYNC_FOUND: d.divergedAt, d.local, d.remote
+*/
+
+#define PONG_DESYNC_HISTORY 256     // States (and their hashes) kept for the search, ~1 s at 240 Hz
+#define PONG_DESYNC_QUERY   128     // Per-tick hashes in one DESYNC packet
+#define PONG_DESYNC_PACKET_MAX (8 + 4 * PONG_DESYNC_QUERY)
+#define PONG_DESYNC_DUMP_TEXT 512   // Enough for pong_desync_dump()
+
+// Message types (rollback uses 1 and 2)
+typedef enum {
+    PONG_PACKET_DESYNC = 3,         // Per-tick hashes from the last agreed tick on
+    PONG_PACKET_DUMP = 4            // State at the first divergent tick, or "these all match"
+} PongDesyncPacketType;
+
+typedef enum {
+    PONG_DESYNC_NONE,
+    PONG_DESYNC_SUSPECT,            // Rolling hashes differ; searching for the tick
+    PONG_DESYNC_FOUND
+} PongDesyncStatus;
+
+typedef struct {
+    uint32_t hashes[PONG_DESYNC_HISTORY];       // By tick
+    uint32_t rolling[PONG_DESYNC_HISTORY];
+    PongState states[PONG_DESYNC_HISTORY];
+    uint32_t end;                   // States 0 .. end - 1 recorded
+    uint32_t running;               // Rolling hash of state end - 1
+
+    uint32_t peerTick;              // Newest rolling hash from the peer, waiting for our own state
+    uint32_t peerRolling;
+    bool peerPending;
+    uint32_t agreed;                // States below this are known to match
+
+    PongDesyncStatus status;
+    uint32_t suspectTick;           // A tick whose rolling hashes differ
+    uint32_t divergedAt;            // First tick whose states differ
+    bool exact;                     // False: the history did not reach back far enough, divergedAt is an upper bound
+    PongState local;                // Both sides' state at divergedAt
+    PongState remote;
+    bool haveLocal;
+    bool haveRemote;
+    bool replyPending;              // Answer the peer's last DESYNC or DUMP
+    uint32_t cleanThrough;          // For that answer: its hashes matched ours below this; 0 = they did not
+    uint32_t quiet;                 // write() calls since our last unanswered query or dump
+} PongDesync;
+
+// Hash of everything in a state that the rules touch.
+uint32_t pong_state_hash(const PongState *state);
+
+// Start with the state of tick 0.
+void pong_desync_init(PongDesync *d, const PongState *initial);
+
+// Record the state of the next tick (end). Compares with the peer's rolling
+// hash if it was waiting for this tick.
+void pong_desync_record(PongDesync *d, const PongState *state);
+
+// Newest tick recorded and its rolling hash; false before any.
+bool pong_desync_latest(const PongDesync *d, uint32_t *tick, uint32_t *rolling);
+
+// The peer's rolling hash at tick.
+void pong_desync_peer(PongDesync *d, uint32_t tick, uint32_t rolling);
+
+// DESYNC or DUMP packet from the peer. False if it is neither.
+bool pong_desync_read(PongDesync *d, const unsigned char *data, size_t size);
+
+// The packet this side owes the peer, if any: 0 when there is nothing to send.
+size_t pong_desync_write(PongDesync *d, unsigned char *out, size_t cap);
+
+// Human-readable state, floats with their bits: what to put in a desync report.
+void pong_desync_dump(const PongState *state, char *out, size_t cap);
+
+#endif // PONG_DESYNC_H
@@ -0,0 +1,200 @@
+#include <math.h>
+#include <string.h>
+
+#include "pong_clock.h"
+#include "pong_event.h"
+#include "pong_fixed.h"
+
+#define SAFETY_TICKS 2              // Kept between a skip and any predicted event, for rounding
+
+void pong_event_init(PongEventMatch *m, uint64_t seed, PongCpuConfig player1, PongCpuConfig player2, uint64_t cpuSeed) {
+    memset(m, 0, sizeof(*m));
+    pong_init(&m->state, seed);
+    m->rules = pong_default_rules;
+    pong_cpu_init(&m->cpus[0], 0, player1, cpuSeed);
+    pong_cpu_init(&m->cpus[1], 1, player2, cpuSeed + 1);
+}
+
+PongInput pong_event_input(PongEventMatch *m) {
+    PongInput input = (m->state.gameState != GAME_PLAYING) ? PONG_INPUT_SERVE : 0;
+    input |= pong_cpu_input(&m->cpus[0], &m->state);
+    input |= pong_cpu_input(&m->cpus[1], &m->state);
+    return input;
+}
+
+void pong_event_step(PongEventMatch *m) {
+    bool playing = m->state.gameState == GAME_PLAYING;
+    float vx = m->state.ball.velocity.x;
+    PongInput input = pong_event_input(m);
+#ifdef PONG_FIXED_POINT
+    pong_step(&m->state, input, PONG_TICK_DT);
+#else
+    pong_rules_step(&m->state, input, PONG_TICK_DT, &m->rules);
+#endif
+
+    if (playing && m->state.gameState == GAME_PLAYING && (vx > 0.0f) != (m->state.ball.velocity.x > 0.0f)) m->hits++;
+    m->tick++;
+    m->stepped++;
+}
+
+#ifdef PONG_FIXED_POINT
+
+static float PaddleSpeed(const PongEventMatch *m) {
+    (void)m;
+    return PADDLE_SPEED;
+}
+
+// n ticks of the fixed rules' ball.x += travel(v, dt): the travel is the same integer every tick
+static float BallAdvance(float x, float v, uint64_t n) {
+    PongFixed step = pong_fixed_travel(pong_fixed_from_float(v), pong_fixed_time(PONG_TICK_DT));
+    return pong_fixed_to_float(pong_fixed_from_float(x) + (PongFixed)n * step);
+}
+
+static float PaddleAdvance(float y, float speed, int direction, uint64_t n) {
+    PongFixed step = pong_fixed_travel(pong_fixed_from_float(speed), pong_fixed_time(PONG_TICK_DT));
+    return pong_fixed_to_float(pong_fixed_from_float(y) + direction * (PongFixed)n * step);
+}
+
+#else
+
+static float PaddleSpeed(const PongEventMatch *m) {
+    return m->rules.paddleSpeed;
+}
+
+// x after n rounds of x = x + d in float, the same bits the loop would produce.
+// While x + d stays inside one binade it lands on that binade's grid of ulp u,
+// so every round adds d rounded to a multiple of u: an exact arithmetic run,
+// taken in one go. Only a d exactly halfway between two multiples (where
+// rounding to even depends on x) and binade changes are stepped singly.
+static float RepeatAdd(float x, float d, uint64_t n) {
+    while (n > 0) {
+        x = x + d;
+        n--;
+        if (n == 0 || x == 0.0f) continue;
+
+        int e;
+        frexpf(fabsf(x), &e);                           // |x| in [2^(e-1), 2^e)
+        double lo = ldexp(1.0, e - 1), hi = ldexp(1.0, e), u = ldexp(1.0, e - 24);
+        double q = (double)d / u;
+        if (q - floor(q) == 0.5) continue;
+        double inc = (q >= 0.0) ? floor(q + 0.5) * u : -floor(0.5 - q) * u;
+        if (inc == 0.0) return x;                       // d is under half an ulp: x is stuck
+
+        // Rounds whose exact sum stays at least half an ulp inside the binade
+        double a = fabs((double)x), step = (x > 0.0f) ? inc : -inc;
+        double room = (step > 0.0) ? (hi - u - a) / step : (a - lo - u) / -step;
+        if (room < 1.0) continue;
+        uint64_t k = (room < (double)n) ? (uint64_t)room : n;
+        x = (float)((double)x + (double)k * inc);
+        n -= k;
+    }
+    return x;
+}
+
+static float BallAdvance(float x, float v, uint64_t n) {
+    return RepeatAdd(x, v * PONG_TICK_DT, n);
+}
+
+static float PaddleAdvance(float y, float speed, int direction, uint64_t n) {
+    return RepeatAdd(y, (float)direction * (speed * PONG_TICK_DT), n);
+}
+
+#endif
+
+// Whole ticks a body at `perTick` can travel before coming within the safety margin of gap
+static uint64_t TicksClear(double gap, double perTick) {
+    if (perTick <= 0.0) return UINT64_MAX;
+    double ticks = floor(gap / perTick) - SAFETY_TICKS;
+    return (ticks > 0.0) ? (uint64_t)ticks : 0;
+}
+
+static uint64_t Min(uint64_t a, uint64_t b) {
+    return (a < b) ? a : b;
+}
+
+// -1 up, +1 down, 0 still, for the keys the CPU holds right now
+static int PaddleDirection(const PongCpu *cpu, const PongState *state) {
+    PongInput keys = pong_cpu_keys(cpu, state);
+    if (keys & (PONG_INPUT_P1_UP | PONG_INPUT_P2_UP)) return -1;
+    if (keys & (PONG_INPUT_P1_DOWN | PONG_INPUT_P2_DOWN)) return 1;
+    return 0;
+}
+
+// Ticks that can pass with the same keys and no contact, reaction or arrival
+static uint64_t QuietTicks(const PongEventMatch *m) {
+    const PongState *s = &m->state;
+    if (s->gameState != GAME_PLAYING) return 0;
+
+    const Ball *ball = &s->ball;
+    double r = ball->radius, dt = PONG_TICK_DT;
+    double vx = ball->velocity.x, vy = ball->velocity.y;
+
+    // The ball must stay clear of the paddle face it flies towards, and of the wall
+    double gap = (vx > 0.0) ? (s->player2.position.x - r) - ball->position.x
+                            : ball->position.x - (s->player1.position.x + s->player1.size.x + r);
+    uint64_t quiet = TicksClear(gap, fabs(vx) * dt);
+    if (vy != 0.0) quiet = Min(quiet, TicksClear((vy > 0.0) ? (ARENA_HEIGHT - r) - ball->position.y : ball->position.y - r, fabs(vy) * dt));
+
+    double paddleStep = PaddleSpeed(m) * dt;
+    for (int p = 0; p < 2 && quiet > 0; p++) {
+        const PongCpu *cpu = &m->cpus[p];
+        const Paddle *paddle = p ? &s->player2 : &s->player1;
+
+        // A course the CPU has not seen yet, or a reaction coming due, is stepped
+        if (cpu->seenVelocity.x == 0.0f || (ball->velocity.x > 0.0f) != (cpu->seenVelocity.x > 0.0f)) return 0;
+        if (cpu->reactIn >= 0) quiet = Min(quiet, (uint64_t)cpu->reactIn);
+
+        // A moving paddle keeps its keys until it nears its target or the edge; pinned at the edge it is still
+        double y = paddle->position.y, center = y + paddle->size.y * 0.5, bottom = ARENA_HEIGHT - paddle->size.y;
+        int direction = PaddleDirection(cpu, s);
+        if (direction < 0 && y > 0.0) {
+            quiet = Min(quiet, TicksClear(center - (cpu->target + PONG_CPU_DEAD_ZONE), paddleStep));
+            quiet = Min(quiet, TicksClear(y, paddleStep));
+        } else if (direction > 0 && y < bottom) {
+            quiet = Min(quiet, TicksClear((cpu->target - PONG_CPU_DEAD_ZONE) - center, paddleStep));
+            quiet = Min(quiet, TicksClear(bottom - y, paddleStep));
+        }
+    }
+    return quiet;
+}
+
+static void Skip(PongEventMatch *m, uint64_t n) {
+    PongState *s = &m->state;
+    for (int p = 0; p < 2; p++) {
+        PongCpu *cpu = &m->cpus[p];
+        Paddle *paddle = p ? &s->player2 : &s->player1;
+        int direction = PaddleDirection(cpu, s);
+        bool pinned = (direction < 0 && paddle->position.y <= 0.0f) || (direction > 0 && paddle->position.y >= ARENA_HEIGHT - paddle->size.y);
+        if (direction != 0 && !pinned) paddle->position.y = PaddleAdvance(paddle->position.y, PaddleSpeed(m), direction, n);
+        if (cpu->reactIn >= 0) cpu->reactIn -= (int)n;
+    }
+
+    s->ball.position.x = BallAdvance(s->ball.position.x, s->ball.velocity.x, n);
+    s->ball.position.y = BallAdvance(s->ball.position.y, s->ball.velocity.y, n);
+    m->tick += n;
+    m->skipped += n;
+    m->jumps++;
+}
+
+// Skips never score, so only a stepped tick can end the point
+static bool Run(PongEventMatch *m, uint64_t until, bool toPoint) {
+    int points = m->state.score1 + m->state.score2;
+    while (m->tick < until && m->state.gameState != GAME_OVER) {
+        uint64_t quiet = Min(QuietTicks(m), until - m->tick);
+        if (quiet > 0) {
+            Skip(m, quiet);
+            continue;
+        }
+        pong_event_step(m);
+        if (toPoint && m->state.score1 + m->state.score2 != points) return true;
+    }
+    return toPoint ? false : m->state.gameState == GAME_OVER;
+}
+
+bool pong_event_run(PongEventMatch *m, uint64_t until) {
+    return Run(m, until, false);
+}
+
+bool pong_event_run_point(PongEventMatch *m, uint64_t until) {
+    return Run(m, until, true);
+}
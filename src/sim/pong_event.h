@@ -0,0 +1,62 @@
+#ifndef PONG_EVENT_H
+#define PONG_EVENT_H
+
+#include "pong_ai.h"
+
+/*
+*  Event-driven matches
+*  ----------------------------------------------------------------------------------
+*  Most ticks of a rally change nothing but positions: the ball flies straight,
+*  the paddles walk towards where their players want them, and no key changes.
+*  This engine plays CPU-vs-CPU matches (src/sim/pong_ai.h; serves are pressed
+*  at once) by working out, in closed form, how many ticks can pass before
+*  anything else could happen - a wall or paddle coming within reach, a paddle
+*  arriving or a CPU reacting - and skipping straight over them. Only the ticks
+*  around those events run pong_step(), a handful per rally instead of hundreds.
+*
+*  The results are the fixed-step results bit for bit, not an approximation:
+*  a float stretch repeats x += d, which within one binade of x is an exact
+*  arithmetic sequence, so the skip walks it one binade at a time; fixed-point
+*  builds (-DPONG_FIXED_POINT) just multiply the per-tick travel.
+*
+*  PongEventMatch m;
+*  pong_event_init(&m, seed, pong_cpu_levels[0].config, pong_cpu_levels[2].config, cpuSeed);
+*  pong_event_run(&m, UINT64_MAX);                    // to the end of the match
+*  m.state.score1, m.state.score2, m.tick
+*
+*  pong_event_step() is one tick the ordinary way; any mix of the two lands on the
+*  same states. Float builds play m.rules (pong_default_rules after init), which
+*  a tuning sweep may change before the first step; fixed-point builds always
+*  play the built-in constants.
+*/
+
+typedef struct {
+    PongState state;
+    PongCpu cpus[2];                // Player 1, player 2
+    PongRules rules;
+    uint64_t tick;
+
+    // Counters
+    uint64_t stepped;               // Ticks run through pong_step()
+    uint64_t skipped;               // Ticks jumped over
+    uint64_t jumps;
+    uint64_t hits;                  // Paddle hits so far
+} PongEventMatch;
+
+void pong_event_init(PongEventMatch *m, uint64_t seed, PongCpuConfig player1, PongCpuConfig player2, uint64_t cpuSeed);
+
+// This tick's input: SERVE whenever the ball is not in play, plus both CPUs' keys.
+PongInput pong_event_input(PongEventMatch *m);
+
+// One tick of pong_step() with that input.
+void pong_event_step(PongEventMatch *m);
+
+// Advance to tick `until`, or until the match is over, skipping every quiet
+// stretch. Returns true if the match is over.
+bool pong_event_run(PongEventMatch *m, uint64_t until);
+
+// The same, but also stopping right after the next point is scored. Returns true
+// if one was.
+bool pong_event_run_point(PongEventMatch *m, uint64_t until);
+
+#endif // PONG_EVENT_H
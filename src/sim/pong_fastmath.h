@@ -0,0 +1,56 @@
+#ifndef PONG_FASTMATH_H
+#define PONG_FASTMATH_H
+
+/*
+*  Fast trig for deflections and serves
+*  ----------------------------------------------------------------------------------
+*  Paddle deflections stay within +-MAX_DEFLECTION_ANGLE and serves within +-20
+*  degrees, so direction vectors only ever need sin/cos on [-PI/2, PI/2]. Odd/even
+*  polynomials fitted on that interval are within 1.5e-7 of the true values (about
+*  one float ulp), so the resulting (cos, sin) is already unit length to float
+*  precision and needs no normalising either.
+*
+*  Plain multiplies and adds only: the SIMD kernels evaluate the same Horner steps
+*  and get the same bits. Build with -DPONG_LIBM_TRIG to go back to cosf/sinf and
+*  Vector2Normalize (tools/pong_trig_bench.c compares the two).
+*/
+
+// sin(x) = x * S(x^2), degree 9
+#define PONG_SIN_C0  9.999999765e-01f
+#define PONG_SIN_C1 -1.666664760e-01f
+#define PONG_SIN_C2  8.332899263e-03f
+#define PONG_SIN_C3 -1.980086734e-04f
+#define PONG_SIN_C4  2.590433550e-06f
+
+// cos(x) = C(x^2), degree 10
+#define PONG_COS_C0  9.999999998e-01f
+#define PONG_COS_C1 -4.999999936e-01f
+#define PONG_COS_C2  4.166663618e-02f
+#define PONG_COS_C3 -1.388836054e-03f
+#define PONG_COS_C4  2.476012354e-05f
+#define PONG_COS_C5 -2.605090690e-07f
+
+// sin(x) for |x| <= PI/2
+static inline float pong_fast_sin(float x) {
+    float u = x * x;
+    float p = PONG_SIN_C4;
+    p = p * u + PONG_SIN_C3;
+    p = p * u + PONG_SIN_C2;
+    p = p * u + PONG_SIN_C1;
+    p = p * u + PONG_SIN_C0;
+    return p * x;
+}
+
+// cos(x) for |x| <= PI/2
+static inline float pong_fast_cos(float x) {
+    float u = x * x;
+    float p = PONG_COS_C5;
+    p = p * u + PONG_COS_C4;
+    p = p * u + PONG_COS_C3;
+    p = p * u + PONG_COS_C2;
+    p = p * u + PONG_COS_C1;
+    p = p * u + PONG_COS_C0;
+    return p;
+}
+
+#endif // PONG_FASTMATH_H
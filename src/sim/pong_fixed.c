@@ -0,0 +1,399 @@
+#include "pong_fixed.h"
+
+// Compile-time conversion of the float gameplay constants
+#define FX(x) ((PongFixed)((x) * PONG_FIXED_ONE))
+
+#define FX_RADIUS         FX(BALL_RADIUS)
+#define FX_ARENA_WIDTH    FX(ARENA_WIDTH)
+#define FX_ARENA_HEIGHT   FX(ARENA_HEIGHT)
+#define FX_PADDLE_WIDTH   FX(PADDLE_WIDTH)
+#define FX_PADDLE_HEIGHT  FX(PADDLE_HEIGHT)
+#define FX_PADDLE1_X      FX(PADDLE1_X)
+#define FX_PADDLE2_X      FX(PADDLE2_X)
+#define FX_PADDLE_SPEED   FX(PADDLE_SPEED)
+#define FX_SERVE_SPEED    FX(BALL_SERVE_SPEED)
+#define FX_MAX_SPEED      FX(BALL_MAX_SPEED)
+
+#define SPEED_INCREMENT_Q16  67502                  // 1.03 in Q16
+#define MAX_DEFLECTION_TURN  (75 * PONG_ANGLE_TURN / 360)
+
+// sin(i/256 * 90 degrees) in Q16, i = 0..256
+static const int32_t SineTable[257] = {
+        0,   402,   804,  1206,  1608,  2010,  2412,  2814,  3216,  3617,  4019,  4420,
+     4821,  5222,  5623,  6023,  6424,  6824,  7224,  7623,  8022,  8421,  8820,  9218,
+     9616, 10014, 10411, 10808, 11204, 11600, 11996, 12391, 12785, 13180, 13573, 13966,
+    14359, 14751, 15143, 15534, 15924, 16314, 16703, 17091, 17479, 17867, 18253, 18639,
+    19024, 19409, 19792, 20175, 20557, 20939, 21320, 21699, 22078, 22457, 22834, 23210,
+    23586, 23961, 24335, 24708, 25080, 25451, 25821, 26190, 26558, 26925, 27291, 27656,
+    28020, 28383, 28745, 29106, 29466, 29824, 30182, 30538, 30893, 31248, 31600, 31952,
+    32303, 32652, 33000, 33347, 33692, 34037, 34380, 34721, 35062, 35401, 35738, 36075,
+    36410, 36744, 37076, 37407, 37736, 38064, 38391, 38716, 39040, 39362, 39683, 40002,
+    40320, 40636, 40951, 41264, 41576, 41886, 42194, 42501, 42806, 43110, 43412, 43713,
+    44011, 44308, 44604, 44898, 45190, 45480, 45769, 46056, 46341, 46624, 46906, 47186,
+    47464, 47741, 48015, 48288, 48559, 48828, 49095, 49361, 49624, 49886, 50146, 50404,
+    50660, 50914, 51166, 51417, 51665, 51911, 52156, 52398, 52639, 52878, 53114, 53349,
+    53581, 53812, 54040, 54267, 54491, 54714, 54934, 55152, 55368, 55582, 55794, 56004,
+    56212, 56418, 56621, 56823, 57022, 57219, 57414, 57607, 57798, 57986, 58172, 58356,
+    58538, 58718, 58896, 59071, 59244, 59415, 59583, 59750, 59914, 60075, 60235, 60392,
+    60547, 60700, 60851, 60999, 61145, 61288, 61429, 61568, 61705, 61839, 61971, 62101,
+    62228, 62353, 62476, 62596, 62714, 62830, 62943, 63054, 63162, 63268, 63372, 63473,
+    63572, 63668, 63763, 63854, 63944, 64031, 64115, 64197, 64277, 64354, 64429, 64501,
+    64571, 64639, 64704, 64766, 64827, 64884, 64940, 64993, 65043, 65091, 65137, 65180,
+    65220, 65259, 65294, 65328, 65358, 65387, 65413, 65436, 65457, 65476, 65492, 65505,
+    65516, 65525, 65531, 65535, 65536,
+};
+
+typedef struct {
+    PongFixed x, y;
+} FixedVec;
+
+// The moving parts of a match; paddle x and all sizes are the fixed constants above
+typedef struct {
+    FixedVec ball;
+    FixedVec velocity;
+    PongFixed paddle1Y;
+    PongFixed paddle2Y;
+} Bodies;
+
+typedef enum {
+    SWEEP_NONE,
+    SWEEP_TOP,
+    SWEEP_BOTTOM,
+    SWEEP_PLAYER1,
+    SWEEP_PLAYER2
+} SweepEvent;
+
+int32_t pong_fixed_sin(int32_t angle) {
+    uint32_t a = (uint32_t)angle & (PONG_ANGLE_TURN - 1);
+    uint32_t quadrant = a >> 14;
+    uint32_t q = a & 0x3FFF;
+    if (quadrant & 1) q = 0x4000 - q;       // Falling half of each lobe mirrors the rising one
+
+    uint32_t i = q >> 6, frac = q & 63;
+    int32_t s = SineTable[i];
+    if (frac != 0) s += ((SineTable[i + 1] - SineTable[i]) * (int32_t)frac) >> 6;
+
+    return (quadrant & 2) ? -s : s;
+}
+
+int32_t pong_fixed_cos(int32_t angle) {
+    return pong_fixed_sin(angle + PONG_ANGLE_TURN / 4);
+}
+
+static uint64_t ISqrt(uint64_t n) {
+    uint64_t root = 0, bit = 1ull << 62;
+
+    while (bit > n) bit >>= 2;
+    while (bit != 0) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+static PongFixed Clampi(PongFixed v, PongFixed lo, PongFixed hi) {
+    return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+// Time for a body at speed v to cover distance (both Q20.12), truncated to the time grid
+static PongFixedTime TimeToCover(PongFixed distance, PongFixed v) {
+    return (PongFixedTime)distance * (1 << PONG_TIME_SHIFT) / v;
+}
+
+// A paddle key's travel this tick: all of it unless it was only down for part
+static PongFixed KeyTravel(PongInput input, PongInput key, PongFixed step) {
+    unsigned int missed = pong_input_missed(input, key);
+    return missed ? step * (PongFixed)(PONG_INPUT_PART_STEPS - missed) / PONG_INPUT_PART_STEPS : step;
+}
+
+static void MovePaddles(Bodies *b, PongInput input, PongFixedTime dt) {
+    PongFixed step = pong_fixed_travel(FX_PADDLE_SPEED, dt);
+
+    if (input & PONG_INPUT_P1_UP)   b->paddle1Y -= KeyTravel(input, PONG_INPUT_P1_UP, step);
+    if (input & PONG_INPUT_P1_DOWN) b->paddle1Y += KeyTravel(input, PONG_INPUT_P1_DOWN, step);
+    if (input & PONG_INPUT_P2_UP)   b->paddle2Y -= KeyTravel(input, PONG_INPUT_P2_UP, step);
+    if (input & PONG_INPUT_P2_DOWN) b->paddle2Y += KeyTravel(input, PONG_INPUT_P2_DOWN, step);
+
+    b->paddle1Y = Clampi(b->paddle1Y, 0, FX_ARENA_HEIGHT - FX_PADDLE_HEIGHT);
+    b->paddle2Y = Clampi(b->paddle2Y, 0, FX_ARENA_HEIGHT - FX_PADDLE_HEIGHT);
+}
+
+// Unit direction at a binary angle, scaled to speed; side flips the x component
+static FixedVec DirectionTimes(int32_t angle, int side, PongFixed speed) {
+    return (FixedVec){
+        (PongFixed)(((int64_t)side * pong_fixed_cos(angle) * speed) >> 16),
+        (PongFixed)(((int64_t)pong_fixed_sin(angle) * speed) >> 16),
+    };
+}
+
+// Same rule as the float DeflectOffPaddle(): angle from where the ball hit, speed up to the cap
+static void DeflectOffPaddle(Bodies *b, PongFixed paddleY, int side) {
+    PongFixed half = FX_PADDLE_HEIGHT / 2;
+    int64_t t = (int64_t)(b->ball.y - (paddleY + half)) * PONG_TRIG_ONE / half;
+    if (t < -PONG_TRIG_ONE) t = -PONG_TRIG_ONE;
+    if (t > PONG_TRIG_ONE) t = PONG_TRIG_ONE;
+
+    int32_t angle = (int32_t)(t * MAX_DEFLECTION_TURN / PONG_TRIG_ONE);
+
+    int64_t vx = b->velocity.x, vy = b->velocity.y;
+    PongFixed speed = (PongFixed)ISqrt((uint64_t)(vx * vx + vy * vy));
+    PongFixed newSpeed = (PongFixed)(((int64_t)speed * SPEED_INCREMENT_Q16) >> 16);
+    if (newSpeed > FX_MAX_SPEED) newSpeed = FX_MAX_SPEED;
+
+    b->velocity = DirectionTimes(angle, side, newSpeed);
+}
+
+static void HitPlayer1(Bodies *b) {
+    DeflectOffPaddle(b, b->paddle1Y, 1);
+    b->ball.x = FX_PADDLE1_X + FX_PADDLE_WIDTH + FX_RADIUS;
+}
+
+static void HitPlayer2(Bodies *b) {
+    DeflectOffPaddle(b, b->paddle2Y, -1);
+    b->ball.x = FX_PADDLE2_X - FX_RADIUS;
+}
+
+static bool BallTouchesPaddle(FixedVec ball, PongFixed paddleX, PongFixed paddleY) {
+    int64_t dx = ball.x - Clampi(ball.x, paddleX, paddleX + FX_PADDLE_WIDTH);
+    int64_t dy = ball.y - Clampi(ball.y, paddleY, paddleY + FX_PADDLE_HEIGHT);
+    return dx * dx + dy * dy < (int64_t)FX_RADIUS * FX_RADIUS;
+}
+
+// True when a body at p moving at v cannot enter the slab [lo, hi] within maxT,
+// decided by the slab test below (entry time truncated past maxT, or v = 0 and
+// outside) without dividing. Only asks when every product fits 64 bits.
+static bool OutOfReach(PongFixed p, PongFixed v, PongFixed lo, PongFixed hi, PongFixedTime maxT) {
+    if (maxT >= ((PongFixedTime)1 << 31)) return false;
+
+    int64_t gap;
+    if (p < lo && v >= 0) gap = (int64_t)lo - p;
+    else if (p > hi && v <= 0) gap = (int64_t)p - hi;
+    else return false;
+
+    int64_t speed = (v < 0) ? -(int64_t)v : v;
+    return gap * (1 << PONG_TIME_SHIFT) > speed * (maxT + 1);
+}
+
+// Integer twin of the float SweepCircleRect(): slab test on the paddle grown by
+// the radius, corner approaches re-solved against the corner circle.
+static PongFixedTime SweepCircleRect(FixedVec p, FixedVec v, PongFixed rectX, PongFixed rectY, PongFixedTime maxT) {
+    PongFixed minX = rectX - FX_RADIUS, maxX = rectX + FX_PADDLE_WIDTH + FX_RADIUS;
+    PongFixed minY = rectY - FX_RADIUS, maxY = rectY + FX_PADDLE_HEIGHT + FX_RADIUS;
+    PongFixedTime tEnter = INT64_MIN, tExit = INT64_MAX;
+
+    // Most calls are for a ball nowhere near the paddle: skip the divisions
+    if (OutOfReach(p.x, v.x, minX, maxX, maxT) || OutOfReach(p.y, v.y, minY, maxY, maxT)) return -1;
+
+    if (v.x != 0) {
+        PongFixedTime t1 = TimeToCover(minX - p.x, v.x), t2 = TimeToCover(maxX - p.x, v.x);
+        PongFixedTime lo = (t1 < t2) ? t1 : t2, hi = (t1 < t2) ? t2 : t1;
+        if (lo > tEnter) tEnter = lo;
+        if (hi < tExit) tExit = hi;
+    } else if (p.x < minX || p.x > maxX) return -1;
+
+    if (v.y != 0) {
+        PongFixedTime t1 = TimeToCover(minY - p.y, v.y), t2 = TimeToCover(maxY - p.y, v.y);
+        PongFixedTime lo = (t1 < t2) ? t1 : t2, hi = (t1 < t2) ? t2 : t1;
+        if (lo > tEnter) tEnter = lo;
+        if (hi < tExit) tExit = hi;
+    } else if (p.y < minY || p.y > maxY) return -1;
+
+    if (tEnter > tExit || tExit < 0 || tEnter > maxT) return -1;
+    if (tEnter < 0) tEnter = 0;
+
+    FixedVec c = { p.x + pong_fixed_travel(v.x, tEnter), p.y + pong_fixed_travel(v.y, tEnter) };
+    bool withinX = (c.x >= rectX && c.x <= rectX + FX_PADDLE_WIDTH);
+    bool withinY = (c.y >= rectY && c.y <= rectY + FX_PADDLE_HEIGHT);
+    if (withinX || withinY) return tEnter;
+
+    // Corner region. The quadratic is solved at reduced precision (offsets in
+    // 1/64 px, speeds in 1/4 px/s) so every product fits in 64 bits for steps up to 1 s.
+    FixedVec corner = { (c.x < rectX) ? rectX : rectX + FX_PADDLE_WIDTH,
+                        (c.y < rectY) ? rectY : rectY + FX_PADDLE_HEIGHT };
+    int64_t dx = (p.x - corner.x) >> 6, dy = (p.y - corner.y) >> 6;
+    int64_t vx = v.x >> 10, vy = v.y >> 10;
+    int64_t r = FX_RADIUS >> 6;
+    int64_t a = vx * vx + vy * vy;
+    int64_t b = dx * vx + dy * vy;
+    int64_t k = dx * dx + dy * dy - r * r;
+    int64_t disc = b * b - a * k;
+    if (k <= 0) return tEnter;
+    if (a == 0 || b >= 0 || disc < 0) return -1;
+
+    PongFixedTime t = (-b - (int64_t)ISqrt((uint64_t)disc)) * (1 << 20) / a;
+    if (t < tEnter) t = tEnter;
+    return (t <= maxT) ? t : -1;
+}
+
+// Walls always; the paddles only when the ball can reach them (see pong_fixed_step_open())
+static void SweepBall(Bodies *b, PongFixedTime dt, bool paddles) {
+    if (paddles && b->velocity.x < 0 && BallTouchesPaddle(b->ball, FX_PADDLE1_X, b->paddle1Y)) HitPlayer1(b);
+    if (paddles && b->velocity.x > 0 && BallTouchesPaddle(b->ball, FX_PADDLE2_X, b->paddle2Y)) HitPlayer2(b);
+
+    PongFixedTime remaining = dt;
+
+    for (int events = 0; events < PONG_MAX_SWEEP_EVENTS; events++) {
+        PongFixedTime hitTime = remaining;
+        SweepEvent event = SWEEP_NONE;
+
+        if (b->velocity.y < 0) {
+            PongFixedTime t = TimeToCover(FX_RADIUS - b->ball.y, b->velocity.y);
+            if (t < 0) t = 0;
+            if (t <= hitTime) { hitTime = t; event = SWEEP_TOP; }
+        }
+        if (b->velocity.y > 0) {
+            PongFixedTime t = TimeToCover(FX_ARENA_HEIGHT - FX_RADIUS - b->ball.y, b->velocity.y);
+            if (t < 0) t = 0;
+            if (t <= hitTime) { hitTime = t; event = SWEEP_BOTTOM; }
+        }
+        if (paddles && b->velocity.x < 0) {
+            PongFixedTime t = SweepCircleRect(b->ball, b->velocity, FX_PADDLE1_X, b->paddle1Y, hitTime);
+            if (t >= 0) { hitTime = t; event = SWEEP_PLAYER1; }
+        }
+        if (paddles && b->velocity.x > 0) {
+            PongFixedTime t = SweepCircleRect(b->ball, b->velocity, FX_PADDLE2_X, b->paddle2Y, hitTime);
+            if (t >= 0) { hitTime = t; event = SWEEP_PLAYER2; }
+        }
+
+        b->ball.x += pong_fixed_travel(b->velocity.x, hitTime);
+        b->ball.y += pong_fixed_travel(b->velocity.y, hitTime);
+        remaining -= hitTime;
+
+        switch (event) {
+            case SWEEP_NONE:
+                return;
+            case SWEEP_TOP:
+                b->ball.y = FX_RADIUS;
+                b->velocity.y = -b->velocity.y;
+                break;
+            case SWEEP_BOTTOM:
+                b->ball.y = FX_ARENA_HEIGHT - FX_RADIUS;
+                b->velocity.y = -b->velocity.y;
+                break;
+            case SWEEP_PLAYER1:
+                HitPlayer1(b);
+                break;
+            case SWEEP_PLAYER2:
+                HitPlayer2(b);
+                break;
+        }
+    }
+
+    b->ball.x += pong_fixed_travel(b->velocity.x, remaining);
+    b->ball.y = Clampi(b->ball.y + pong_fixed_travel(b->velocity.y, remaining), FX_RADIUS, FX_ARENA_HEIGHT - FX_RADIUS);
+}
+
+static void UpdatePlaying(PongState *state, Bodies *b, PongInput input, PongFixedTime dt) {
+    if (input & PONG_INPUT_PAUSE) {
+        state->gameState = GAME_PAUSE;
+        return;
+    }
+
+    MovePaddles(b, input, dt);
+    SweepBall(b, dt, true);
+
+    if (b->ball.x + FX_RADIUS < 0) {
+        state->score2++;
+        if (state->score2 >= WINNING_SCORE) {
+            state->gameState = GAME_OVER;
+            return;
+        }
+        state->serveDirection = 1;
+        state->serveJustHappened = true;
+        state->gameState = GAME_SERVE;
+    }
+
+    if (b->ball.x - FX_RADIUS > FX_ARENA_WIDTH) {
+        state->score1++;
+        if (state->score1 >= WINNING_SCORE) {
+            state->gameState = GAME_OVER;
+            return;
+        }
+        state->serveDirection = -1;
+        state->serveJustHappened = true;
+        state->gameState = GAME_SERVE;
+    }
+}
+
+// Clear of the paddle columns at both ends means clear for the whole step: x moves
+// one way, and with a margin of at least |v| / 2^24 units every paddle sweep's
+// entry time, truncated, still lands after the time it is asked about.
+bool pong_fixed_step_open(PongFixedBodies *bodies, PongInput input, PongFixedTime dt, PongFixed margin) {
+    PongFixed leftX = FX_PADDLE1_X + FX_PADDLE_WIDTH + FX_RADIUS + margin;
+    PongFixed rightX = FX_PADDLE2_X - FX_RADIUS - margin;
+    if (bodies->ballX <= leftX || bodies->ballX >= rightX) return false;
+
+    Bodies b = {
+        .ball = { bodies->ballX, bodies->ballY },
+        .velocity = { bodies->velocityX, bodies->velocityY },
+        .paddle1Y = bodies->paddle1Y,
+        .paddle2Y = bodies->paddle2Y,
+    };
+    MovePaddles(&b, input, dt);
+    SweepBall(&b, dt, false);
+    if (b.ball.x <= leftX || b.ball.x >= rightX) return false;
+
+    *bodies = (PongFixedBodies){ b.ball.x, b.ball.y, b.velocity.x, b.velocity.y, b.paddle1Y, b.paddle2Y };
+    return true;
+}
+
+void pong_fixed_step(PongState *state, PongInput input, float dt) {
+    PongFixedTime t = pong_fixed_time(dt);
+    Bodies b = {
+        .ball = { pong_fixed_from_float(state->ball.position.x), pong_fixed_from_float(state->ball.position.y) },
+        .velocity = { pong_fixed_from_float(state->ball.velocity.x), pong_fixed_from_float(state->ball.velocity.y) },
+        .paddle1Y = pong_fixed_from_float(state->player1.position.y),
+        .paddle2Y = pong_fixed_from_float(state->player2.position.y),
+    };
+
+    switch (state->gameState) {
+        case GAME_START:
+            if (input & PONG_INPUT_SERVE) {
+                state->serveJustHappened = true;
+                state->gameState = GAME_SERVE;
+            }
+            break;
+        case GAME_SERVE:
+            if (state->serveJustHappened) {
+                b.ball = (FixedVec){ FX_ARENA_WIDTH / 2, FX_ARENA_HEIGHT / 2 };
+                b.velocity = (FixedVec){ 0, 0 };
+                state->serveJustHappened = false;
+            }
+
+            MovePaddles(&b, input, t);
+
+            if (input & PONG_INPUT_SERVE) {
+                int32_t angle = pong_random_value(state, -20, 20) * PONG_ANGLE_TURN / 360;
+                b.velocity = DirectionTimes(angle, state->serveDirection, FX_SERVE_SPEED);
+                state->gameState = GAME_PLAYING;
+            }
+            break;
+        case GAME_PLAYING:
+            UpdatePlaying(state, &b, input, t);
+            break;
+        case GAME_PAUSE:
+            if (input & PONG_INPUT_PAUSE) {
+                state->gameState = GAME_PLAYING;
+            }
+            break;
+        case GAME_OVER:
+            if (input & PONG_INPUT_SERVE) {
+                state->score1 = 0;
+                state->score2 = 0;
+                state->serveDirection = (pong_random_value(state, 0, 1) == 0) ? -1 : 1;
+                state->gameState = GAME_START;
+            }
+            break;
+    }
+
+    state->ball.position = (Vector2){ pong_fixed_to_float(b.ball.x), pong_fixed_to_float(b.ball.y) };
+    state->ball.velocity = (Vector2){ pong_fixed_to_float(b.velocity.x), pong_fixed_to_float(b.velocity.y) };
+    state->player1.position.y = pong_fixed_to_float(b.paddle1Y);
+    state->player2.position.y = pong_fixed_to_float(b.paddle2Y);
+}
@@ -0,0 +1,67 @@
+#ifndef PONG_FIXED_H
+#define PONG_FIXED_H
+
+#include <stdint.h>
+
+#include "pong.h"
+
+/*
+*  Fixed-point simulation
+*  ----------------------------------------------------------------------------------
+*  The same rules as pong_step(), computed with integers only: no libm trig, no
+*  float rounding, so every compiler and CPU produces the same bits. Build with
+*  -DPONG_FIXED_POINT and pong_step() (and the batch) runs this path.
+*
+*  Lengths and speeds are Q20.12 (1/4096 px). Every value that fits the arena is
+*  exactly representable as a float, so PongState keeps its float fields: they
+*  hold fixed-point values converted without rounding, and the renderer, replays
+*  and snapshots never need to know which mode produced them.
+*
+*  Time is Q40.24 seconds, angles are binary (65536 per turn) and directions come
+*  from a quarter-wave sine table with linear interpolation.
+*/
+
+typedef int32_t PongFixed;          // Q20.12 px or px/s
+typedef int64_t PongFixedTime;      // Q40.24 s
+
+#define PONG_FIXED_SHIFT    12
+#define PONG_FIXED_ONE      (1 << PONG_FIXED_SHIFT)
+#define PONG_TIME_SHIFT     24
+#define PONG_TRIG_ONE       65536   // sin/cos results are Q16
+#define PONG_ANGLE_TURN     65536   // Binary angle units per full turn
+
+// Exact in both directions for any value the simulation produces (|x| < 4096 px)
+static inline PongFixed pong_fixed_from_float(float f) { return (PongFixed)(f * (float)PONG_FIXED_ONE); }
+static inline float pong_fixed_to_float(PongFixed x) { return (float)x * (1.0f / PONG_FIXED_ONE); }
+
+// Step length dt is truncated to the time grid (1/240 s loses 0.000001 %)
+static inline PongFixedTime pong_fixed_time(float dt) { return (PongFixedTime)(dt * (float)(1 << PONG_TIME_SHIFT)); }
+
+// Distance covered at speed v in time t. Floors (arithmetic shift) like every
+// two's-complement target we build for.
+static inline PongFixed pong_fixed_travel(PongFixed v, PongFixedTime t) {
+    return (PongFixed)(((int64_t)v * t) >> PONG_TIME_SHIFT);
+}
+
+// Sine and cosine (Q16) of a binary angle.
+int32_t pong_fixed_sin(int32_t angle);
+int32_t pong_fixed_cos(int32_t angle);
+
+// The moving parts of a match
+typedef struct {
+    PongFixed ballX, ballY;
+    PongFixed velocityX, velocityY;
+    PongFixed paddle1Y, paddle2Y;
+} PongFixedBodies;
+
+// pong_step() computed in fixed point. State floats are read as Q20.12 and
+// written back exactly.
+void pong_fixed_step(PongState *state, PongInput input, float dt);
+
+// One step of GAME_PLAYING (no pause key) for a ball that stays more than margin
+// (at least 1/32 px) clear of both paddle columns: the paddles move and the ball
+// flies and bounces off the walls, exactly as pong_fixed_step() would. Returns
+// false, leaving bodies as they were, when the ball comes closer than that.
+bool pong_fixed_step_open(PongFixedBodies *bodies, PongInput input, PongFixedTime dt, PongFixed margin);
+
+#endif // PONG_FIXED_H
@@ -0,0 +1,76 @@
+#include "pong_input.h"
+
+#define PADDLE_KEYS (PONG_INPUT_P1_UP | PONG_INPUT_P1_DOWN | PONG_INPUT_P2_UP | PONG_INPUT_P2_DOWN)
+#define INDEX_MASK  (PONG_KEYLOG_SIZE - 1u)
+
+static const PongInput paddleKeys[4] = { PONG_INPUT_P1_UP, PONG_INPUT_P1_DOWN, PONG_INPUT_P2_UP, PONG_INPUT_P2_DOWN };
+
+static int KeyIndex(PongInput key) {
+    int k = 0;
+    while (k < 3 && paddleKeys[k] != key) k++;
+    return k;
+}
+
+void pong_keylog_init(PongKeyLog *log) {
+    atomic_init(&log->head, 0u);
+    atomic_init(&log->tail, 0u);
+    log->held = 0;
+}
+
+bool pong_keylog_push(PongKeyLog *log, double time, PongInput key, bool down) {
+    unsigned int head = atomic_load_explicit(&log->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&log->tail, memory_order_acquire) == PONG_KEYLOG_SIZE) return false;
+
+    log->events[head & INDEX_MASK] = (PongKeyEvent){ time, key, down };
+    // Release: the event is written before the consumer can see it
+    atomic_store_explicit(&log->head, head + 1, memory_order_release);
+    return true;
+}
+
+PongInput pong_keylog_tick(PongKeyLog *log, double start, double end) {
+    double downFor[4] = { 0 };
+    double from[4] = { start, start, start, start };    // Since when each key has been in its state
+    PongInput input = 0;
+
+    unsigned int tail = atomic_load_explicit(&log->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&log->head, memory_order_acquire);
+    for (; tail != head; tail++) {
+        const PongKeyEvent *event = &log->events[tail & INDEX_MASK];
+        if (event->time >= end) break;
+
+        if (!(event->key & PADDLE_KEYS)) {
+            if (event->down) input |= event->key;
+            continue;
+        }
+
+        int k = KeyIndex(event->key);
+        double at = (event->time > start) ? event->time : start;
+        if ((log->held & event->key) && at > from[k]) {
+            downFor[k] += at - from[k];
+            input |= event->key;        // Down for the start of the tick
+        }
+        from[k] = at;
+        if (event->down) {
+            log->held |= event->key;
+            input |= event->key;        // Even if it is up again by the end: a tap still moves
+        } else {
+            log->held &= ~event->key;
+        }
+    }
+    atomic_store_explicit(&log->tail, tail, memory_order_release);
+
+    // Each key's share of the tick, in the sixteenths pong_step() takes
+    for (int k = 0; k < 4; k++) {
+        PongInput key = paddleKeys[k];
+        if (log->held & key) {
+            downFor[k] += end - from[k];
+            input |= key;
+        }
+        if (!(input & key)) continue;
+
+        int parts = (int)(downFor[k] / (end - start) * PONG_INPUT_PART_STEPS + 0.5);
+        if (parts < 1) parts = 1;
+        if (parts < PONG_INPUT_PART_STEPS) input = pong_input_with_missed(input, key, (unsigned int)(PONG_INPUT_PART_STEPS - parts));
+    }
+    return input;
+}
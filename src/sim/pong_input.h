@@ -0,0 +1,50 @@
+#ifndef PONG_INPUT_H
+#define PONG_INPUT_H
+
+#include <stdatomic.h>
+
+#include "pong.h"
+
+/*
+*  Timestamped key events
+*  ----------------------------------------------------------------------------------
+*  The window thread polls the keyboard far more often than it draws and logs every
+*  press and release it sees with its pong_clock_now() time; the simulation thread
+*  turns the log into one PongInput per tick. A paddle key that changed during a
+*  tick only covers the part of the tick it was really down (the sub-tick fields in
+*  pong.h), so a press moves the paddle from the moment it was seen instead of from
+*  the next frame, and a release stops it there. SERVE and PAUSE act on the tick
+*  their press falls in.
+*
+*  Lock-free, one producer thread and one consumer thread:
+*
+*  pong_keylog_push(&log, pong_clock_now(), PONG_INPUT_P1_UP, true);     // window thread
+*  PongInput input = pong_keylog_tick(&log, tickStart, tickEnd);         // simulation thread, per tick
+*/
+
+#define PONG_KEYLOG_SIZE 256        // Events in flight; a power of two
+
+typedef struct {
+    double time;                    // pong_clock_now() when the change was seen
+    PongInput key;                  // A single key bit
+    bool down;
+} PongKeyEvent;
+
+typedef struct {
+    PongKeyEvent events[PONG_KEYLOG_SIZE];
+    _Alignas(64) _Atomic unsigned int head;     // Producer: events pushed so far
+    _Alignas(64) _Atomic unsigned int tail;     // Consumer: events applied so far
+    _Alignas(64) PongInput held;                // Consumer: paddle keys down where the last tick ended
+} PongKeyLog;
+
+void pong_keylog_init(PongKeyLog *log);
+
+// Producer: log that key went down or up at time (never earlier than the last
+// push). False if the log is full; the event is dropped.
+bool pong_keylog_push(PongKeyLog *log, double time, PongInput key, bool down);
+
+// Consumer: input for the tick covering [start, end), taking every event before
+// end. Events older than start (a tick that ran late) count from start.
+PongInput pong_keylog_tick(PongKeyLog *log, double start, double end);
+
+#endif // PONG_INPUT_H
@@ -0,0 +1,198 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pong_link.h"
+#include "pong_rng.h"
+
+const PongLinkProfile pong_link_profiles[] = {
+    //  name             delay  jitter  loss  burst  dup   reorder hold  spike every/ms/delay
+    { "lan",             0.3f,  0.1f,   0.0f, 1.0f,  0.0f, 0.0f,   0.0f, 0.0f,    0.0f,   0.0f },
+    { "cable",           12.0f, 2.0f,   0.1f, 1.0f,  0.0f, 0.0f,   0.0f, 0.0f,    0.0f,   0.0f },
+    { "transatlantic",   45.0f, 3.0f,   0.5f, 2.0f,  0.0f, 0.2f,   5.0f, 0.0f,    0.0f,   0.0f },
+    { "bad-wifi",        6.0f,  12.0f,  4.0f, 3.0f,  1.0f, 3.0f,  15.0f, 4000.0f, 250.0f, 120.0f },
+    { "mobile",          35.0f, 20.0f,  2.0f, 4.0f,  0.5f, 1.0f,  20.0f, 7000.0f, 500.0f, 200.0f },
+};
+const int pong_link_profile_count = (int)(sizeof(pong_link_profiles) / sizeof(pong_link_profiles[0]));
+
+typedef struct {
+    const char *key;
+    size_t offset;
+} ProfileKey;
+
+static const ProfileKey profileKeys[] = {
+    { "delay", offsetof(PongLinkProfile, delayMs) },
+    { "jitter", offsetof(PongLinkProfile, jitterMs) },
+    { "loss", offsetof(PongLinkProfile, loss) },
+    { "burst", offsetof(PongLinkProfile, burst) },
+    { "dup", offsetof(PongLinkProfile, duplicate) },
+    { "reorder", offsetof(PongLinkProfile, reorder) },
+    { "hold", offsetof(PongLinkProfile, holdMs) },
+    { "spike_every", offsetof(PongLinkProfile, spikeEveryMs) },
+    { "spike_ms", offsetof(PongLinkProfile, spikeMs) },
+    { "spike_delay", offsetof(PongLinkProfile, spikeDelayMs) },
+};
+
+static bool ParseNumber(const char *text, float *value) {
+    char *end;
+    *value = strtof(text, &end);
+    return end != text && *end == '\0' && *value >= 0.0f;
+}
+
+// One step: "name", "name,key=value,...", "key=value,..." - optionally "@seconds"
+static bool ParseStep(char *text, PongLinkProfile *profile, float *seconds) {
+    *seconds = 10.0f;
+    char *at = strchr(text, '@');
+    if (at) {
+        *at = '\0';
+        if (!ParseNumber(at + 1, seconds) || *seconds <= 0.0f) return false;
+    }
+
+    *profile = (PongLinkProfile){ .name = "custom", .burst = 1.0f };
+    char *token = text;
+    for (bool first = true; token; first = false) {
+        char *comma = strchr(token, ',');
+        if (comma) *comma = '\0';
+
+        char *equals = strchr(token, '=');
+        if (!equals) {
+            // Only the first token may name a profile
+            int p = 0;
+            while (p < pong_link_profile_count && strcmp(pong_link_profiles[p].name, token) != 0) p++;
+            if (!first || p == pong_link_profile_count) return false;
+            *profile = pong_link_profiles[p];
+        } else {
+            *equals = '\0';
+            size_t k = 0, keyCount = sizeof(profileKeys) / sizeof(profileKeys[0]);
+            while (k < keyCount && strcmp(profileKeys[k].key, token) != 0) k++;
+            if (k == keyCount || !ParseNumber(equals + 1, (float *)((char *)profile + profileKeys[k].offset))) return false;
+        }
+        token = comma ? comma + 1 : NULL;
+    }
+    return profile->loss <= 100.0f && profile->burst >= 1.0f;
+}
+
+bool pong_link_parse(const char *text, PongLinkScript *script) {
+    *script = (PongLinkScript){ 0 };
+    while (*text) {
+        char step[128];
+        size_t length = strcspn(text, "/");
+        if (script->count == PONG_LINK_STEPS || length >= sizeof(step)) return false;
+        memcpy(step, text, length);
+        step[length] = '\0';
+        if (!ParseStep(step, &script->steps[script->count], &script->seconds[script->count])) return false;
+        script->count++;
+
+        text += length;
+        if (*text == '/') text++;
+    }
+    return script->count > 0;
+}
+
+bool pong_link_init(PongLink *link, const PongLinkScript *script, uint64_t seed) {
+    memset(link, 0, sizeof(*link));
+    link->script = *script;
+    link->key = pong_rng_key(seed);
+    link->queue = malloc(PONG_LINK_CAPACITY * sizeof(PongLinkPacket));
+    return link->queue != NULL && script->count > 0;
+}
+
+void pong_link_free(PongLink *link) {
+    free(link->queue);
+    link->queue = NULL;
+    link->count = 0;
+}
+
+const PongLinkProfile *pong_link_profile_at(const PongLink *link, double nowMs) {
+    const PongLinkScript *script = &link->script;
+    if (script->count <= 1) return &script->steps[0];
+
+    double total = 0.0;
+    for (int s = 0; s < script->count; s++) total += script->seconds[s];
+    double t = fmod(nowMs * 0.001, total);
+    int s = 0;
+    while (s < script->count - 1 && t >= script->seconds[s]) t -= script->seconds[s++];
+    return &script->steps[s];
+}
+
+// Uniform in (0, 1)
+static double Uniform(PongLink *link) {
+    return ((double)pong_rng_draw(link->key, link->draws++) + 0.5) * (1.0 / 4294967296.0);
+}
+
+static bool Chance(PongLink *link, float percent) {
+    return percent > 0.0f && Uniform(link) * 100.0 < percent;
+}
+
+// Two-state loss: stationary probability of the bad state is loss, mean run length burst
+static bool Lost(PongLink *link, const PongLinkProfile *profile) {
+    double loss = profile->loss * 0.01;
+    if (loss <= 0.0) {
+        link->bursting = false;
+        return false;
+    }
+
+    double leave = 1.0 / profile->burst;
+    double enter = (loss >= 1.0) ? 1.0 : loss * leave / (1.0 - loss);
+    if (link->bursting) link->bursting = Uniform(link) >= leave;
+    else link->bursting = Uniform(link) < enter;
+    return link->bursting;
+}
+
+static void Enqueue(PongLink *link, const PongLinkProfile *profile, double nowMs, const void *data, size_t size, uint64_t tag) {
+    if (size > PONG_LINK_MTU || link->count == PONG_LINK_CAPACITY) {
+        link->overflowed++;
+        return;
+    }
+
+    double delay = profile->delayMs + (Uniform(link) * 2.0 - 1.0) * profile->jitterMs;
+    if (profile->spikeEveryMs > 0.0f && fmod(nowMs, profile->spikeEveryMs) < profile->spikeMs) delay += profile->spikeDelayMs;
+    double release = nowMs + ((delay > 0.0) ? delay : 0.0);
+
+    // Jitter alone never reorders: a packet cannot leave the queue before the one ahead of it
+    if (Chance(link, profile->reorder)) {
+        release += profile->holdMs;
+        link->reordered++;
+    } else {
+        if (release < link->lastReleaseMs) release = link->lastReleaseMs;
+        link->lastReleaseMs = release;
+    }
+
+    PongLinkPacket *packet = &link->queue[link->count++];
+    packet->releaseMs = release;
+    packet->order = link->order++;
+    packet->tag = tag;
+    packet->size = size;
+    memcpy(packet->data, data, size);
+}
+
+void pong_link_send(PongLink *link, double nowMs, const void *data, size_t size, uint64_t tag) {
+    const PongLinkProfile *profile = pong_link_profile_at(link, nowMs);
+    link->sent++;
+    if (Lost(link, profile)) {
+        link->lost++;
+        return;
+    }
+
+    Enqueue(link, profile, nowMs, data, size, tag);
+    if (Chance(link, profile->duplicate)) {
+        link->duplicated++;
+        Enqueue(link, profile, nowMs, data, size, tag);
+    }
+}
+
+bool pong_link_due(PongLink *link, double nowMs, PongLinkPacket *out) {
+    int best = -1;
+    for (int i = 0; i < link->count; i++) {
+        const PongLinkPacket *p = &link->queue[i];
+        if (p->releaseMs > nowMs) continue;
+        if (best < 0 || p->releaseMs < link->queue[best].releaseMs ||
+            (p->releaseMs == link->queue[best].releaseMs && p->order < link->queue[best].order)) best = i;
+    }
+    if (best < 0) return false;
+
+    *out = link->queue[best];
+    link->queue[best] = link->queue[--link->count];
+    link->delivered++;
+    return true;
+}
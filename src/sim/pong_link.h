@@ -0,0 +1,106 @@
+#ifndef PONG_LINK_H
+#define PONG_LINK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+*  Network link emulator
+*  ----------------------------------------------------------------------------------
+*  One direction of a bad network, in process: packets go in with the time they
+*  were sent and come out when (and if) they would have arrived. A profile sets
+*
+*  delay, jitter    one-way latency in ms, plus a uniform +-jitter per packet;
+*                   queueing keeps packets in order unless they are reordered
+*  loss, burst      percent lost on average, in runs of `burst` packets on
+*                   average (Gilbert-Elliott: a bad state that drops everything)
+*  dup              percent delivered twice, the copy with its own jitter
+*  reorder          percent held back an extra `hold` ms so later ones overtake
+*  spike_every/_ms  every spike_every ms, for spike_ms, latency grows by
+*  spike_delay      spike_delay ms (a Wi-Fi scan, a congested hop)
+*
+*  A script plays profiles in turn and loops: "lan@10/bad-wifi@5" is ten
+*  seconds of LAN then five of bad Wi-Fi. A step is a built-in profile name, a
+*  name with overrides ("transatlantic,loss=2") or just keys ("delay=40,jitter=5").
+*  Time is whatever the caller says it is, so tools can run links on virtual time.
+*
+*  PongLinkScript script;
+*  pong_link_parse("bad-wifi", &script);
+*  pong_link_init(&link, &script, seed);
+*  pong_link_send(&link, nowMs, data, size, 0);
+*  while (pong_link_due(&link, nowMs, &packet)) deliver(packet.data, packet.size);
+*/
+
+#define PONG_LINK_MTU      1200     // Larger packets are dropped
+#define PONG_LINK_CAPACITY 1024     // Packets in flight; beyond that the queue drops them
+#define PONG_LINK_STEPS    8        // Profiles in one script
+
+typedef struct {
+    char name[24];
+    float delayMs;
+    float jitterMs;
+    float loss;                     // Percent
+    float burst;                    // Mean length of a loss run, packets (1 = independent)
+    float duplicate;                // Percent
+    float reorder;                  // Percent
+    float holdMs;                   // Extra delay of a reordered packet
+    float spikeEveryMs;             // 0 = no spikes
+    float spikeMs;
+    float spikeDelayMs;
+} PongLinkProfile;
+
+typedef struct {
+    PongLinkProfile steps[PONG_LINK_STEPS];
+    float seconds[PONG_LINK_STEPS]; // How long each step lasts (ignored with one step)
+    int count;
+} PongLinkScript;
+
+typedef struct {
+    double releaseMs;
+    uint64_t order;                 // Send order, breaks ties
+    uint64_t tag;                   // Caller's, e.g. the destination address
+    size_t size;
+    unsigned char data[PONG_LINK_MTU];
+} PongLinkPacket;
+
+typedef struct {
+    PongLinkScript script;
+    uint64_t key;                   // Random stream (pong_rng)
+    uint64_t draws;
+    bool bursting;                  // In the loss state
+    double lastReleaseMs;           // In-order packets leave no earlier than this
+
+    PongLinkPacket *queue;
+    int count;
+    uint64_t order;
+
+    // Counters
+    uint64_t sent;
+    uint64_t delivered;
+    uint64_t lost;
+    uint64_t duplicated;
+    uint64_t reordered;
+    uint64_t overflowed;            // Queue full or packet too large
+} PongLink;
+
+// Built-in profiles: lan, cable, transatlantic, bad-wifi, mobile.
+extern const PongLinkProfile pong_link_profiles[];
+extern const int pong_link_profile_count;
+
+// Parse a script (see above). False on an unknown name or key.
+bool pong_link_parse(const char *text, PongLinkScript *script);
+
+bool pong_link_init(PongLink *link, const PongLinkScript *script, uint64_t seed);
+void pong_link_free(PongLink *link);
+
+// The profile in effect at nowMs.
+const PongLinkProfile *pong_link_profile_at(const PongLink *link, double nowMs);
+
+// Put a packet on the link at nowMs. It may be lost, duplicated, delayed or reordered.
+void pong_link_send(PongLink *link, double nowMs, const void *data, size_t size, uint64_t tag);
+
+// Take the next packet that has arrived by nowMs, earliest first; false if none has.
+bool pong_link_due(PongLink *link, double nowMs, PongLinkPacket *out);
+
+#endif // PONG_LINK_H
@@ -0,0 +1,69 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "pong_pacer.h"
+
+void pong_pacer_init(PongPacer *pacer, double period, double now) {
+    memset(pacer, 0, sizeof(*pacer));
+    pacer->period = period;
+    pacer->presented = now;
+    pacer->safety = PONG_PACER_MIN_SAFETY;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+double pong_pacer_latch_time(const PongPacer *pacer) {
+    // A rare spike past the percentile misses its vblank and raises the safety
+    // margin for a while; budgeting every frame for the worst would cost them all
+    double sorted[PONG_PACER_HISTORY];
+    memcpy(sorted, pacer->work, sizeof(sorted));
+    qsort(sorted, PONG_PACER_HISTORY, sizeof(double), CompareDouble);
+    double budget = sorted[PONG_PACER_HISTORY * PONG_PACER_PERCENTILE / 100];
+
+    return pacer->presented + pacer->period - budget - pacer->safety;
+}
+
+void pong_pacer_frame(PongPacer *pacer, double latched, double submitted, double presented) {
+    pacer->work[pacer->workNext] = submitted - latched;
+    pacer->workNext = (pacer->workNext + 1) % PONG_PACER_HISTORY;
+    pacer->frames++;
+
+    // Half a refresh past the next vblank means the swap waited for the one after
+    if (presented > pacer->presented + 1.5 * pacer->period) {
+        pacer->missed++;
+        pacer->safety += PONG_PACER_MISS_STEP;
+        if (pacer->safety > 0.5 * pacer->period) pacer->safety = 0.5 * pacer->period;
+    } else {
+        pacer->safety += (PONG_PACER_MIN_SAFETY - pacer->safety) * 0.01;
+    }
+
+    // Only swap-to-swap gaps near one refresh say anything about the period
+    double interval = presented - pacer->presented;
+    if (interval > 0.75 * pacer->period && interval < 1.25 * pacer->period) {
+        pacer->period += (interval - pacer->period) * 0.05;
+    }
+    pacer->presented = presented;
+}
+
+void pong_latency_add(PongLatencyStats *stats, double seconds) {
+    stats->samples[stats->count % PONG_LATENCY_SAMPLES] = seconds;
+    stats->count++;
+    stats->sum += seconds;
+}
+
+void pong_latency_summary(const PongLatencyStats *stats, double *mean, double *p50, double *p99) {
+    *mean = *p50 = *p99 = 0.0;
+    if (stats->count == 0) return;
+
+    int n = (stats->count < PONG_LATENCY_SAMPLES) ? stats->count : PONG_LATENCY_SAMPLES;
+    double sorted[PONG_LATENCY_SAMPLES];
+    memcpy(sorted, stats->samples, (size_t)n * sizeof(double));
+    qsort(sorted, (size_t)n, sizeof(double), CompareDouble);
+
+    *mean = stats->sum / stats->count;
+    *p50 = sorted[n / 2];
+    *p99 = sorted[n * 99 / 100];
+}
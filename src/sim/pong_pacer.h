@@ -0,0 +1,65 @@
+#ifndef PONG_PACER_H
+#define PONG_PACER_H
+
+#include "pong.h"
+
+/*
+*  Frame pacing
+*  ----------------------------------------------------------------------------------
+*  Plain vsync starts each frame as soon as the previous swap returns, so the keys
+*  it reads then wait most of a refresh inside the next swap before they show. The
+*  pacer starts the frame - latching input and catching the view up to it - as late
+*  as it can and still make the next vblank:
+*
+*  latch = next vblank - PONG_PACER_PERCENTILE of recent frames (latch to submit) - safety
+*
+*  The next vblank is predicted from when swaps return (each is taken as a vblank)
+*  and a running estimate of the refresh period. The safety margin grows whenever a
+*  frame misses the vblank it was aimed at and drifts back down while none do, so
+*  the pacer finds how late this machine can cut it. Times are pong_clock_now().
+*
+*  double latch = pong_pacer_latch_time(&pacer);   // poll input until then
+*  ... latch input, draw ...                        // submitted = pong_clock_now()
+*  EndDrawing();
+*  pong_pacer_frame(&pacer, latched, submitted, pong_clock_now());
+*/
+
+#define PONG_PACER_HISTORY    64        // Frames of draw time the margin looks back over
+#define PONG_PACER_PERCENTILE 95        // Of those, the draw time budgeted for
+#define PONG_PACER_MIN_SAFETY 0.0005    // Seconds
+#define PONG_PACER_MISS_STEP  0.001     // Safety added per missed vblank
+
+#define PONG_LATENCY_SAMPLES  256       // Newest latencies kept for percentiles
+
+typedef struct {
+    double period;                      // Refresh period estimate
+    double presented;                   // When the last swap returned
+    double work[PONG_PACER_HISTORY];    // Latch to submit, recent frames
+    int workNext;
+    double safety;
+    int frames;
+    int missed;                         // Frames that went out a vblank or more late
+} PongPacer;
+
+typedef struct {
+    double samples[PONG_LATENCY_SAMPLES];   // Ring of the newest
+    int count;                          // All samples so far
+    double sum;
+} PongLatencyStats;
+
+// period: the display's nominal refresh period; now: when the last swap returned.
+void pong_pacer_init(PongPacer *pacer, double period, double now);
+
+// When to latch input for the next frame (may already be past).
+double pong_pacer_latch_time(const PongPacer *pacer);
+
+// Feed back one frame: when it latched input, submitted its drawing and its swap returned.
+void pong_pacer_frame(PongPacer *pacer, double latched, double submitted, double presented);
+
+void pong_latency_add(PongLatencyStats *stats, double seconds);
+
+// Mean of every sample; median and 99th percentile of the newest PONG_LATENCY_SAMPLES.
+// All 0 without samples.
+void pong_latency_summary(const PongLatencyStats *stats, double *mean, double *p50, double *p99);
+
+#endif // PONG_PACER_H
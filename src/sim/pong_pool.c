@@ -0,0 +1,196 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pong_pool.h"
+
+typedef struct {
+    PongPool *pool;
+    int index;
+} WorkerArgs;
+
+static uint64_t PackRange(uint32_t begin, uint32_t end) {
+    return ((uint64_t)begin << 32) | end;
+}
+
+// Owner side: take the first chunk of our own range.
+static int PopChunk(PongPoolQueue *queue) {
+    uint64_t range = atomic_load(&queue->range);
+
+    for (;;) {
+        uint32_t begin = (uint32_t)(range >> 32), end = (uint32_t)range;
+        if (begin >= end) return -1;
+        if (atomic_compare_exchange_weak(&queue->range, &range, PackRange(begin + 1, end))) return (int)begin;
+    }
+}
+
+// Thief side: take the back half of some other thread's range, keep the rest of
+// it as our own and return its first chunk. Our own queue is empty when we get here.
+static int StealChunks(PongPool *pool, int self) {
+    for (int k = 1; k < pool->threads; k++) {
+        PongPoolQueue *victim = &pool->queues[(self + k) % pool->threads];
+        uint64_t range = atomic_load(&victim->range);
+
+        for (;;) {
+            uint32_t begin = (uint32_t)(range >> 32), end = (uint32_t)range;
+            if (begin >= end) break;
+
+            uint32_t split = end - (end - begin + 1) / 2;
+            if (atomic_compare_exchange_weak(&victim->range, &range, PackRange(begin, split))) {
+                atomic_store(&pool->queues[self].range, PackRange(split + 1, end));
+                return (int)split;
+            }
+        }
+    }
+
+    return -1;
+}
+
+static void WorkOnJob(PongPool *pool, int self, PongPoolTask task, void *user, int items, int grain) {
+    int chunk;
+
+    while ((chunk = PopChunk(&pool->queues[self])) >= 0 || (chunk = StealChunks(pool, self)) >= 0) {
+        int first = chunk * grain;
+        int count = (items - first < grain) ? items - first : grain;
+        task(user, first, count);
+    }
+
+    // Nothing left to pop or steal. Stolen ranges are only ever held by threads
+    // still in this loop, so once the last one leaves every chunk has run.
+    if (atomic_fetch_sub(&pool->busy, 1) == 1) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static void *WorkerMain(void *arg) {
+    WorkerArgs *args = arg;
+    PongPool *pool = args->pool;
+    int self = args->index;
+    unsigned int seen = 0;
+    free(args);
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->quit) pthread_cond_wait(&pool->wake, &pool->lock);
+        if (pool->quit) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        PongPoolTask task = pool->task;
+        void *user = pool->user;
+        int items = pool->items, grain = pool->grain;
+        pthread_mutex_unlock(&pool->lock);
+
+        WorkOnJob(pool, self, task, user, items, grain);
+    }
+}
+
+bool pong_pool_init(PongPool *pool, int threads) {
+    memset(pool, 0, sizeof(*pool));
+
+    if (threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cores > 0) ? (int)cores : 1;
+    }
+    if (threads > PONG_POOL_MAX_THREADS) threads = PONG_POOL_MAX_THREADS;
+
+    pool->queues = aligned_alloc(sizeof(PongPoolQueue), (size_t)threads * sizeof(PongPoolQueue));
+    pool->workers = calloc((size_t)threads, sizeof(pthread_t));
+    if (!pool->queues || !pool->workers) {
+        free(pool->queues);
+        free(pool->workers);
+        memset(pool, 0, sizeof(*pool));
+        return false;
+    }
+    for (int i = 0; i < threads; i++) atomic_init(&pool->queues[i].range, 0);
+    atomic_init(&pool->busy, 0);
+
+    // Undo only what was set up; a failed pool is left zeroed, like a freed one
+    bool lock = pthread_mutex_init(&pool->lock, NULL) == 0;
+    bool wake = lock && pthread_cond_init(&pool->wake, NULL) == 0;
+    bool done = wake && pthread_cond_init(&pool->done, NULL) == 0;
+    if (!done) {
+        if (wake) pthread_cond_destroy(&pool->wake);
+        if (lock) pthread_mutex_destroy(&pool->lock);
+        free(pool->queues);
+        free(pool->workers);
+        memset(pool, 0, sizeof(*pool));
+        return false;
+    }
+
+    // Slot 0 is the calling thread; if the system refuses a thread, run with fewer
+    pool->threads = 1;
+    for (int i = 1; i < threads; i++) {
+        WorkerArgs *args = malloc(sizeof(*args));
+        if (!args) break;
+        *args = (WorkerArgs){ pool, i };
+        if (pthread_create(&pool->workers[i], NULL, WorkerMain, args) != 0) {
+            free(args);
+            break;
+        }
+        pool->threads++;
+    }
+
+    return true;
+}
+
+void pong_pool_free(PongPool *pool) {
+    // Zeroed: never started, init failed, or already freed
+    if (pool->threads == 0) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->threads; i++) pthread_join(pool->workers[i], NULL);
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->queues);
+    free(pool->workers);
+    memset(pool, 0, sizeof(*pool));
+}
+
+void pong_pool_run(PongPool *pool, int items, int grain, PongPoolTask task, void *user) {
+    if (items <= 0) return;
+    if (grain <= 0) grain = items;
+
+    int chunks = (items + grain - 1) / grain;
+
+    // Not worth waking anyone
+    if (chunks == 1 || pool->threads == 1) {
+        for (int first = 0; first < items; first += grain) {
+            task(user, first, (items - first < grain) ? items - first : grain);
+        }
+        return;
+    }
+
+    // Even contiguous shares to start with; stealing evens out the rest
+    for (int t = 0; t < pool->threads; t++) {
+        uint32_t begin = (uint32_t)((int64_t)chunks * t / pool->threads);
+        uint32_t end = (uint32_t)((int64_t)chunks * (t + 1) / pool->threads);
+        atomic_store(&pool->queues[t].range, PackRange(begin, end));
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->user = user;
+    pool->items = items;
+    pool->grain = grain;
+    atomic_store(&pool->busy, pool->threads);
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    WorkOnJob(pool, 0, task, user, items, grain);
+
+    pthread_mutex_lock(&pool->lock);
+    while (atomic_load(&pool->busy) > 0) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,62 @@
+#ifndef PONG_POOL_H
+#define PONG_POOL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+*  Work-stealing thread pool
+*  ----------------------------------------------------------------------------------
+*  Runs a parallel-for over items [0, count) split into fixed-size chunks. Each
+*  thread starts on its own contiguous share of the chunks and, once that runs out,
+*  steals half of what is left from another thread, so uneven chunks (batches with
+*  many serves or contacts) still keep every core busy.
+*
+*  Chunk boundaries depend only on the item count and the grain, never on the
+*  thread count or on who ran what. As long as the callback only writes the items
+*  of its own range, results are identical for 1 thread or 64.
+*
+*  The calling thread works too: a pool of N threads starts N - 1 workers.
+*/
+
+#define PONG_POOL_MAX_THREADS 256
+
+// Called for items [first, first + count) - one chunk, or less for the last one.
+typedef void (*PongPoolTask)(void *user, int first, int count);
+
+// One per thread, padded to a cache line so owners and thieves don't false-share.
+// Packs the thread's remaining chunk range as (begin << 32) | end.
+typedef struct {
+    _Alignas(64) _Atomic uint64_t range;
+} PongPoolQueue;
+
+typedef struct {
+    int threads;
+    pthread_t *workers;
+    PongPoolQueue *queues;
+
+    // Current job, published under lock with a new generation number
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    unsigned int generation;
+    bool quit;
+    PongPoolTask task;
+    void *user;
+    int items;
+    int grain;
+    _Atomic int busy;               // Threads still looking for chunks in this job
+} PongPool;
+
+// Start a pool with the given thread count; 0 means one per online core. On failure
+// nothing is left running and pong_pool_free() on the pool does nothing.
+bool pong_pool_init(PongPool *pool, int threads);
+void pong_pool_free(PongPool *pool);
+
+// Call task over [0, items) in chunks of grain items and wait until all are done.
+// Not reentrant: one run at a time per pool.
+void pong_pool_run(PongPool *pool, int items, int grain, PongPoolTask task, void *user);
+
+#endif // PONG_POOL_H
@@ -0,0 +1,332 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pong_bytes.h"
+#include "pong_replay.h"
+
+#define MAGIC_SIZE   8
+#define HEADER_MAX   (MAGIC_SIZE + 1 + 3 * 10)
+#define VARINT_MAX   10      // Bytes in the longest 64-bit varint
+#define TRAILER_SIZE 16
+
+static const char magic[MAGIC_SIZE - 1] = { 'P', 'O', 'N', 'G', 'R', 'E', 'C' };
+static const char trailerMagic[4] = { 'P', 'K', 'E', 'Y' };
+
+#ifdef PONG_FIXED_POINT
+#define BUILD_FLAGS PONG_REPLAY_FIXED_POINT
+#else
+#define BUILD_FLAGS 0
+#endif
+
+static size_t PutVarint(unsigned char *out, uint64_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (unsigned char)value;
+    return n;
+}
+
+// Reads one varint from [*pos, size); false if it runs off the end or is too long.
+static bool GetVarint(const unsigned char *data, size_t size, size_t *pos, uint64_t *value) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*pos >= size) return false;
+        unsigned char byte = data[(*pos)++];
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t EncodeRun(unsigned char *out, PongInput input, uint32_t ticks) {
+    PongInput parts = input >> PONG_INPUT_PART_SHIFT;
+    size_t n = PutVarint(out, ((uint64_t)(ticks - 1) << (PONG_INPUT_BITS + 1)) | (parts ? PONG_RUN_PARTS : 0) | (input & PONG_INPUT_MASK));
+    return parts ? n + PutVarint(out + n, parts) : n;
+}
+
+// One run of a version's format; false if it is cut short or malformed
+static bool DecodeRun(const unsigned char *data, size_t size, size_t *pos, int version, PongInput *input, uint64_t *ticks) {
+    uint64_t run, parts = 0;
+    if (!GetVarint(data, size, pos, &run)) return false;
+
+    int shift = (version >= 3) ? PONG_INPUT_BITS + 1 : PONG_INPUT_BITS;
+    if (version >= 3 && (run & PONG_RUN_PARTS) && (!GetVarint(data, size, pos, &parts) || parts == 0 || parts > 0xFFFF)) return false;
+
+    *input = (PongInput)(run & PONG_INPUT_MASK) | (PongInput)parts << PONG_INPUT_PART_SHIFT;
+    *ticks = (run >> shift) + 1;
+    return *ticks <= UINT32_MAX;
+}
+
+// Tick and run offset, then the state image
+static void EncodeKeyframe(unsigned char *out, const PongKeyframe *key) {
+    pong_put_u32(out + 0, key->tick);
+    pong_put_u32(out + 4, key->runOffset);
+    pong_state_pack(&key->state, out + 8);
+}
+
+static bool DecodeKeyframe(const unsigned char *in, uint64_t seed, PongKeyframe *key) {
+    pong_init(&key->state, seed);
+    key->tick = pong_get_u32(in + 0);
+    key->runOffset = pong_get_u32(in + 4);
+    return pong_state_unpack(&key->state, in + 8);
+}
+
+void pong_record_init(PongRecorder *rec, uint64_t seed, int tickRate) {
+    *rec = (PongRecorder){ .seed = seed, .tickRate = tickRate };
+}
+
+void pong_record_free(PongRecorder *rec) {
+    free(rec->runs);
+    free(rec->keyframes);
+    memset(rec, 0, sizeof(*rec));
+}
+
+// Close the current run so the next tick starts a new one
+static bool FlushRun(PongRecorder *rec) {
+    if (rec->runTicks == 0) return true;
+
+    if (rec->capacity - rec->size < 2 * VARINT_MAX) {
+        size_t capacity = rec->capacity ? rec->capacity * 2 : 256;
+        unsigned char *runs = realloc(rec->runs, capacity);
+        if (!runs) return false;
+        rec->runs = runs;
+        rec->capacity = capacity;
+    }
+    rec->size += EncodeRun(rec->runs + rec->size, rec->runInput, rec->runTicks);
+    rec->runTicks = 0;
+    return true;
+}
+
+static bool AddKeyframe(PongRecorder *rec, const PongState *state) {
+    if (rec->keyframeCount == rec->keyframeCapacity) {
+        int capacity = rec->keyframeCapacity ? rec->keyframeCapacity * 2 : 64;
+        PongKeyframe *keyframes = realloc(rec->keyframes, (size_t)capacity * sizeof(PongKeyframe));
+        if (!keyframes) return false;
+        rec->keyframes = keyframes;
+        rec->keyframeCapacity = capacity;
+    }
+
+    rec->keyframes[rec->keyframeCount++] = (PongKeyframe){ rec->ticks, (uint32_t)rec->size, *state };
+    return true;
+}
+
+bool pong_record_tick(PongRecorder *rec, const PongState *state, PongInput input) {
+    input &= PONG_INPUT_MASK | PONG_INPUT_P1_PARTS | PONG_INPUT_P2_PARTS;
+
+    if (rec->ticks % PONG_KEYFRAME_TICKS == 0) {
+        if (!FlushRun(rec) || !AddKeyframe(rec, state)) return false;
+    }
+
+    if (rec->runTicks > 0 && input == rec->runInput && rec->runTicks < UINT32_MAX) {
+        rec->runTicks++;
+        rec->ticks++;
+        return true;
+    }
+
+    if (!FlushRun(rec)) return false;
+
+    rec->runInput = input;
+    rec->runTicks = 1;
+    rec->ticks++;
+    return true;
+}
+
+bool pong_record_save(const PongRecorder *rec, const char *path) {
+    unsigned char header[HEADER_MAX];
+    memcpy(header, magic, sizeof(magic));
+    header[MAGIC_SIZE - 1] = PONG_REPLAY_VERSION;
+    header[MAGIC_SIZE] = BUILD_FLAGS;
+    size_t headerSize = MAGIC_SIZE + 1;
+    headerSize += PutVarint(header + headerSize, (uint64_t)rec->tickRate);
+    headerSize += PutVarint(header + headerSize, rec->seed);
+    headerSize += PutVarint(header + headerSize, PONG_KEYFRAME_TICKS);
+
+    unsigned char pending[VARINT_MAX];
+    size_t pendingSize = (rec->runTicks > 0) ? EncodeRun(pending, rec->runInput, rec->runTicks) : 0;
+
+    unsigned char trailer[TRAILER_SIZE];
+    uint64_t keyframesOffset = headerSize + rec->size + pendingSize;
+    pong_put_u32(trailer + 0, (uint32_t)keyframesOffset);
+    pong_put_u32(trailer + 4, (uint32_t)(keyframesOffset >> 32));
+    pong_put_u32(trailer + 8, (uint32_t)rec->keyframeCount);
+    memcpy(trailer + 12, trailerMagic, sizeof(trailerMagic));
+
+    FILE *file = fopen(path, "wb");
+    if (!file) return false;
+
+    bool ok = fwrite(header, 1, headerSize, file) == headerSize &&
+              (rec->size == 0 || fwrite(rec->runs, 1, rec->size, file) == rec->size) &&
+              (pendingSize == 0 || fwrite(pending, 1, pendingSize, file) == pendingSize);
+
+    for (int k = 0; ok && k < rec->keyframeCount; k++) {
+        unsigned char key[PONG_KEYFRAME_BYTES];
+        EncodeKeyframe(key, &rec->keyframes[k]);
+        ok = fwrite(key, 1, sizeof(key), file) == sizeof(key);
+    }
+    ok = ok && fwrite(trailer, 1, sizeof(trailer), file) == sizeof(trailer);
+
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+static bool ReadFile(const char *path, unsigned char **data, size_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return false;
+
+    bool ok = fseek(file, 0, SEEK_END) == 0;
+    long length = ok ? ftell(file) : -1;
+    ok = ok && length >= 0 && fseek(file, 0, SEEK_SET) == 0;
+
+    unsigned char *buffer = ok ? malloc((size_t)length + 1) : NULL;
+    ok = buffer && fread(buffer, 1, (size_t)length, file) == (size_t)length;
+    fclose(file);
+
+    if (!ok) {
+        free(buffer);
+        return false;
+    }
+    *data = buffer;
+    *size = (size_t)length;
+    return true;
+}
+
+bool pong_replay_load(PongReplay *replay, const char *path) {
+    memset(replay, 0, sizeof(*replay));
+    if (!ReadFile(path, &replay->data, &replay->size)) return false;
+
+    const unsigned char *data = replay->data;
+    size_t size = replay->size, pos = MAGIC_SIZE + 1;
+    uint64_t tickRate, seed, keyframeTicks = 0;
+    int version = (size >= pos) ? data[MAGIC_SIZE - 1] : 0;
+
+    bool ok = size >= pos &&
+              memcmp(data, magic, sizeof(magic)) == 0 &&
+              version >= 1 && version <= PONG_REPLAY_VERSION &&
+              data[MAGIC_SIZE] == BUILD_FLAGS &&
+              GetVarint(data, size, &pos, &tickRate) && tickRate > 0 && tickRate <= 100000 &&
+              GetVarint(data, size, &pos, &seed) &&
+              (version == 1 || (GetVarint(data, size, &pos, &keyframeTicks) && keyframeTicks > 0 && keyframeTicks <= UINT32_MAX));
+
+    // Version 2+: the trailer says where the runs stop and the keyframes start
+    size_t runsStart = pos, runsEnd = size;
+    uint32_t keyframeCount = 0;
+    if (ok && version >= 2) {
+        ok = size - pos >= TRAILER_SIZE && memcmp(data + size - 4, trailerMagic, sizeof(trailerMagic)) == 0;
+        if (ok) {
+            const unsigned char *trailer = data + size - TRAILER_SIZE;
+            uint64_t offset = pong_get_u32(trailer) | (uint64_t)pong_get_u32(trailer + 4) << 32;
+            keyframeCount = pong_get_u32(trailer + 8);
+            ok = offset >= runsStart && offset <= size - TRAILER_SIZE &&
+                 (size - TRAILER_SIZE - offset) / PONG_KEYFRAME_BYTES == keyframeCount &&
+                 (size - TRAILER_SIZE - offset) % PONG_KEYFRAME_BYTES == 0;
+            runsEnd = (size_t)offset;
+        }
+    }
+
+    // Keyframe k must sit at tick k * interval
+    if (ok && keyframeCount > 0) {
+        replay->keyframes = malloc((size_t)keyframeCount * sizeof(PongKeyframe));
+        ok = replay->keyframes != NULL;
+    }
+    for (uint32_t k = 0; ok && k < keyframeCount; k++) {
+        PongKeyframe *key = &replay->keyframes[k];
+        ok = DecodeKeyframe(data + runsEnd + (size_t)k * PONG_KEYFRAME_BYTES, seed, key) &&
+             key->tick == (uint64_t)k * keyframeTicks;
+    }
+
+    // Walk the runs once: validates them, gives the length, and checks that each
+    // keyframe points at the start of the run that begins on its tick (a seek
+    // resumes decoding there, so any other offset would misparse the runs)
+    uint64_t ticks = 0;
+    uint32_t next = 0;
+    pos = runsStart;
+    while (ok && pos < runsEnd) {
+        for (; ok && next < keyframeCount && replay->keyframes[next].tick == ticks; next++) {
+            ok = replay->keyframes[next].runOffset == pos - runsStart;
+        }
+        ok = ok && (next == keyframeCount || replay->keyframes[next].tick > ticks);
+
+        PongInput input;
+        uint64_t runTicks;
+        ok = ok && DecodeRun(data, runsEnd, &pos, version, &input, &runTicks);
+        ticks += ok ? runTicks : 0;
+        ok = ok && ticks <= UINT32_MAX;
+    }
+
+    // Only a keyframe on the very last tick may be left, pointing past the last run
+    for (; ok && next < keyframeCount; next++) {
+        ok = replay->keyframes[next].tick == ticks && replay->keyframes[next].runOffset == runsEnd - runsStart;
+    }
+
+    if (!ok) {
+        pong_replay_free(replay);
+        return false;
+    }
+
+    replay->flags = data[MAGIC_SIZE];
+    replay->tickRate = (int)tickRate;
+    replay->seed = seed;
+    replay->ticks = (uint32_t)ticks;
+    replay->keyframeTicks = (uint32_t)keyframeTicks;
+    replay->version = version;
+    replay->keyframeCount = (int)keyframeCount;
+    replay->runsStart = runsStart;
+    replay->runsEnd = runsEnd;
+    pong_replay_rewind(replay);
+    return true;
+}
+
+void pong_replay_free(PongReplay *replay) {
+    free(replay->data);
+    free(replay->keyframes);
+    memset(replay, 0, sizeof(*replay));
+}
+
+bool pong_replay_next(PongReplay *replay, PongInput *input) {
+    if (replay->runLeft == 0) {
+        uint64_t ticks;
+        if (!DecodeRun(replay->data, replay->runsEnd, &replay->pos, replay->version, &replay->runInput, &ticks)) return false;
+        replay->runLeft = (uint32_t)ticks;
+    }
+
+    replay->runLeft--;
+    replay->tick++;
+    *input = replay->runInput;
+    return true;
+}
+
+void pong_replay_rewind(PongReplay *replay) {
+    replay->pos = replay->runsStart;
+    replay->runInput = 0;
+    replay->runLeft = 0;
+    replay->tick = 0;
+}
+
+void pong_replay_seek(PongReplay *replay, uint32_t tick, PongState *state) {
+    if (tick > replay->ticks) tick = replay->ticks;
+
+    int k = (replay->keyframeTicks > 0) ? (int)(tick / replay->keyframeTicks) : 0;
+    if (k >= replay->keyframeCount) k = replay->keyframeCount - 1;
+
+    if (k >= 0) {
+        const PongKeyframe *key = &replay->keyframes[k];
+        *state = key->state;
+        replay->pos = replay->runsStart + key->runOffset;
+        replay->runInput = 0;
+        replay->runLeft = 0;
+        replay->tick = key->tick;
+    } else {
+        pong_init(state, replay->seed);
+        pong_replay_rewind(replay);
+    }
+
+    float dt = 1.0f / (float)replay->tickRate;
+    PongInput input;
+    while (replay->tick < tick && pong_replay_next(replay, &input)) pong_step(state, input, dt);
+}
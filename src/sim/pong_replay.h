@@ -0,0 +1,125 @@
+#ifndef PONG_REPLAY_H
+#define PONG_REPLAY_H
+
+#include <stddef.h>
+
+#include "pong.h"
+
+/*
+*  Input recordings (.pongrec)
+*  ----------------------------------------------------------------------------------
+*  A match is fully determined by its seed and the input bits of every tick, so
+*  that is all a recording needs to store. Version 2 adds a full-state keyframe
+*  every keyframe interval so a player can seek without re-simulating from tick 0.
+*  Version 3 adds sub-tick key holds: a run whose input has part fields sets
+*  PONG_RUN_PARTS and is followed by them; a whole-tick run costs one bit more:
+*
+*  "PONGREC" version    8 bytes
+*  flags                1 byte (PONG_REPLAY_FIXED_POINT: recorded by a fixed-point build)
+*  tick rate            varint, Hz
+*  seed                 varint
+*  keyframe interval    varint, ticks (version 2+)
+*  runs...              varint ((ticks - 1) << PONG_INPUT_BITS | input), version 1-2
+*                       varint ((ticks - 1) << (PONG_INPUT_BITS + 1) | PONG_RUN_PARTS? | input)
+*                       [varint (input >> PONG_INPUT_PART_SHIFT)], version 3
+*  keyframes...         PONG_KEYFRAME_BYTES each, one per interval (version 2+)
+*  trailer              u64 keyframes offset, u32 keyframe count, "PKEY" (version 2+)
+*
+*  Varints are LEB128: 7 bits per byte, low bits first, high bit set on every byte
+*  but the last. A run is usually one or two bytes, but the headless bots change
+*  keys many times a second and record at about 100 bytes per second of play: 7-23 KB
+*  per match, 360 KB for an hour. Keyframes add 44 bytes every 17 s, about 2.5% of
+*  that. Fixed-width fields are little-endian.
+*
+*  Keyframe k holds the state before tick k * interval and the byte offset of that
+*  tick's run (runs are split at keyframe ticks), so it doubles as the index:
+*  seeking is one array lookup plus at most interval - 1 simulated ticks.
+*
+*  PongRecorder rec;                                   PongReplay replay;
+*  pong_record_init(&rec, seed, tickRate);             pong_replay_load(&replay, path);
+*  every tick: pong_record_tick(&rec, &state, input);  pong_replay_seek(&replay, tick, &state);
+*  pong_record_save(&rec, path);                       while (pong_replay_next(&replay, &input)) pong_step(...);
+*/
+
+#define PONG_INPUT_BITS 6                       // W S UP DOWN SPACE P
+#define PONG_INPUT_MASK ((1u << PONG_INPUT_BITS) - 1)
+#define PONG_RUN_PARTS  (1u << PONG_INPUT_BITS) // Version 3: the run's part fields follow
+
+#define PONG_REPLAY_VERSION     3
+#define PONG_REPLAY_FIXED_POINT 0x01            // Header flag
+#define PONG_KEYFRAME_TICKS     4096            // About 17 s at 240 Hz; a keyframe costs 44 bytes
+#define PONG_KEYFRAME_BYTES     (8 + PONG_STATE_BYTES)   // Tick, run offset, pong_state_pack() image
+
+typedef struct {
+    uint32_t tick;
+    uint32_t runOffset;         // Where this tick's run starts, from the first run
+    PongState state;            // State before the tick is stepped
+} PongKeyframe;
+
+typedef struct {
+    uint64_t seed;
+    int tickRate;
+
+    unsigned char *runs;        // Encoded runs so far
+    size_t size;
+    size_t capacity;
+
+    PongInput runInput;         // The run still being extended
+    uint32_t runTicks;
+    uint32_t ticks;             // Ticks recorded in total
+
+    PongKeyframe *keyframes;
+    int keyframeCount;
+    int keyframeCapacity;
+} PongRecorder;
+
+typedef struct {
+    uint64_t seed;
+    int tickRate;
+    unsigned int flags;
+    uint32_t ticks;             // Length of the recording
+    uint32_t keyframeTicks;     // 0 for version 1 files (no keyframes)
+    int version;
+
+    unsigned char *data;        // Whole file
+    size_t size;
+    size_t runsStart;
+    size_t runsEnd;
+
+    PongKeyframe *keyframes;
+    int keyframeCount;
+
+    size_t pos;                 // Playback cursor
+    PongInput runInput;
+    uint32_t runLeft;
+    uint32_t tick;              // Ticks played so far
+} PongReplay;
+
+// Start an empty recording. Always succeeds; memory is allocated as ticks come in.
+void pong_record_init(PongRecorder *rec, uint64_t seed, int tickRate);
+void pong_record_free(PongRecorder *rec);
+
+// Append one tick: the state it starts from (kept on keyframe ticks) and its
+// input. False if out of memory (the tick is lost).
+bool pong_record_tick(PongRecorder *rec, const PongState *state, PongInput input);
+
+// Write everything recorded so far; recording can carry on afterwards.
+bool pong_record_save(const PongRecorder *rec, const char *path);
+
+// Read a recording (version 1 to 3). Fails on I/O errors, a bad header, a corrupt
+// run or keyframe, or a file recorded in the other physics mode (float vs fixed
+// point would not replay).
+bool pong_replay_load(PongReplay *replay, const char *path);
+void pong_replay_free(PongReplay *replay);
+
+// Input for the next tick; false once the recording has ended.
+bool pong_replay_next(PongReplay *replay, PongInput *input);
+
+// Back to tick 0.
+void pong_replay_rewind(PongReplay *replay);
+
+// Put state at tick (clamped to the recording's length) and the cursor right
+// after it: restores the nearest keyframe at or before tick and simulates the rest.
+void pong_replay_seek(PongReplay *replay, uint32_t tick, PongState *state);
+
+#endif // PONG_REPLAY_H
@@ -0,0 +1,49 @@
+#ifndef PONG_RNG_H
+#define PONG_RNG_H
+
+#include <stdint.h>
+
+/*
+*  Counter-based random numbers
+*  ----------------------------------------------------------------------------------
+*  Draw n of a match is a pure function of (key, n): the SplitMix64 output for
+*  state key + (n + 1) * gamma. There is no hidden state to carry along, so
+*
+*  - every match owns an independent stream (its key comes from its seed) and
+*    threads stepping different matches never touch a shared generator,
+*  - a replay only needs the seed plus the inputs,
+*  - any draw can be produced directly: a match jumped to its k-th serve just sets
+*    its counter, it does not replay the draws in between.
+*
+*  The simulation takes one draw per serve (the angle) and one per restart after
+*  game over (the next serve direction).
+*/
+
+#define PONG_RNG_GAMMA 0x9E3779B97F4A7C15ull     // 2^64 / golden ratio, odd
+
+// SplitMix64 output function: a bijection on 64 bits with full avalanche.
+static inline uint64_t pong_rng_mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Stream key for a seed. Neighbouring seeds (seed, seed + 1, ...) give unrelated keys.
+static inline uint64_t pong_rng_key(uint64_t seed) {
+    return pong_rng_mix(seed + PONG_RNG_GAMMA);
+}
+
+// Draw number `counter` of stream `key`, 32 bits.
+static inline uint32_t pong_rng_draw(uint64_t key, uint64_t counter) {
+    return (uint32_t)(pong_rng_mix(key + (counter + 1) * PONG_RNG_GAMMA) >> 32);
+}
+
+// Draw number `counter` mapped to [min, max] by multiply-shift (no modulo bias
+// worth measuring for ranges this small, and no division).
+static inline int pong_rng_range(uint64_t key, uint64_t counter, int min, int max) {
+    if (min > max) { int tmp = max; max = min; min = tmp; }
+    uint64_t span = (uint64_t)((int64_t)max - min + 1);
+    return min + (int)(((uint64_t)pong_rng_draw(key, counter) * span) >> 32);
+}
+
+#endif // PONG_RNG_H
@@ -0,0 +1,170 @@
+#include <string.h>
+
+#include "pong_bytes.h"
+#include "pong_clock.h"
+#include "pong_rollback.h"
+
+#define NO_ROLLBACK UINT32_MAX
+#define HELLO_SIZE  9
+#define INPUT_HEADER_SIZE 19     // type, ack u32, first u32, count u16, hash tick u32, rolling hash u32
+
+static PongInput PlayerKeys(int player) {
+    return (player == 0) ? PONG_INPUT_P1_KEYS : PONG_INPUT_P2_KEYS;
+}
+
+static PongInput HeldKeys(int player) {
+    return (player == 0) ? (PONG_INPUT_P1_UP | PONG_INPUT_P1_DOWN) : (PONG_INPUT_P2_UP | PONG_INPUT_P2_DOWN);
+}
+
+// Oldest tick the rings still have to hold (the rollback window)
+static uint32_t OldestTick(const PongRollback *rb) {
+    return (rb->tick > PONG_ROLLBACK_WINDOW) ? rb->tick - PONG_ROLLBACK_WINDOW : 0;
+}
+
+void pong_rollback_init(PongRollback *rb, uint64_t seed, int localPlayer, int inputDelay) {
+    memset(rb, 0, sizeof(*rb));
+    pong_init(&rb->state, seed);
+    rb->localPlayer = localPlayer ? 1 : 0;
+
+    if (inputDelay < 0) inputDelay = 0;
+    if (inputDelay > PONG_ROLLBACK_WINDOW / 2) inputDelay = PONG_ROLLBACK_WINDOW / 2;
+    rb->inputDelay = inputDelay;
+
+    // The first inputDelay ticks run with no local keys; they are sent like any other input
+    rb->localEnd = (uint32_t)inputDelay;
+    rb->rollbackFrom = NO_ROLLBACK;
+    pong_desync_init(&rb->desync, &rb->state);
+}
+
+bool pong_rollback_add_local(PongRollback *rb, PongInput input) {
+    if (rb->localEnd > rb->tick + (uint32_t)rb->inputDelay) return false;
+    if (rb->localEnd - rb->remoteAcked >= PONG_ROLLBACK_HISTORY) return false;
+    if (rb->localEnd - OldestTick(rb) >= PONG_ROLLBACK_HISTORY) return false;
+
+    rb->local[rb->localEnd % PONG_ROLLBACK_HISTORY] = input & PlayerKeys(rb->localPlayer);
+    rb->localEnd++;
+    return true;
+}
+
+// Simulate tick t from rb->state, predicting the remote input if it is not in yet
+static void SimulateTick(PongRollback *rb, uint32_t t) {
+    int remotePlayer = 1 - rb->localPlayer;
+    PongInput remote;
+
+    if (t < rb->remoteEnd) remote = rb->remote[t % PONG_ROLLBACK_HISTORY];
+    else if (rb->remoteEnd > 0) remote = rb->remote[(rb->remoteEnd - 1) % PONG_ROLLBACK_HISTORY] & HeldKeys(remotePlayer);
+    else remote = 0;
+
+    rb->snapshots[t % PONG_ROLLBACK_WINDOW] = rb->state;
+    rb->used[t % PONG_ROLLBACK_HISTORY] = remote;
+    pong_step(&rb->state, rb->local[t % PONG_ROLLBACK_HISTORY] | remote, PONG_TICK_DT);
+}
+
+bool pong_rollback_advance(PongRollback *rb) {
+    if (rb->tick >= rb->localEnd) return false;
+    if (rb->remoteEnd < rb->tick && rb->tick - rb->remoteEnd >= PONG_ROLLBACK_WINDOW) {
+        rb->stalls++;
+        return false;
+    }
+
+    // A prediction was wrong: back to the state before that tick and replay with what we know now
+    if (rb->rollbackFrom != NO_ROLLBACK) {
+        uint32_t from = rb->rollbackFrom;
+        uint32_t depth = rb->tick - from;
+
+        rb->state = rb->snapshots[from % PONG_ROLLBACK_WINDOW];
+        for (uint32_t t = from; t < rb->tick; t++) SimulateTick(rb, t);
+
+        rb->rollbacks++;
+        rb->resimulated += depth;
+        if (depth > rb->maxRollback) rb->maxRollback = depth;
+        rb->rollbackFrom = NO_ROLLBACK;
+    }
+
+    SimulateTick(rb, rb->tick);
+    rb->tick++;
+
+    // Hash every state once it is confirmed: the one after tick n is the snapshot before n + 1
+    uint32_t confirmed = (rb->remoteEnd < rb->tick) ? rb->remoteEnd : rb->tick;
+    for (uint32_t n = rb->desync.end; n <= confirmed; n++) {
+        pong_desync_record(&rb->desync, (n == rb->tick) ? &rb->state : &rb->snapshots[n % PONG_ROLLBACK_WINDOW]);
+    }
+    return true;
+}
+
+size_t pong_rollback_write_packet(const PongRollback *rb, unsigned char *out, size_t cap) {
+    uint32_t first = rb->remoteAcked;
+    uint32_t count = rb->localEnd - first;
+    if (cap < INPUT_HEADER_SIZE + count) return 0;
+
+    out[0] = PONG_PACKET_INPUT;
+    pong_put_u32(out + 1, rb->remoteEnd);
+    pong_put_u32(out + 5, first);
+    pong_put_u16(out + 9, count);
+    uint32_t hashTick = 0, rolling = 0;
+    pong_desync_latest(&rb->desync, &hashTick, &rolling);
+    pong_put_u32(out + 11, hashTick);
+    pong_put_u32(out + 15, rolling);
+    for (uint32_t i = 0; i < count; i++) out[INPUT_HEADER_SIZE + i] = (unsigned char)rb->local[(first + i) % PONG_ROLLBACK_HISTORY];
+
+    return INPUT_HEADER_SIZE + count;
+}
+
+bool pong_rollback_read_packet(PongRollback *rb, const unsigned char *data, size_t size) {
+    if (size >= 1 && (data[0] == PONG_PACKET_DESYNC || data[0] == PONG_PACKET_DUMP)) return pong_desync_read(&rb->desync, data, size);
+    if (size < INPUT_HEADER_SIZE || data[0] != PONG_PACKET_INPUT) return false;
+
+    uint32_t ack = pong_get_u32(data + 1);
+    uint32_t first = pong_get_u32(data + 5);
+    uint32_t count = pong_get_u16(data + 9);
+    if (size != INPUT_HEADER_SIZE + count) return false;
+
+    if (ack > rb->remoteAcked && ack <= rb->localEnd) rb->remoteAcked = ack;
+
+    // Only extend the confirmed inputs contiguously; anything past a gap comes
+    // again in the next packet, since the peer resends until we acknowledge
+    PongInput keys = PlayerKeys(1 - rb->localPlayer);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t t = first + i;
+        if (t < rb->remoteEnd) continue;
+        if (t > rb->remoteEnd || t - OldestTick(rb) >= PONG_ROLLBACK_HISTORY) break;
+
+        PongInput input = data[INPUT_HEADER_SIZE + i] & keys;
+        rb->remote[t % PONG_ROLLBACK_HISTORY] = input;
+        rb->remoteEnd++;
+
+        if (t < rb->tick && rb->used[t % PONG_ROLLBACK_HISTORY] != input && t < rb->rollbackFrom) rb->rollbackFrom = t;
+    }
+
+    pong_desync_peer(&rb->desync, pong_get_u32(data + 11), pong_get_u32(data + 15));
+    return true;
+}
+
+size_t pong_rollback_write_desync(PongRollback *rb, unsigned char *out, size_t cap) {
+    return pong_desync_write(&rb->desync, out, cap);
+}
+
+const PongState *pong_rollback_confirmed(const PongRollback *rb, uint32_t *tick) {
+    if (rb->remoteEnd >= rb->tick) {
+        *tick = rb->tick;
+        return &rb->state;
+    }
+
+    *tick = rb->remoteEnd;
+    if (rb->tick - rb->remoteEnd > PONG_ROLLBACK_WINDOW) return NULL;
+    return &rb->snapshots[rb->remoteEnd % PONG_ROLLBACK_WINDOW];
+}
+
+size_t pong_rollback_write_hello(uint64_t seed, unsigned char *out, size_t cap) {
+    if (cap < HELLO_SIZE) return 0;
+    out[0] = PONG_PACKET_HELLO;
+    pong_put_u32(out + 1, (uint32_t)seed);
+    pong_put_u32(out + 5, (uint32_t)(seed >> 32));
+    return HELLO_SIZE;
+}
+
+bool pong_rollback_read_hello(const unsigned char *data, size_t size, uint64_t *seed) {
+    if (size != HELLO_SIZE || data[0] != PONG_PACKET_HELLO) return false;
+    *seed = pong_get_u32(data + 1) | (uint64_t)pong_get_u32(data + 5) << 32;
+    return true;
+}
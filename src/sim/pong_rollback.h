@@ -0,0 +1,107 @@
+#ifndef PONG_ROLLBACK_H
+#define PONG_ROLLBACK_H
+
+#include <stddef.h>
+
+#include "pong.h"
+#include "pong_desync.h"
+
+/*
+*  Rollback netplay
+*  ----------------------------------------------------------------------------------
+*  GGPO-style: each peer simulates every tick as soon as its own input is known,
+*  predicting the remote player's input (the last one received, paddle keys
+*  still held, presses released). When the real input for an already simulated
+*  tick arrives and differs from the prediction, the peer restores the snapshot
+*  taken before that tick and re-simulates up to the present. A PongState is a
+*  small plain struct and pong_step() is tens of nanoseconds, so snapshots are a
+*  struct copy and even a full-window rollback costs microseconds.
+*
+*  The session knows nothing about sockets: it produces and consumes packets as
+*  byte buffers, so it runs over UDP (src/net/pong_udp.h), a test harness or
+*  anything else. Packets carry every input the peer has not acknowledged yet,
+*  so lost, duplicated and reordered packets need no special handling.
+*
+*  Every confirmed state goes through a desync detector (pong_desync.h) and each
+*  input packet carries the newest rolling hash, so peers that stop agreeing
+*  notice within a round trip and trade their states at the first bad tick.
+*
+*  PongRollback rb;
+*  pong_rollback_init(&rb, seed, localPlayer, inputDelay);
+*  every tick:
+*      pong_rollback_add_local(&rb, keys);
+*      send(pong_rollback_write_packet(&rb, buf, sizeof(buf)));
+*      for each packet received: pong_rollback_read_packet(&rb, data, size);
+*      if (!pong_rollback_advance(&rb)) wait for the peer;   // too far ahead
+*      send(pong_rollback_write_desync(&rb, buf, sizeof(buf))) if not 0;
+*      draw rb.state
+*/
+
+#define PONG_ROLLBACK_WINDOW  128       // Ticks a peer may run ahead of the remote input (~0.5 s at 240 Hz)
+#define PONG_ROLLBACK_HISTORY 512       // Input ring size: window + input delay + unacknowledged inputs
+#define PONG_ROLLBACK_PACKET_MAX (19 + PONG_ROLLBACK_HISTORY)     // Also holds any desync packet
+
+// Input bits each player contributes; SERVE and PAUSE may come from either side
+#define PONG_INPUT_P1_KEYS (PONG_INPUT_P1_UP | PONG_INPUT_P1_DOWN | PONG_INPUT_SERVE | PONG_INPUT_PAUSE)
+#define PONG_INPUT_P2_KEYS (PONG_INPUT_P2_UP | PONG_INPUT_P2_DOWN | PONG_INPUT_SERVE | PONG_INPUT_PAUSE)
+
+typedef enum {
+    PONG_PACKET_HELLO = 1,          // Session start: carries the seed
+    PONG_PACKET_INPUT = 2           // Inputs + acknowledgement
+} PongPacketType;
+
+typedef struct {
+    PongState state;                // Latest state (after tick - 1, possibly predicted)
+    uint32_t tick;                  // Next tick to simulate
+    int localPlayer;                // 0 = player 1, 1 = player 2
+    int inputDelay;                 // Local input applies this many ticks after it is added
+
+    PongInput local[PONG_ROLLBACK_HISTORY];     // By tick, valid below localEnd
+    PongInput remote[PONG_ROLLBACK_HISTORY];    // Confirmed, valid below remoteEnd
+    PongInput used[PONG_ROLLBACK_HISTORY];      // Remote input the last simulation of a tick used
+    PongState snapshots[PONG_ROLLBACK_WINDOW];  // State before each of the last WINDOW ticks
+    uint32_t localEnd;
+    uint32_t remoteEnd;
+    uint32_t remoteAcked;           // The peer has every local input below this
+    uint32_t rollbackFrom;          // Earliest mispredicted tick, or UINT32_MAX
+    PongDesync desync;              // Confirmed states, hashed
+
+    // Counters
+    uint64_t rollbacks;             // Rollbacks performed
+    uint64_t resimulated;           // Ticks re-simulated by them
+    uint32_t maxRollback;           // Deepest rollback, ticks
+    uint64_t stalls;                // advance() calls refused for running too far ahead
+} PongRollback;
+
+// Start a session. Both peers must use the same seed and inputDelay and
+// different players.
+void pong_rollback_init(PongRollback *rb, uint64_t seed, int localPlayer, int inputDelay);
+
+// Local keys for the next tick that has none yet (tick + inputDelay). Bits that
+// belong to the other player are dropped. False if the session cannot take more
+// input yet (call advance first).
+bool pong_rollback_add_local(PongRollback *rb, PongInput input);
+
+// Roll back if needed, then simulate one tick. False (nothing simulated) when
+// there is no local input for the tick yet or the remote input is too far behind.
+bool pong_rollback_advance(PongRollback *rb);
+
+// Packet with every unacknowledged local input and our acknowledgement of the
+// peer's. Returns its size (0 if cap is too small).
+size_t pong_rollback_write_packet(const PongRollback *rb, unsigned char *out, size_t cap);
+
+// Apply a packet from the peer. False if it is malformed or not an input or desync packet.
+bool pong_rollback_read_packet(PongRollback *rb, const unsigned char *data, size_t size);
+
+// Desync query or state dump this peer owes the other; 0 when there is none.
+size_t pong_rollback_write_desync(PongRollback *rb, unsigned char *out, size_t cap);
+
+// Last state both peers agree on: before tick *tick, every input confirmed.
+// Valid right after advance(); NULL if it has already left the snapshot window.
+const PongState *pong_rollback_confirmed(const PongRollback *rb, uint32_t *tick);
+
+// Session handshake: the host sends HELLO with the seed until inputs arrive.
+size_t pong_rollback_write_hello(uint64_t seed, unsigned char *out, size_t cap);
+bool pong_rollback_read_hello(const unsigned char *data, size_t size, uint64_t *seed);
+
+#endif // PONG_ROLLBACK_H
@@ -0,0 +1,581 @@
+#include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "pong_fastmath.h"
+#include "pong_fixed.h"
+#include "pong_simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define PONG_SIMD_X86
+    #include <immintrin.h>
+#endif
+
+#ifdef PONG_SIMD_X86
+
+// Spread a lane bitmask (one bit per lane, up to 8) into 0/1 bytes and write the
+// first `lanes` of them. Even and odd bits are spread separately so the shifted
+// copies never carry into each other.
+static inline void StoreSlowFlags(unsigned char *slow, unsigned int bits, int lanes) {
+    const uint64_t spread = 0x02040810204081ULL;
+    uint64_t bytes = (((bits & 0x55u) * spread) | ((bits & 0xAAu) * spread)) & 0x0101010101010101ULL;
+    memcpy(slow, &bytes, (size_t)lanes);    // x86 is little endian: byte k is lane k
+}
+
+// Four game states, widened from bytes to 32-bit lanes
+__attribute__((target("sse2")))
+static inline __m128i LoadStatesSse2(const unsigned char *p) {
+    int packed;
+    memcpy(&packed, p, sizeof(packed));
+    __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+}
+
+#endif // PONG_SIMD_X86
+
+#ifdef PONG_FIXED_POINT
+
+// Fixed-point builds: open play in integers, for every lane. The lanes hold the
+// Q20.12 values themselves, so a lane resolved here holds exactly what
+// pong_fixed_step() would have written, without a conversion on either side.
+//
+// pong_fixed_travel() needs a 64-bit product, which vectorises badly. For steps
+// under 2^17 time units (ticks above 128 Hz) and speeds under 2^23 (2048 px/s)
+// the same floor((v * t) >> 24) splits exactly into two 32-bit products:
+// t = tHi * 256 + tLo, and (v*t) >> 24 == (v*tHi + ((v*tLo) >> 8)) >> 16.
+// The x86 kernels use their unsigned 32x32->64 multiply instead: v + 2^24 is
+// positive, and ((v + 2^24) * t) >> 24 == ((v * t) >> 24) + t.
+// Faster lanes, or longer steps, go to pong_fixed_step().
+#define FIXED_KERNEL_MAX_TIME   (1 << 17)
+#define FIXED_KERNEL_MAX_SPEED  (1 << 23)
+
+#define PADDLE_MAX_Y   (ARENA_HEIGHT - PADDLE_HEIGHT)
+
+typedef struct {
+    int32_t t, tHi, tLo;
+    PongFixed paddleStep;
+    PongFixed paddleMaxY;
+    PongFixed lowY, highY;      // Ball centre bounds, FAST_PATH_MARGIN inside the walls
+    PongFixed topY, bottomY;    // ... and on them, where a bounce puts the ball
+    PongFixed leftX, rightX;    // ... and inside the paddle columns
+} FixedKernelConstants;
+
+static bool FixedKernelSetup(float dt, FixedKernelConstants *k) {
+    PongFixedTime t = pong_fixed_time(dt);
+    if (t >= FIXED_KERNEL_MAX_TIME) return false;
+
+    *k = (FixedKernelConstants){
+        .t = (int32_t)t,
+        .tHi = (int32_t)(t >> 8),
+        .tLo = (int32_t)(t & 255),
+        .paddleStep = pong_fixed_travel((PongFixed)(PADDLE_SPEED * PONG_FIXED_ONE), t),
+        .paddleMaxY = (PongFixed)(PADDLE_MAX_Y * PONG_FIXED_ONE),
+        .lowY = (PongFixed)((BALL_RADIUS + FAST_PATH_MARGIN) * PONG_FIXED_ONE),
+        .highY = (PongFixed)((ARENA_HEIGHT - BALL_RADIUS - FAST_PATH_MARGIN) * PONG_FIXED_ONE),
+        .topY = (PongFixed)(BALL_RADIUS * PONG_FIXED_ONE),
+        .bottomY = (PongFixed)((ARENA_HEIGHT - BALL_RADIUS) * PONG_FIXED_ONE),
+        .leftX = (PongFixed)((PADDLE1_X + PADDLE_WIDTH + BALL_RADIUS + FAST_PATH_MARGIN) * PONG_FIXED_ONE),
+        .rightX = (PongFixed)((PADDLE2_X - BALL_RADIUS - FAST_PATH_MARGIN) * PONG_FIXED_ONE),
+    };
+    return true;
+}
+
+// Wrapping 32-bit product: exact for in-range lanes, defined for the rest
+static inline int32_t MulWrap(int32_t a, int32_t b) {
+    return (int32_t)((uint32_t)a * (uint32_t)b);
+}
+
+// Portable loop, branch-free so the compiler can vectorise it. Every "a < b" test
+// is the sign of (b - 1 - a); the lane is fast when none of the ORed differences
+// is negative.
+static void StepFixedLanes(int count, const PongInput *restrict inputs, const FixedKernelConstants *k,
+                           PongFixed *restrict ballX, PongFixed *restrict ballY,
+                           const PongFixed *restrict ballVX, const PongFixed *restrict ballVY,
+                           PongFixed *restrict paddle1Y, PongFixed *restrict paddle2Y,
+                           const unsigned char *restrict gameState, unsigned char *restrict slow) {
+    const int32_t tHi = k->tHi, tLo = k->tLo;
+    const PongFixed paddleStep = k->paddleStep, paddleMaxY = k->paddleMaxY;
+    const PongFixed lowY = k->lowY, highY = k->highY, leftX = k->leftX, rightX = k->rightX;
+
+    for (int i = 0; i < count; i++) {
+        PongInput in = inputs[i];
+        PongFixed p1Old = paddle1Y[i], p2Old = paddle2Y[i];
+        PongFixed x0 = ballX[i], y0 = ballY[i];
+        PongFixed vx = ballVX[i], vy = ballVY[i];
+
+        // Key bits as all-ones masks on the step. Integer adds are exact, so up and
+        // down can be applied in any order.
+        PongFixed p1 = p1Old + (paddleStep & -(PongFixed)((in & PONG_INPUT_P1_DOWN) >> 1)) - (paddleStep & -(PongFixed)(in & PONG_INPUT_P1_UP));
+        p1 = (p1 < 0) ? 0 : p1;
+        p1 = (p1 > paddleMaxY) ? paddleMaxY : p1;
+
+        PongFixed p2 = p2Old + (paddleStep & -(PongFixed)((in & PONG_INPUT_P2_DOWN) >> 3)) - (paddleStep & -(PongFixed)((in & PONG_INPUT_P2_UP) >> 2));
+        p2 = (p2 < 0) ? 0 : p2;
+        p2 = (p2 > paddleMaxY) ? paddleMaxY : p2;
+
+        PongFixed x1 = x0 + ((MulWrap(vx, tHi) + (MulWrap(vx, tLo) >> 8)) >> 16);
+        PongFixed y1 = y0 + ((MulWrap(vy, tHi) + (MulWrap(vy, tLo) >> 8)) >> 16);
+
+        PongFixed notPlaying = (PongFixed)(((unsigned int)gameState[i] ^ GAME_PLAYING) | (in & PONG_INPUT_PAUSE));
+        PongFixed bad = -notPlaying |
+                        (vx + FIXED_KERNEL_MAX_SPEED - 1) | (FIXED_KERNEL_MAX_SPEED - 1 - vx) |
+                        (vy + FIXED_KERNEL_MAX_SPEED - 1) | (FIXED_KERNEL_MAX_SPEED - 1 - vy) |
+                        (y1 - lowY - 1) | (highY - 1 - y1) |
+                        (x0 - leftX - 1) | (rightX - 1 - x0) |
+                        (x1 - leftX - 1) | (rightX - 1 - x1);
+        PongFixed keep = ~(bad >> 31);
+
+        // Blend in integers so the stores stay unconditional (see SelectBits in pong_batch.c)
+        paddle1Y[i] = (p1 & keep) | (p1Old & ~keep);
+        paddle2Y[i] = (p2 & keep) | (p2Old & ~keep);
+        ballX[i] = (x1 & keep) | (x0 & ~keep);
+        ballY[i] = (y1 & keep) | (y0 & ~keep);
+        slow[i] = (unsigned char)((unsigned int)bad >> 31);
+    }
+}
+
+#define FIXED_LANES(batch, first, count, inputs, k)                                               \
+    StepFixedLanes(count, (inputs) + (first), k, (batch)->ballX + (first), (batch)->ballY + (first), \
+                   (batch)->ballVX + (first), (batch)->ballVY + (first), (batch)->paddle1Y + (first), \
+                   (batch)->paddle2Y + (first), (batch)->gameState + (first), (batch)->slow + (first))
+
+#ifdef PONG_SIMD_X86
+
+// The same loop by hand in SSE2, 4 lanes at a time. SSE2 has no 32-bit low
+// multiply and no signed 32-bit min/max, which is what the compiler's version
+// trips over; the travel uses the biased 64-bit product instead.
+__attribute__((target("sse2")))
+static inline __m128i TravelSse2(__m128i v, __m128i t, __m128i bias, __m128i highHalves) {
+    __m128i u = _mm_add_epi32(v, bias);
+    __m128i even = _mm_srli_epi64(_mm_mul_epu32(u, t), 24);                                          // Lanes 0, 2: low halves
+    __m128i odd = _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(u, 32), _mm_srli_epi64(t, 32)), 8);    // Lanes 1, 3: high halves
+    return _mm_sub_epi32(_mm_or_si128(even, _mm_and_si128(odd, highHalves)), t);
+}
+
+// p clamped to [0, maxY]
+__attribute__((target("sse2")))
+static inline __m128i ClampSse2(__m128i p, __m128i maxY) {
+    p = _mm_andnot_si128(_mm_srai_epi32(p, 31), p);
+    __m128i over = _mm_cmpgt_epi32(p, maxY);
+    return _mm_or_si128(_mm_and_si128(over, maxY), _mm_andnot_si128(over, p));
+}
+
+// TimeToCover() for the 2 low lanes, capped at limit: (distance << PONG_TIME_SHIFT) / v
+// truncated. Both fit a double exactly and the true quotient is never within
+// 2^-45 below the next integer, so the truncated double quotient is the integer
+// division's. v == 0 gives inf or NaN, which the cap turns into limit.
+__attribute__((target("sse2")))
+static inline __m128i WallTimeSse2(__m128i distance, __m128i v, __m128d limit) {
+    __m128d d = _mm_mul_pd(_mm_cvtepi32_pd(distance), _mm_set1_pd((double)(1 << PONG_TIME_SHIFT)));
+    return _mm_cvttpd_epi32(_mm_min_pd(_mm_div_pd(d, _mm_cvtepi32_pd(v)), limit));
+}
+
+__attribute__((target("sse2")))
+static inline __m128i SelectSse2(__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Lanes in open play that only a wall keeps off the fast path, run through
+// pong_fixed's wall sweep: fly to the wall, reflect, fly out the rest of the tick.
+// Lanes that never reach the wall keep the straight flight, which is exact in
+// integers whatever the margin. Returns the lanes it resolved.
+__attribute__((target("sse2")))
+static __m128i WallsSse2(__m128i open, __m128i x0, __m128i y0, __m128i vx, __m128i vy,
+                         __m128i *x1, __m128i *y1, __m128i *vyOut, const FixedKernelConstants *k) {
+    const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi32(1);
+    const __m128i t = _mm_set1_epi32(k->t), bias = _mm_set1_epi32(1 << PONG_TIME_SHIFT);
+    const __m128i highHalves = _mm_set_epi32(-1, 0, -1, 0);
+    const __m128i topY = _mm_set1_epi32(k->topY), bottomY = _mm_set1_epi32(k->bottomY);
+    const __m128d limit = _mm_set1_pd((double)k->t + 1.0);
+
+    // Only balls between the walls; the reflected speed must fit the biased product too
+    __m128i ok = _mm_and_si128(_mm_cmpgt_epi32(y0, _mm_sub_epi32(topY, one)), _mm_cmpgt_epi32(_mm_add_epi32(bottomY, one), y0));
+    ok = _mm_and_si128(ok, _mm_cmpgt_epi32(_mm_set1_epi32(FIXED_KERNEL_MAX_SPEED), vy));
+    ok = _mm_and_si128(ok, open);
+
+    __m128i up = _mm_cmpgt_epi32(zero, vy), down = _mm_cmpgt_epi32(vy, zero);
+    __m128i wallY = SelectSse2(up, topY, bottomY);
+    __m128i distance = _mm_sub_epi32(wallY, y0);
+    __m128i hitTime = _mm_unpacklo_epi64(WallTimeSse2(distance, vy, limit),
+                                         WallTimeSse2(_mm_srli_si128(distance, 8), _mm_srli_si128(vy, 8), limit));
+    __m128i hit = _mm_and_si128(_mm_or_si128(up, down), _mm_cmpgt_epi32(_mm_add_epi32(t, one), hitTime));
+    hitTime = _mm_and_si128(hit, hitTime);      // 0 where nothing is hit: keeps the products in range
+
+    __m128i rest = _mm_sub_epi32(t, hitTime);
+    __m128i bounced = _mm_sub_epi32(zero, vy);
+    __m128i xWall = _mm_add_epi32(_mm_add_epi32(x0, TravelSse2(vx, hitTime, bias, highHalves)), TravelSse2(vx, rest, bias, highHalves));
+    __m128i yWall = _mm_add_epi32(wallY, TravelSse2(bounced, rest, bias, highHalves));
+
+    *x1 = SelectSse2(hit, xWall, *x1);
+    *y1 = SelectSse2(hit, yWall, *y1);
+    *vyOut = SelectSse2(hit, bounced, vy);
+
+    // Still clear of the paddle columns after the bounce
+    __m128i leftX = _mm_set1_epi32(k->leftX), rightX = _mm_set1_epi32(k->rightX);
+    return _mm_and_si128(ok, _mm_and_si128(_mm_cmpgt_epi32(*x1, leftX), _mm_cmpgt_epi32(rightX, *x1)));
+}
+
+__attribute__((target("sse2")))
+static void StepFixedSse2(PongBatch *batch, int first, int count, const PongInput *inputs, const FixedKernelConstants *k) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i t = _mm_set1_epi32(k->t), bias = _mm_set1_epi32(1 << PONG_TIME_SHIFT);
+    const __m128i highHalves = _mm_set_epi32(-1, 0, -1, 0);
+    const __m128i step = _mm_set1_epi32(k->paddleStep);
+    const __m128i maxY = _mm_set1_epi32(k->paddleMaxY);
+    const __m128i playing = _mm_set1_epi32(GAME_PLAYING), pause = _mm_set1_epi32(PONG_INPUT_PAUSE);
+    const __m128i minSpeed = _mm_set1_epi32(-FIXED_KERNEL_MAX_SPEED);
+    const __m128i lowY = _mm_set1_epi32(k->lowY), highY = _mm_set1_epi32(k->highY);
+    const __m128i leftX = _mm_set1_epi32(k->leftX), rightX = _mm_set1_epi32(k->rightX);
+    const int covered = count / 4 * 4;
+
+    for (int i = first; i < first + covered; i += 4) {
+        #define LOAD(p) _mm_loadu_si128((const __m128i *)(p))
+        __m128i in = LOAD(inputs + i);
+        __m128i p1Old = LOAD(batch->paddle1Y + i), p2Old = LOAD(batch->paddle2Y + i);
+        __m128i x0 = LOAD(batch->ballX + i), y0 = LOAD(batch->ballY + i);
+        __m128i vx = LOAD(batch->ballVX + i), vy = LOAD(batch->ballVY + i);
+        #undef LOAD
+        __m128i state = LoadStatesSse2(batch->gameState + i);
+
+        #define KEY_MASK(n) _mm_srai_epi32(_mm_slli_epi32(in, 31 - (n)), 31)
+        __m128i p1 = _mm_sub_epi32(_mm_add_epi32(p1Old, _mm_and_si128(step, KEY_MASK(1))), _mm_and_si128(step, KEY_MASK(0)));
+        __m128i p2 = _mm_sub_epi32(_mm_add_epi32(p2Old, _mm_and_si128(step, KEY_MASK(3))), _mm_and_si128(step, KEY_MASK(2)));
+        #undef KEY_MASK
+        p1 = ClampSse2(p1, maxY);
+        p2 = ClampSse2(p2, maxY);
+
+        __m128i x1 = _mm_add_epi32(x0, TravelSse2(vx, t, bias, highHalves));
+        __m128i y1 = _mm_add_epi32(y0, TravelSse2(vy, t, bias, highHalves));
+
+        // All ones in the lanes resolved here. The biased product needs no upper
+        // speed bound, only v > -2^24.
+        #define INSIDE(v, lo, hi) _mm_and_si128(_mm_cmpgt_epi32(v, lo), _mm_cmpgt_epi32(hi, v))
+        __m128i open = _mm_and_si128(_mm_cmpeq_epi32(state, playing), _mm_cmpeq_epi32(_mm_and_si128(in, pause), zero));
+        open = _mm_and_si128(open, _mm_and_si128(_mm_cmpgt_epi32(vx, minSpeed), _mm_cmpgt_epi32(vy, minSpeed)));
+        open = _mm_and_si128(open, _mm_and_si128(INSIDE(x0, leftX, rightX), INSIDE(x1, leftX, rightX)));
+        __m128i fast = _mm_and_si128(open, INSIDE(y1, lowY, highY));
+        #undef INSIDE
+        unsigned int fastBits = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(fast));
+
+        // Common case: the whole group in open play, nothing to keep
+        if (fastBits != 0xF) {
+            // Near a wall: bounce in the vector rather than leave it to StepOpenLane()
+            if (_mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(fast, open)))) {
+                __m128i vyOut;
+                fast = WallsSse2(open, x0, y0, vx, vy, &x1, &y1, &vyOut, k);
+                fastBits = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(fast));
+                _mm_storeu_si128((__m128i *)(batch->ballVY + i), SelectSse2(fast, vyOut, vy));
+            }
+            p1 = _mm_or_si128(_mm_and_si128(fast, p1), _mm_andnot_si128(fast, p1Old));
+            p2 = _mm_or_si128(_mm_and_si128(fast, p2), _mm_andnot_si128(fast, p2Old));
+            x1 = _mm_or_si128(_mm_and_si128(fast, x1), _mm_andnot_si128(fast, x0));
+            y1 = _mm_or_si128(_mm_and_si128(fast, y1), _mm_andnot_si128(fast, y0));
+        }
+        _mm_storeu_si128((__m128i *)(batch->paddle1Y + i), p1);
+        _mm_storeu_si128((__m128i *)(batch->paddle2Y + i), p2);
+        _mm_storeu_si128((__m128i *)(batch->ballX + i), x1);
+        _mm_storeu_si128((__m128i *)(batch->ballY + i), y1);
+        StoreSlowFlags(batch->slow + i, ~fastBits & 0xF, 4);
+    }
+
+    FIXED_LANES(batch, first + covered, count - covered, inputs, k);
+}
+
+// See TravelSse2; the blend takes the odd lanes' high halves directly. t may
+// differ per lane.
+__attribute__((target("avx2")))
+static inline __m256i TravelAvx2(__m256i v, __m256i t, __m256i bias) {
+    __m256i u = _mm256_add_epi32(v, bias);
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(u, t), 24);
+    __m256i odd = _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(u, 32), _mm256_srli_epi64(t, 32)), 8);
+    return _mm256_sub_epi32(_mm256_blend_epi32(even, odd, 0xAA), t);
+}
+
+// See WallTimeSse2
+__attribute__((target("avx2")))
+static inline __m128i WallTimeAvx2(__m128i distance, __m128i v, __m256d limit) {
+    __m256d d = _mm256_mul_pd(_mm256_cvtepi32_pd(distance), _mm256_set1_pd((double)(1 << PONG_TIME_SHIFT)));
+    return _mm256_cvttpd_epi32(_mm256_min_pd(_mm256_div_pd(d, _mm256_cvtepi32_pd(v)), limit));
+}
+
+// See WallsSse2
+__attribute__((target("avx2")))
+static __m256i WallsAvx2(__m256i open, __m256i x0, __m256i y0, __m256i vx, __m256i vy,
+                         __m256i *x1, __m256i *y1, __m256i *vyOut, const FixedKernelConstants *k) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i t = _mm256_set1_epi32(k->t), bias = _mm256_set1_epi32(1 << PONG_TIME_SHIFT);
+    const __m256i topY = _mm256_set1_epi32(k->topY), bottomY = _mm256_set1_epi32(k->bottomY);
+    const __m256d limit = _mm256_set1_pd((double)k->t + 1.0);
+
+    // Only balls between the walls; the reflected speed must fit the biased product too
+    __m256i ok = _mm256_and_si256(_mm256_cmpgt_epi32(y0, _mm256_sub_epi32(topY, _mm256_set1_epi32(1))),
+                                  _mm256_cmpgt_epi32(_mm256_add_epi32(bottomY, _mm256_set1_epi32(1)), y0));
+    ok = _mm256_and_si256(ok, _mm256_cmpgt_epi32(_mm256_set1_epi32(FIXED_KERNEL_MAX_SPEED), vy));
+    ok = _mm256_and_si256(ok, open);
+
+    __m256i up = _mm256_cmpgt_epi32(zero, vy), down = _mm256_cmpgt_epi32(vy, zero);
+    __m256i wallY = _mm256_blendv_epi8(bottomY, topY, up);
+    __m256i distance = _mm256_sub_epi32(wallY, y0);
+    __m256i hitTime = _mm256_set_m128i(WallTimeAvx2(_mm256_extracti128_si256(distance, 1), _mm256_extracti128_si256(vy, 1), limit),
+                                       WallTimeAvx2(_mm256_castsi256_si128(distance), _mm256_castsi256_si128(vy), limit));
+    __m256i hit = _mm256_and_si256(_mm256_or_si256(up, down), _mm256_cmpgt_epi32(_mm256_add_epi32(t, _mm256_set1_epi32(1)), hitTime));
+    hitTime = _mm256_and_si256(hit, hitTime);   // 0 where nothing is hit: keeps the products in range
+
+    __m256i rest = _mm256_sub_epi32(t, hitTime);
+    __m256i bounced = _mm256_sub_epi32(zero, vy);
+    __m256i xWall = _mm256_add_epi32(_mm256_add_epi32(x0, TravelAvx2(vx, hitTime, bias)), TravelAvx2(vx, rest, bias));
+    __m256i yWall = _mm256_add_epi32(wallY, TravelAvx2(bounced, rest, bias));
+
+    *x1 = _mm256_blendv_epi8(*x1, xWall, hit);
+    *y1 = _mm256_blendv_epi8(*y1, yWall, hit);
+    *vyOut = _mm256_blendv_epi8(vy, bounced, hit);
+
+    // Still clear of the paddle columns after the bounce
+    __m256i leftX = _mm256_set1_epi32(k->leftX), rightX = _mm256_set1_epi32(k->rightX);
+    return _mm256_and_si256(ok, _mm256_and_si256(_mm256_cmpgt_epi32(*x1, leftX), _mm256_cmpgt_epi32(rightX, *x1)));
+}
+
+// The same loop by hand in AVX2, 8 lanes at a time (the compiler's version of the
+// loop above widens to 32 lanes because of the byte arrays and spills heavily).
+__attribute__((target("avx2")))
+static void StepFixedAvx2(PongBatch *batch, int first, int count, const PongInput *inputs, const FixedKernelConstants *k) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i t = _mm256_set1_epi32(k->t), bias = _mm256_set1_epi32(1 << PONG_TIME_SHIFT);
+    const __m256i step = _mm256_set1_epi32(k->paddleStep);
+    const __m256i maxY = _mm256_set1_epi32(k->paddleMaxY);
+    const __m256i playing = _mm256_set1_epi32(GAME_PLAYING), pause = _mm256_set1_epi32(PONG_INPUT_PAUSE);
+    const __m256i minSpeed = _mm256_set1_epi32(-FIXED_KERNEL_MAX_SPEED);
+    const __m256i lowY = _mm256_set1_epi32(k->lowY), highY = _mm256_set1_epi32(k->highY);
+    const __m256i leftX = _mm256_set1_epi32(k->leftX), rightX = _mm256_set1_epi32(k->rightX);
+    const int covered = count / 8 * 8;
+
+    for (int i = first; i < first + covered; i += 8) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(inputs + i));
+        __m256i state = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(batch->gameState + i)));
+        #define LOAD(p) _mm256_loadu_si256((const __m256i *)(p))
+        __m256i p1Old = LOAD(batch->paddle1Y + i), p2Old = LOAD(batch->paddle2Y + i);
+        __m256i x0 = LOAD(batch->ballX + i), y0 = LOAD(batch->ballY + i);
+        __m256i vx = LOAD(batch->ballVX + i), vy = LOAD(batch->ballVY + i);
+        #undef LOAD
+
+        // Key bit n as an all-ones mask
+        #define KEY_MASK(n) _mm256_srai_epi32(_mm256_slli_epi32(in, 31 - (n)), 31)
+        __m256i p1 = _mm256_sub_epi32(_mm256_add_epi32(p1Old, _mm256_and_si256(step, KEY_MASK(1))), _mm256_and_si256(step, KEY_MASK(0)));
+        p1 = _mm256_min_epi32(_mm256_max_epi32(p1, zero), maxY);
+        __m256i p2 = _mm256_sub_epi32(_mm256_add_epi32(p2Old, _mm256_and_si256(step, KEY_MASK(3))), _mm256_and_si256(step, KEY_MASK(2)));
+        p2 = _mm256_min_epi32(_mm256_max_epi32(p2, zero), maxY);
+        #undef KEY_MASK
+
+        __m256i x1 = _mm256_add_epi32(x0, TravelAvx2(vx, t, bias));
+        __m256i y1 = _mm256_add_epi32(y0, TravelAvx2(vy, t, bias));
+
+        // All ones in the lanes resolved here (see StepFixedSse2)
+        #define INSIDE(v, lo, hi) _mm256_and_si256(_mm256_cmpgt_epi32(v, lo), _mm256_cmpgt_epi32(hi, v))
+        __m256i open = _mm256_and_si256(_mm256_cmpeq_epi32(state, playing), _mm256_cmpeq_epi32(_mm256_and_si256(in, pause), zero));
+        open = _mm256_and_si256(open, _mm256_and_si256(_mm256_cmpgt_epi32(vx, minSpeed), _mm256_cmpgt_epi32(vy, minSpeed)));
+        open = _mm256_and_si256(open, _mm256_and_si256(INSIDE(x0, leftX, rightX), INSIDE(x1, leftX, rightX)));
+        __m256i fast = _mm256_and_si256(open, INSIDE(y1, lowY, highY));
+        #undef INSIDE
+        unsigned int fastBits = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(fast));
+
+        if (fastBits != 0xFF) {
+            // Near a wall (see StepFixedSse2)
+            if (_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(fast, open)))) {
+                __m256i vyOut;
+                fast = WallsAvx2(open, x0, y0, vx, vy, &x1, &y1, &vyOut, k);
+                fastBits = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(fast));
+                _mm256_storeu_si256((__m256i *)(batch->ballVY + i), _mm256_blendv_epi8(vy, vyOut, fast));
+            }
+            p1 = _mm256_blendv_epi8(p1Old, p1, fast);
+            p2 = _mm256_blendv_epi8(p2Old, p2, fast);
+            x1 = _mm256_blendv_epi8(x0, x1, fast);
+            y1 = _mm256_blendv_epi8(y0, y1, fast);
+        }
+        _mm256_storeu_si256((__m256i *)(batch->paddle1Y + i), p1);
+        _mm256_storeu_si256((__m256i *)(batch->paddle2Y + i), p2);
+        _mm256_storeu_si256((__m256i *)(batch->ballX + i), x1);
+        _mm256_storeu_si256((__m256i *)(batch->ballY + i), y1);
+        StoreSlowFlags(batch->slow + i, ~fastBits & 0xFF, 8);
+    }
+
+    FIXED_LANES(batch, first + covered, count - covered, inputs, k);
+}
+
+#endif // PONG_SIMD_X86
+
+#elif defined(PONG_SIMD_X86)
+
+// ---------- SSE2: 4 lanes ----------
+#define KERNEL_NAME         StepSse2
+#define KERNEL_ATTR         __attribute__((target("sse2")))
+#define W                   4
+#define ALL_LANES           0xF
+#define VF                  __m128
+#define VI                  __m128i
+#define V_SET1(x)           _mm_set1_ps(x)
+#define V_LOAD(p)           _mm_loadu_ps(p)
+#define V_STORE(p, v)       _mm_storeu_ps(p, v)
+#define V_ADD(a, b)         _mm_add_ps(a, b)
+#define V_SUB(a, b)         _mm_sub_ps(a, b)
+#define V_MUL(a, b)         _mm_mul_ps(a, b)
+#define V_DIV(a, b)         _mm_div_ps(a, b)
+#define V_SQRT(a)           _mm_sqrt_ps(a)
+#define V_MIN(a, b)         _mm_min_ps(a, b)     // (a < b) ? a : b, like the scalar ternaries
+#define V_MAX(a, b)         _mm_max_ps(a, b)     // (a > b) ? a : b
+#define V_AND(a, b)         _mm_and_ps(a, b)
+#define V_OR(a, b)          _mm_or_ps(a, b)
+#define V_ANDNOT(a, b)      _mm_andnot_ps(a, b)  // ~a & b
+#define V_CMPLT(a, b)       _mm_cmplt_ps(a, b)
+#define V_CMPLE(a, b)       _mm_cmple_ps(a, b)
+#define V_CMPGT(a, b)       _mm_cmpgt_ps(a, b)
+#define V_CMPGE(a, b)       _mm_cmpge_ps(a, b)
+#define V_CMPEQ(a, b)       _mm_cmpeq_ps(a, b)
+#define V_CMPNEQ(a, b)      _mm_cmpneq_ps(a, b)
+#define V_SELECT(m, a, b)   _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#define V_MOVEMASK(m)       _mm_movemask_ps(m)
+#define VI_SET1(x)          _mm_set1_epi32(x)
+#define VI_LOAD(p)          _mm_loadu_si128((const __m128i *)(p))
+#define VI_AND(a, b)        _mm_and_si128(a, b)
+#define VI_CMPEQ(a, b)      _mm_cmpeq_epi32(a, b)
+#define VI_AS_MASK(a)       _mm_castsi128_ps(a)
+#define VI_BIT(v, n)        _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(v, n), _mm_set1_epi32(1)))
+#define VI_LOAD_STATE(p)    LoadStatesSse2(p)
+
+#include "pong_simd_kernel.h"
+
+#undef KERNEL_NAME
+#undef KERNEL_ATTR
+#undef W
+#undef ALL_LANES
+#undef VF
+#undef VI
+#undef V_SET1
+#undef V_LOAD
+#undef V_STORE
+#undef V_ADD
+#undef V_SUB
+#undef V_MUL
+#undef V_DIV
+#undef V_SQRT
+#undef V_MIN
+#undef V_MAX
+#undef V_AND
+#undef V_OR
+#undef V_ANDNOT
+#undef V_CMPLT
+#undef V_CMPLE
+#undef V_CMPGT
+#undef V_CMPGE
+#undef V_CMPEQ
+#undef V_CMPNEQ
+#undef V_SELECT
+#undef V_MOVEMASK
+#undef VI_SET1
+#undef VI_LOAD
+#undef VI_AND
+#undef VI_CMPEQ
+#undef VI_AS_MASK
+#undef VI_BIT
+#undef VI_LOAD_STATE
+
+// ---------- AVX2: 8 lanes ----------
+#define KERNEL_NAME         StepAvx2
+#define KERNEL_ATTR         __attribute__((target("avx2")))
+#define W                   8
+#define ALL_LANES           0xFF
+#define VF                  __m256
+#define VI                  __m256i
+#define V_SET1(x)           _mm256_set1_ps(x)
+#define V_LOAD(p)           _mm256_loadu_ps(p)
+#define V_STORE(p, v)       _mm256_storeu_ps(p, v)
+#define V_ADD(a, b)         _mm256_add_ps(a, b)
+#define V_SUB(a, b)         _mm256_sub_ps(a, b)
+#define V_MUL(a, b)         _mm256_mul_ps(a, b)
+#define V_DIV(a, b)         _mm256_div_ps(a, b)
+#define V_SQRT(a)           _mm256_sqrt_ps(a)
+#define V_MIN(a, b)         _mm256_min_ps(a, b)
+#define V_MAX(a, b)         _mm256_max_ps(a, b)
+#define V_AND(a, b)         _mm256_and_ps(a, b)
+#define V_OR(a, b)          _mm256_or_ps(a, b)
+#define V_ANDNOT(a, b)      _mm256_andnot_ps(a, b)
+#define V_CMPLT(a, b)       _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define V_CMPLE(a, b)       _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+#define V_CMPGT(a, b)       _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+#define V_CMPGE(a, b)       _mm256_cmp_ps(a, b, _CMP_GE_OQ)
+#define V_CMPEQ(a, b)       _mm256_cmp_ps(a, b, _CMP_EQ_OQ)
+#define V_CMPNEQ(a, b)      _mm256_cmp_ps(a, b, _CMP_NEQ_UQ)
+#define V_SELECT(m, a, b)   _mm256_blendv_ps(b, a, m)
+#define V_MOVEMASK(m)       _mm256_movemask_ps(m)
+#define VI_SET1(x)          _mm256_set1_epi32(x)
+#define VI_LOAD(p)          _mm256_loadu_si256((const __m256i *)(p))
+#define VI_AND(a, b)        _mm256_and_si256(a, b)
+#define VI_CMPEQ(a, b)      _mm256_cmpeq_epi32(a, b)
+#define VI_AS_MASK(a)       _mm256_castsi256_ps(a)
+#define VI_BIT(v, n)        _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(v, n), _mm256_set1_epi32(1)))
+#define VI_LOAD_STATE(p)    _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p)))
+
+#include "pong_simd_kernel.h"
+
+#endif // PONG_FIXED_POINT
+
+PongSimdLevel pong_simd_best(void) {
+    // Detected once. Threads racing here all compute the same answer, so relaxed
+    // loads and stores are enough; the atomic only makes the race well defined.
+    static _Atomic int best = -1;
+
+    int level = atomic_load_explicit(&best, memory_order_relaxed);
+    if (level < 0) {
+        level = PONG_SIMD_SCALAR;
+#ifdef PONG_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse2")) level = PONG_SIMD_SSE2;
+        if (__builtin_cpu_supports("avx2")) level = PONG_SIMD_AVX2;
+#endif
+        atomic_store_explicit(&best, level, memory_order_relaxed);
+    }
+
+    return (PongSimdLevel)level;
+}
+
+const char *pong_simd_name(PongSimdLevel level) {
+    switch (level) {
+        case PONG_SIMD_SCALAR: return "scalar";
+        case PONG_SIMD_SSE2:   return "sse2";
+        case PONG_SIMD_AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+int pong_simd_step(PongSimdLevel level, PongBatch *batch, int first, int count, const PongInput *inputs, float dt) {
+    // Never run a kernel the CPU lacks, whatever the caller asked for
+    if (level > pong_simd_best()) level = pong_simd_best();
+
+#ifdef PONG_FIXED_POINT
+    FixedKernelConstants k;
+    if (!FixedKernelSetup(dt, &k)) {
+        memset(batch->slow + first, 1, (size_t)count);
+        return count;
+    }
+#ifdef PONG_SIMD_X86
+    if (level == PONG_SIMD_AVX2) {
+        StepFixedAvx2(batch, first, count, inputs, &k);
+        return count;
+    }
+    if (level == PONG_SIMD_SSE2) {
+        StepFixedSse2(batch, first, count, inputs, &k);
+        return count;
+    }
+#endif
+    FIXED_LANES(batch, first, count, inputs, &k);
+    return count;
+#else
+    switch (level) {
+#ifdef PONG_SIMD_X86
+        case PONG_SIMD_AVX2: return StepAvx2(batch, first, count, inputs, dt);
+        case PONG_SIMD_SSE2: return StepSse2(batch, first, count, inputs, dt);
+#endif
+        default: return 0;
+    }
+#endif
+}
@@ -0,0 +1,18 @@
+#ifndef PONG_SIMD_H
+#define PONG_SIMD_H
+
+#include "pong_batch.h"
+
+// Internal to the batch simulator: vector kernels behind pong_batch_step().
+
+// Lanes closer than this (in px) to a paddle column at the end of the tick take
+// the exact pong_step() path, so the fast paths never have to decide a contact there.
+#define FAST_PATH_MARGIN 1.0f
+
+// Run the kernel for level over lanes [first, first + count), rounded down to a
+// multiple of its width; returns how many lanes from first it covered (0 for
+// PONG_SIMD_SCALAR). Covered lanes it could not resolve are flagged in batch->slow.
+// PONG_FIXED_POINT builds run an integer kernel that always covers every lane.
+int pong_simd_step(PongSimdLevel level, PongBatch *batch, int first, int count, const PongInput *inputs, float dt);
+
+#endif // PONG_SIMD_H
@@ -0,0 +1,199 @@
+// PongBatch SIMD kernel body - included by pong_simd.c once per instruction set.
+// Not a public header: the includer defines KERNEL_NAME, KERNEL_ATTR, the vector
+// types VF/VI, the lane count W and the V_* operations before including it.
+//
+// Every expression below mirrors the scalar code in pong.c operation for operation
+// (no fused multiply-add, same operand order), so a lane resolved here holds the
+// same bits pong_step() would have produced. Lanes the kernel cannot decide are
+// flagged in slow[] and left untouched for pong_step().
+
+KERNEL_ATTR int KERNEL_NAME(PongBatch *batch, int first, int count, const PongInput *inputs, float dt) {
+    float *ballX = batch->ballX;
+    float *ballY = batch->ballY;
+    float *ballVX = batch->ballVX;
+    float *ballVY = batch->ballVY;
+    float *paddle1Y = batch->paddle1Y;
+    float *paddle2Y = batch->paddle2Y;
+    const unsigned char *gameState = batch->gameState;
+    unsigned char *slow = batch->slow;
+
+    const VF zero = V_SET1(0.0f);
+    const VF one = V_SET1(1.0f);
+    const VF minusOne = V_SET1(-1.0f);
+    const VF vdt = V_SET1(dt);
+    const VF r = V_SET1(BALL_RADIUS);
+    const VF bottomY = V_SET1((float)ARENA_HEIGHT - BALL_RADIUS);      // Same value as screenHeight - r
+    const VF lowY = V_SET1(BALL_RADIUS + FAST_PATH_MARGIN);
+    const VF highY = V_SET1(ARENA_HEIGHT - BALL_RADIUS - FAST_PATH_MARGIN);
+    const VF allBits = V_CMPEQ(zero, zero);
+    const VF paddleStep = V_SET1(PADDLE_SPEED * dt);
+    const VF paddleMaxY = V_SET1(ARENA_HEIGHT - PADDLE_HEIGHT);
+    const VF paddleHeight = V_SET1(PADDLE_HEIGHT);
+    const VF paddleHalf = V_SET1(PADDLE_HEIGHT / 2);
+    const VF maxDeflection = V_SET1(MAX_DEFLECTION_ANGLE);
+    const VF speedIncrement = V_SET1(BALL_SPEED_INCREMENT);
+    const VF maxSpeed = V_SET1(BALL_MAX_SPEED);
+
+    // Open flight must stay this far from the paddle columns (see FAST_PATH_MARGIN)
+    const VF leftX = V_SET1(PADDLE1_X + PADDLE_WIDTH + BALL_RADIUS + FAST_PATH_MARGIN);
+    const VF rightX = V_SET1(PADDLE2_X - BALL_RADIUS - FAST_PATH_MARGIN);
+
+    // Paddle rectangles grown by the ball radius, and where the nudge puts the ball
+    const VF p1MinX = V_SET1(PADDLE1_X - BALL_RADIUS);
+    const VF p1MaxX = V_SET1(PADDLE1_X + PADDLE_WIDTH + BALL_RADIUS);
+    const VF p2MinX = V_SET1(PADDLE2_X - BALL_RADIUS);
+    const VF p2MaxX = V_SET1(PADDLE2_X + PADDLE_WIDTH + BALL_RADIUS);
+
+    const int covered = count / W * W;
+
+    for (int i = first; i < first + covered; i += W) {
+        VI in = VI_LOAD(inputs + i);
+        VF playing = V_AND(VI_AS_MASK(VI_CMPEQ(VI_LOAD_STATE(gameState + i), VI_SET1(GAME_PLAYING))),
+                           VI_AS_MASK(VI_CMPEQ(VI_AND(in, VI_SET1(PONG_INPUT_PAUSE)), VI_SET1(0))));
+
+        // --- Paddles ---
+        VF p1Old = V_LOAD(paddle1Y + i), p2Old = V_LOAD(paddle2Y + i);
+        VF p1 = V_SUB(p1Old, V_MUL(paddleStep, VI_BIT(in, 0)));
+        p1 = V_ADD(p1, V_MUL(paddleStep, VI_BIT(in, 1)));
+        p1 = V_MIN(paddleMaxY, V_MAX(zero, p1));
+        VF p2 = V_SUB(p2Old, V_MUL(paddleStep, VI_BIT(in, 2)));
+        p2 = V_ADD(p2, V_MUL(paddleStep, VI_BIT(in, 3)));
+        p2 = V_MIN(paddleMaxY, V_MAX(zero, p2));
+
+        VF x0 = V_LOAD(ballX + i), y0 = V_LOAD(ballY + i);
+        VF vx = V_LOAD(ballVX + i), vy = V_LOAD(ballVY + i);
+
+        // Open flight: straight line for the whole tick
+        VF xOpen = V_ADD(x0, V_MUL(vx, vdt));
+        VF yOpen = V_ADD(y0, V_MUL(vy, vdt));
+        VF columnsClear = V_AND(V_AND(V_CMPGT(x0, leftX), V_CMPLT(x0, rightX)),
+                                V_AND(V_CMPGT(xOpen, leftX), V_CMPLT(xOpen, rightX)));
+
+        // Common case first: every lane clear of walls and paddles by a margin, no divisions needed
+        VF quick = V_AND(playing, V_AND(columnsClear, V_AND(V_CMPGT(yOpen, lowY), V_CMPLT(yOpen, highY))));
+        if (V_MOVEMASK(quick) == ALL_LANES) {
+            V_STORE(paddle1Y + i, p1);
+            V_STORE(paddle2Y + i, p2);
+            V_STORE(ballX + i, xOpen);
+            V_STORE(ballY + i, yOpen);
+            StoreSlowFlags(slow + i, 0, W);
+            continue;
+        }
+
+        // --- Walls: the first event the scalar sweep would look at ---
+        VF up = V_CMPLT(vy, zero), down = V_CMPGT(vy, zero);
+        VF tWall = V_MAX(zero, V_DIV(V_SUB(V_SELECT(up, r, bottomY), y0), vy));
+        VF hitTop = V_AND(up, V_CMPLE(tWall, vdt));
+        VF hitBottom = V_AND(down, V_CMPLE(tWall, vdt));
+        VF noWall = V_ANDNOT(V_OR(hitTop, hitBottom), allBits);
+        VF open = V_AND(noWall, columnsClear);
+
+        // One wall bounce: fly to the wall, reflect, fly out the rest of the tick
+        VF yWall = V_SELECT(hitTop, r, bottomY);
+        VF xWall = V_ADD(x0, V_MUL(vx, tWall));
+        VF vyWall = V_MUL(vy, minusOne);
+        VF restWall = V_SUB(vdt, tWall);
+        VF tSecond = V_MAX(zero, V_DIV(V_SUB(V_SELECT(hitTop, bottomY, r), yWall), vyWall));
+        VF xWallEnd = V_ADD(xWall, V_MUL(vx, restWall));
+        VF yWallEnd = V_ADD(yWall, V_MUL(vyWall, restWall));
+        VF bounce = V_AND(V_ANDNOT(noWall, allBits),
+                          V_AND(V_CMPGT(tSecond, restWall),
+                                V_AND(V_AND(V_CMPGT(x0, leftX), V_CMPLT(x0, rightX)),
+                                      V_AND(V_CMPGT(xWallEnd, leftX), V_CMPLT(xWallEnd, rightX)))));
+
+        // --- Paddle face hit: slab test against the paddle the ball is heading to ---
+        VF left = V_CMPLT(vx, zero);
+        VF paddleY = V_SELECT(left, p1, p2);
+        VF minX = V_SELECT(left, p1MinX, p2MinX), maxX = V_SELECT(left, p1MaxX, p2MaxX);
+        VF tx1 = V_DIV(V_SUB(minX, x0), vx), tx2 = V_DIV(V_SUB(maxX, x0), vx);
+        VF ty1 = V_DIV(V_SUB(V_SUB(paddleY, r), y0), vy);
+        VF ty2 = V_DIV(V_SUB(V_ADD(V_ADD(paddleY, paddleHeight), r), y0), vy);
+        VF tEnter = V_MAX(V_MIN(tx1, tx2), V_MIN(ty1, ty2));
+        VF tExit = V_MIN(V_MAX(tx1, tx2), V_MAX(ty1, ty2));
+        VF outside = V_SELECT(left, V_CMPGT(x0, maxX), V_CMPLT(x0, minX));
+        VF yHit = V_ADD(y0, V_MUL(vy, tEnter));
+        VF face = V_AND(V_AND(noWall, outside), V_AND(V_CMPNEQ(vx, zero), V_CMPNEQ(vy, zero)));
+        face = V_AND(face, V_AND(V_CMPLE(tEnter, tExit), V_CMPGE(tExit, zero)));
+        face = V_AND(face, V_AND(V_CMPLE(tEnter, vdt), V_CMPGE(tEnter, zero)));
+        face = V_AND(face, V_AND(V_CMPGE(yHit, paddleY), V_CMPLE(yHit, V_ADD(paddleY, paddleHeight))));
+        face = V_AND(face, playing);
+
+        VF xOut = xOpen, yOut = yOpen, vxOut = vx, vyOut = vy;
+        VF done = V_AND(playing, open);
+
+        xOut = V_SELECT(bounce, xWallEnd, xOut);
+        yOut = V_SELECT(bounce, yWallEnd, yOut);
+        vyOut = V_SELECT(bounce, vyWall, vyOut);
+        done = V_OR(done, V_AND(playing, bounce));
+
+        int faceBits = V_MOVEMASK(face);
+        if (faceBits) {
+            // Deflection: clamp the hit fraction, scale to an angle, speed up to the cap
+            VF t = V_DIV(V_SUB(yHit, V_ADD(paddleY, paddleHalf)), paddleHalf);
+            t = V_MIN(one, V_MAX(minusOne, t));
+            VF angle = V_MUL(t, maxDeflection);
+            VF speed = V_SQRT(V_ADD(V_MUL(vx, vx), V_MUL(vy, vy)));
+            VF newSpeed = V_MIN(V_MUL(speed, speedIncrement), maxSpeed);
+
+            VF side = V_SELECT(left, one, minusOne);
+#ifdef PONG_LIBM_TRIG
+            // libm trig on the (rare) hit lanes only, so the angles match pong_step()
+            float angles[W], cosines[W], sines[W];
+            V_STORE(angles, angle);
+            for (int k = 0; k < W; k++) {
+                cosines[k] = (faceBits >> k & 1) ? cosf(angles[k]) : 1.0f;
+                sines[k] = (faceBits >> k & 1) ? sinf(angles[k]) : 0.0f;
+            }
+            VF dirX = V_MUL(side, V_LOAD(cosines));
+            VF dirY = V_LOAD(sines);
+            VF inverseLength = V_DIV(one, V_SQRT(V_ADD(V_MUL(dirX, dirX), V_MUL(dirY, dirY))));
+            VF vxHit = V_MUL(V_MUL(dirX, inverseLength), newSpeed);
+            VF vyHit = V_MUL(V_MUL(dirY, inverseLength), newSpeed);
+#else
+            // The pong_fastmath.h polynomials, step for step
+            VF u = V_MUL(angle, angle);
+            VF sine = V_SET1(PONG_SIN_C4);
+            sine = V_ADD(V_MUL(sine, u), V_SET1(PONG_SIN_C3));
+            sine = V_ADD(V_MUL(sine, u), V_SET1(PONG_SIN_C2));
+            sine = V_ADD(V_MUL(sine, u), V_SET1(PONG_SIN_C1));
+            sine = V_ADD(V_MUL(sine, u), V_SET1(PONG_SIN_C0));
+            sine = V_MUL(sine, angle);
+            VF cosine = V_SET1(PONG_COS_C5);
+            cosine = V_ADD(V_MUL(cosine, u), V_SET1(PONG_COS_C4));
+            cosine = V_ADD(V_MUL(cosine, u), V_SET1(PONG_COS_C3));
+            cosine = V_ADD(V_MUL(cosine, u), V_SET1(PONG_COS_C2));
+            cosine = V_ADD(V_MUL(cosine, u), V_SET1(PONG_COS_C1));
+            cosine = V_ADD(V_MUL(cosine, u), V_SET1(PONG_COS_C0));
+            VF vxHit = V_MUL(V_MUL(side, cosine), newSpeed);
+            VF vyHit = V_MUL(sine, newSpeed);
+#endif
+
+            // Nudge onto the face, then fly out the rest of the tick
+            VF xNudge = V_SELECT(left, V_SET1(PADDLE1_X + PADDLE_WIDTH + BALL_RADIUS), V_SET1(PADDLE2_X - BALL_RADIUS));
+            VF rest = V_SUB(vdt, tEnter);
+            VF tAfter = V_MAX(zero, V_DIV(V_SUB(V_SELECT(V_CMPLT(vyHit, zero), r, bottomY), yHit), vyHit));
+            VF clearAfter = V_OR(V_CMPEQ(vyHit, zero), V_CMPGT(tAfter, rest));
+            VF xEnd = V_ADD(xNudge, V_MUL(vxHit, rest));
+            VF yEnd = V_ADD(yHit, V_MUL(vyHit, rest));
+            clearAfter = V_AND(clearAfter, V_AND(V_CMPGT(xEnd, leftX), V_CMPLT(xEnd, rightX)));
+            face = V_AND(face, clearAfter);
+
+            xOut = V_SELECT(face, xEnd, xOut);
+            yOut = V_SELECT(face, yEnd, yOut);
+            vxOut = V_SELECT(face, vxHit, vxOut);
+            vyOut = V_SELECT(face, vyHit, vyOut);
+            done = V_OR(done, face);
+        }
+
+        V_STORE(paddle1Y + i, V_SELECT(done, p1, p1Old));
+        V_STORE(paddle2Y + i, V_SELECT(done, p2, p2Old));
+        V_STORE(ballX + i, V_SELECT(done, xOut, x0));
+        V_STORE(ballY + i, V_SELECT(done, yOut, y0));
+        V_STORE(ballVX + i, V_SELECT(done, vxOut, vx));
+        V_STORE(ballVY + i, V_SELECT(done, vyOut, vy));
+
+        StoreSlowFlags(slow + i, ~V_MOVEMASK(done) & ALL_LANES, W);
+    }
+
+    return covered;
+}
@@ -0,0 +1,201 @@
+#include <string.h>
+
+#include "pong_clock.h"
+#include "pong_snapshot.h"
+
+#define FIELD_COUNT 6
+
+// Fixed-point ranges: value = (raw + min) / PONG_SNAPSHOT_UNITS
+typedef struct {
+    int32_t min;
+    int bits;
+} FieldRange;
+
+static const FieldRange ranges[FIELD_COUNT] = {
+    { -256 * 64, 17 },      // Ball x
+    { -64 * 64, 16 },       // Ball y
+    { -2048 * 64, 18 },     // Ball velocity x
+    { -2048 * 64, 18 },     // Ball velocity y
+    { -64 * 64, 16 },       // Player 1 y
+    { -64 * 64, 16 },       // Player 2 y
+};
+
+static const int residualBits[4] = { 4, 8, 12, 20 };
+
+typedef struct {
+    unsigned char *out;
+    size_t cap;
+    size_t bytes;
+    uint64_t acc;
+    int count;
+    bool overflow;
+} BitWriter;
+
+typedef struct {
+    const unsigned char *in;
+    size_t size;
+    size_t bytes;
+    uint64_t acc;
+    int count;
+    bool underflow;
+} BitReader;
+
+static void PutBits(BitWriter *w, uint32_t value, int bits) {
+    w->acc |= (uint64_t)value << w->count;
+    w->count += bits;
+    while (w->count >= 8) {
+        if (w->bytes < w->cap) w->out[w->bytes] = (unsigned char)w->acc;
+        else w->overflow = true;
+        w->bytes++;
+        w->acc >>= 8;
+        w->count -= 8;
+    }
+}
+
+static size_t FinishBits(BitWriter *w) {
+    if (w->count > 0) PutBits(w, 0, 8 - w->count);
+    return w->overflow ? 0 : w->bytes;
+}
+
+static uint32_t GetBits(BitReader *r, int bits) {
+    while (r->count < bits) {
+        if (r->bytes < r->size) r->acc |= (uint64_t)r->in[r->bytes] << r->count;
+        else r->underflow = true;
+        r->bytes++;
+        r->count += 8;
+    }
+    uint32_t value = (uint32_t)(r->acc & ((1ull << bits) - 1));
+    r->acc >>= bits;
+    r->count -= bits;
+    return value;
+}
+
+static int32_t Quantize(float value, const FieldRange *range) {
+    // Clamp before converting so NaN and huge values cannot overflow; round half away from zero
+    float scaled = value * PONG_SNAPSHOT_UNITS;
+    float lo = (float)range->min, hi = (float)(range->min + (1 << range->bits) - 1);
+    if (!(scaled >= lo)) scaled = lo;
+    if (scaled > hi) scaled = hi;
+    return (int32_t)(scaled + ((scaled < 0.0f) ? -0.5f : 0.5f));
+}
+
+static void Gather(const PongState *state, int32_t *fields) {
+    float values[FIELD_COUNT] = { state->ball.position.x, state->ball.position.y, state->ball.velocity.x,
+                                  state->ball.velocity.y, state->player1.position.y, state->player2.position.y };
+    for (int f = 0; f < FIELD_COUNT; f++) fields[f] = Quantize(values[f], &ranges[f]);
+}
+
+static void Scatter(PongState *state, const int32_t *fields) {
+    state->ball.position = (Vector2){ fields[0] / PONG_SNAPSHOT_UNITS, fields[1] / PONG_SNAPSHOT_UNITS };
+    state->ball.velocity = (Vector2){ fields[2] / PONG_SNAPSHOT_UNITS, fields[3] / PONG_SNAPSHOT_UNITS };
+    state->player1.position.y = fields[4] / PONG_SNAPSHOT_UNITS;
+    state->player2.position.y = fields[5] / PONG_SNAPSHOT_UNITS;
+}
+
+void pong_snapshot_quantize(PongState *state) {
+    int32_t fields[FIELD_COUNT];
+    Gather(state, fields);
+    Scatter(state, fields);
+}
+
+static int64_t FloorDiv(int64_t a, int64_t b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+// What the receiver expects each field to be: the ball keeps flying, the rest stays put
+static void Predict(const int32_t *base, uint32_t baseTicks, int32_t *predicted) {
+    memcpy(predicted, base, sizeof(int32_t) * FIELD_COUNT);
+    predicted[0] += (int32_t)FloorDiv((int64_t)base[2] * baseTicks, PONG_TICK_RATE);
+    predicted[1] += (int32_t)FloorDiv((int64_t)base[3] * baseTicks, PONG_TICK_RATE);
+}
+
+static bool SameMeta(const PongState *a, const PongState *b) {
+    return a->score1 == b->score1 && a->score2 == b->score2 && a->gameState == b->gameState &&
+           a->serveDirection == b->serveDirection && a->serveJustHappened == b->serveJustHappened &&
+           a->rngCounter == b->rngCounter;
+}
+
+size_t pong_snapshot_encode(const PongState *state, const PongState *base, uint32_t baseTicks, unsigned char *out, size_t cap) {
+    BitWriter w = { .out = out, .cap = cap };
+    int32_t fields[FIELD_COUNT];
+    Gather(state, fields);
+
+    bool meta = !base || !SameMeta(state, base);
+    PutBits(&w, meta, 1);
+    if (meta) {
+        PutBits(&w, (uint32_t)state->score1 & 0xFF, 8);
+        PutBits(&w, (uint32_t)state->score2 & 0xFF, 8);
+        PutBits(&w, (uint32_t)state->gameState, 3);
+        PutBits(&w, state->serveDirection > 0, 1);
+        PutBits(&w, state->serveJustHappened, 1);
+        PutBits(&w, state->rngCounter, 32);
+    }
+
+    if (!base) {
+        for (int f = 0; f < FIELD_COUNT; f++) PutBits(&w, (uint32_t)(fields[f] - ranges[f].min), ranges[f].bits);
+        return FinishBits(&w);
+    }
+
+    int32_t baseFields[FIELD_COUNT], predicted[FIELD_COUNT];
+    Gather(base, baseFields);
+    Predict(baseFields, baseTicks, predicted);
+
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        int32_t residual = fields[f] - predicted[f];
+        uint32_t zigzag = ((uint32_t)residual << 1) ^ (uint32_t)(residual >> 31);
+        if (zigzag == 0) {
+            PutBits(&w, 0, 1);
+            continue;
+        }
+
+        int width = 0;
+        while (zigzag >> residualBits[width]) width++;     // Always fits in 20 bits: fields are at most 18
+        PutBits(&w, 1, 1);
+        PutBits(&w, (uint32_t)width, 2);
+        PutBits(&w, zigzag, residualBits[width]);
+    }
+    return FinishBits(&w);
+}
+
+bool pong_snapshot_decode(PongState *state, const PongState *base, uint32_t baseTicks, const unsigned char *in, size_t size) {
+    BitReader r = { .in = in, .size = size };
+    PongState decoded = base ? *base : *state;
+    int32_t fields[FIELD_COUNT];
+
+    if (GetBits(&r, 1)) {
+        decoded.score1 = (int)GetBits(&r, 8);
+        decoded.score2 = (int)GetBits(&r, 8);
+        uint32_t gameState = GetBits(&r, 3);
+        if (gameState > GAME_OVER) return false;
+        decoded.gameState = (GameState)gameState;
+        decoded.serveDirection = GetBits(&r, 1) ? 1 : -1;
+        decoded.serveJustHappened = GetBits(&r, 1) != 0;
+        decoded.rngCounter = GetBits(&r, 32);
+    } else if (!base) {
+        return false;
+    }
+
+    if (!base) {
+        for (int f = 0; f < FIELD_COUNT; f++) fields[f] = (int32_t)GetBits(&r, ranges[f].bits) + ranges[f].min;
+    } else {
+        int32_t baseFields[FIELD_COUNT];
+        Gather(base, baseFields);
+        Predict(baseFields, baseTicks, fields);
+
+        for (int f = 0; f < FIELD_COUNT; f++) {
+            if (!GetBits(&r, 1)) continue;
+            uint32_t zigzag = GetBits(&r, residualBits[GetBits(&r, 2)]);
+            fields[f] += (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+        }
+    }
+
+    // Trailing padding only; a residual that lands outside a field's range is corrupt
+    if (r.underflow || r.bytes != size) return false;
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        if (fields[f] < ranges[f].min || fields[f] >= ranges[f].min + (1 << ranges[f].bits)) return false;
+    }
+
+    Scatter(&decoded, fields);
+    *state = decoded;
+    return true;
+}
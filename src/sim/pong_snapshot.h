@@ -0,0 +1,51 @@
+#ifndef PONG_SNAPSHOT_H
+#define PONG_SNAPSHOT_H
+
+#include <stddef.h>
+
+#include "pong.h"
+
+/*
+*  Snapshot codec
+*  ----------------------------------------------------------------------------------
+*  Bit-packed match state for the wire. Positions and velocities are fixed point
+*  at 1/64 px (px/s), on ranges that cover the 1280x720 arena plus the margin a
+*  ball reaches before a goal is scored:
+*
+*  ball x            17 bits   -256 .. 1536 px
+*  ball y, paddle y  16 bits   -64 .. 784 px
+*  ball velocity     18 bits   -2048 .. 2048 px/s per axis
+*
+*  Against a baseline (a snapshot the receiver acknowledged, baseTicks ago) each
+*  of the six values is sent as its residual from a prediction: the ball from
+*  the baseline extrapolated along its velocity, everything else unchanged. A
+*  residual of zero costs one bit; otherwise a 2-bit width class picks 4, 8, 12 or
+*  20 bits of zigzag value. Scores, game state, serve fields and the RNG counter
+*  ride in a block that is sent only when one of them changed.
+*
+*  The codec is exact only for states already on the grid, so whoever runs the
+*  authoritative simulation calls pong_snapshot_quantize() after every step - and
+*  a client predicting the same match does the same to stay bit-identical.
+*
+*  unsigned char buf[PONG_SNAPSHOT_MAX];
+*  size_t n = pong_snapshot_encode(&state, &acked, ticksSinceAcked, buf, sizeof(buf));
+*  pong_snapshot_decode(&copy, &acked, ticksSinceAcked, buf, n);
+*/
+
+#define PONG_SNAPSHOT_UNITS 64.0f       // Fixed-point steps per px (and per px/s)
+#define PONG_SNAPSHOT_MAX   24          // Encoded size bound: a full snapshot is 20 bytes
+
+// Snap ball and paddles to the codec's grid (and clamp them into its ranges).
+void pong_snapshot_quantize(PongState *state);
+
+// Encode state (quantized) as a delta against base, which the receiver holds and
+// which is baseTicks older; base NULL sends everything. Returns the size, 0 if
+// cap is too small.
+size_t pong_snapshot_encode(const PongState *state, const PongState *base, uint32_t baseTicks, unsigned char *out, size_t cap);
+
+// Inverse of encode. With base NULL the fields the codec does not carry (paddle x
+// and sizes, ball radius, RNG key) are kept from *state, like pong_state_unpack.
+// False on a truncated or impossible snapshot.
+bool pong_snapshot_decode(PongState *state, const PongState *base, uint32_t baseTicks, const unsigned char *in, size_t size);
+
+#endif // PONG_SNAPSHOT_H
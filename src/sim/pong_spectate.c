@@ -0,0 +1,119 @@
+#include <stdlib.h>
+
+#include "pong_bytes.h"
+#include "pong_spectate.h"
+
+void pong_frame_retain(PongFrame *frame) {
+    atomic_fetch_add_explicit(&frame->refs, 1, memory_order_relaxed);
+}
+
+void pong_frame_release(PongFrame *frame) {
+    // Acquire-release so the last holder sees every other holder's reads finished
+    if (frame && atomic_fetch_sub_explicit(&frame->refs, 1, memory_order_acq_rel) == 1) free(frame);
+}
+
+void pong_stream_init(PongStream *stream, uint64_t seed) {
+    *stream = (PongStream){ .seed = seed };
+}
+
+void pong_stream_free(PongStream *stream) {
+    pong_frame_release(stream->full);
+    pong_frame_release(stream->delta);
+    stream->full = stream->delta = NULL;
+}
+
+static PongFrame *NewFrame(uint32_t tick, uint32_t age) {
+    PongFrame *frame = malloc(sizeof(PongFrame));
+    if (!frame) return NULL;
+    atomic_init(&frame->refs, 1);
+    frame->tick = tick;
+    frame->key = (age == 0);
+    frame->data[0] = PONG_PACKET_FRAME;
+    pong_put_u32(frame->data + 1, tick);
+    pong_put_u16(frame->data + 5, age);
+    frame->size = PONG_FRAME_HEADER;
+    return frame;
+}
+
+bool pong_stream_push(PongStream *stream, const PongState *state, uint32_t tick) {
+    PongFrame *full = NewFrame(tick, 0);
+    if (!full) return false;
+    pong_put_u32(full->data + 7, (uint32_t)stream->seed);
+    pong_put_u32(full->data + 11, (uint32_t)(stream->seed >> 32));
+    full->size += 8;
+    full->size += pong_snapshot_encode(state, NULL, 0, full->data + full->size, PONG_SNAPSHOT_MAX);
+
+    // The age field is 16 bits; a longer pause between pushes sends keyframes only
+    PongFrame *delta = NULL;
+    uint32_t age = tick - stream->lastTick;
+    if (stream->started && age > 0 && age <= 0xFFFF) {
+        delta = NewFrame(tick, age);
+        if (!delta) {
+            pong_frame_release(full);
+            return false;
+        }
+        delta->size += pong_snapshot_encode(state, &stream->last, age, delta->data + delta->size, PONG_SNAPSHOT_MAX);
+    }
+
+    pong_stream_free(stream);
+    stream->full = full;
+    stream->delta = delta;
+    stream->last = *state;
+    stream->lastTick = tick;
+    stream->started = true;
+    return true;
+}
+
+void pong_watcher_init(PongWatcher *watcher) {
+    *watcher = (PongWatcher){ 0 };
+}
+
+PongFrameResult pong_watcher_read(PongWatcher *watcher, const unsigned char *data, size_t size) {
+    if (size < PONG_FRAME_HEADER || data[0] != PONG_PACKET_FRAME) return PONG_FRAME_BAD;
+    uint32_t tick = pong_get_u32(data + 1);
+    uint32_t age = pong_get_u16(data + 5);
+
+    if (watcher->synced && (int32_t)(tick - watcher->tick) <= 0) return PONG_FRAME_STALE;
+
+    if (age == 0) {
+        if (size < PONG_FRAME_HEADER + 8) return PONG_FRAME_BAD;
+        uint64_t seed = pong_get_u32(data + 7) | (uint64_t)pong_get_u32(data + 11) << 32;
+
+        // A full snapshot leaves the fields it does not carry alone: start from the match template
+        PongState decoded;
+        pong_init(&decoded, seed);
+        if (!pong_snapshot_decode(&decoded, NULL, 0, data + 15, size - 15)) return PONG_FRAME_BAD;
+        watcher->state = decoded;
+        watcher->seed = seed;
+        watcher->keyframes++;
+    } else {
+        if (!watcher->synced || tick - age != watcher->tick) {
+            watcher->gaps++;
+            return PONG_FRAME_GAP;
+        }
+        PongState base = watcher->state;
+        if (!pong_snapshot_decode(&watcher->state, &base, age, data + PONG_FRAME_HEADER, size - PONG_FRAME_HEADER)) return PONG_FRAME_BAD;
+    }
+
+    watcher->synced = true;
+    watcher->tick = tick;
+    watcher->decoded++;
+    return PONG_FRAME_DECODED;
+}
+
+size_t pong_spectate_write(uint32_t match, const PongWatcher *watcher, bool needKey, unsigned char *out, size_t cap) {
+    if (cap < PONG_SPECTATE_BYTES) return 0;
+    out[0] = PONG_PACKET_SPECTATE;
+    pong_put_u32(out + 1, match);
+    pong_put_u32(out + 5, watcher->synced ? watcher->tick : 0);
+    out[9] = needKey || !watcher->synced;
+    return PONG_SPECTATE_BYTES;
+}
+
+bool pong_spectate_read(const unsigned char *data, size_t size, uint32_t *match, uint32_t *tick, bool *needKey) {
+    if (size < PONG_SPECTATE_BYTES || data[0] != PONG_PACKET_SPECTATE) return false;
+    *match = pong_get_u32(data + 1);
+    *tick = pong_get_u32(data + 5);
+    *needKey = data[9] != 0;
+    return true;
+}
@@ -0,0 +1,100 @@
+#ifndef PONG_SPECTATE_H
+#define PONG_SPECTATE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#include "pong.h"
+#include "pong_snapshot.h"
+
+/*
+*  Spectator stream
+*  ----------------------------------------------------------------------------------
+*  One match watched by many viewers. Unlike a player's snapshots, which are
+*  deltas against whatever that one client acknowledged, every spectator gets the
+*  same bytes: the stream encodes each published state exactly once as a delta
+*  against the previous published state, and once in full. Both are refcounted
+*  frames, so any number of senders (src/net/pong_relay.h) can point their
+*  datagrams at the same buffer without copying it. The stream holds one
+*  reference until the next push; anyone who keeps a frame past that takes its
+*  own with pong_frame_retain() before the push that would drop it.
+*
+*  A watcher decodes the delta chain. If it misses a frame it cannot decode the
+*  next delta; it then asks for a full frame (a keyframe) and skips straight to
+*  the live state instead of waiting for what it lost.
+*
+*  Frame packet: type, tick u32, base age u16 (0 = keyframe), [keyframe: seed
+*  u64], then the pong_snapshot_encode() bytes.
+*
+*  publisher:                                  spectator:
+*  pong_stream_init(&stream, seed);            pong_watcher_init(&watcher);
+*  every frame:                                per packet:
+*    pong_stream_push(&stream, &state, tick);    pong_watcher_read(&watcher, data, size);
+*    send stream.full / stream.delta           draw watcher.state
+*/
+
+#define PONG_FRAME_HEADER 7
+#define PONG_FRAME_MAX    (PONG_FRAME_HEADER + 8 + PONG_SNAPSHOT_MAX)
+
+// Message types (rollback uses 1-2, the authoritative server 16-19)
+typedef enum {
+    PONG_PACKET_SPECTATE = 24,      // Spectator -> relay: join / newest tick decoded / need a keyframe
+    PONG_PACKET_FRAME               // Relay -> spectator: one frame of the stream
+} PongSpectatePacketType;
+
+// An encoded frame, shared by everyone sending it. Immutable once pushed.
+typedef struct {
+    atomic_int refs;
+    uint32_t tick;
+    bool key;                       // Keyframe: decodes without any earlier frame
+    size_t size;
+    unsigned char data[PONG_FRAME_MAX];
+} PongFrame;
+
+typedef struct {
+    uint64_t seed;
+    PongState last;                 // Previous published state: the delta baseline
+    uint32_t lastTick;
+    bool started;
+    PongFrame *full;                // Newest frames, one reference each (NULL before the first push)
+    PongFrame *delta;
+} PongStream;
+
+typedef enum {
+    PONG_FRAME_BAD,                 // Not a frame, or corrupt
+    PONG_FRAME_STALE,               // Older than what the watcher shows already
+    PONG_FRAME_GAP,                 // A delta whose baseline the watcher does not have
+    PONG_FRAME_DECODED
+} PongFrameResult;
+
+typedef struct {
+    bool synced;                    // state is a decoded frame
+    PongState state;
+    uint32_t tick;
+    uint64_t seed;
+    uint64_t decoded;
+    uint64_t keyframes;
+    uint64_t gaps;
+} PongWatcher;
+
+// References: a frame is freed when the last one is released.
+void pong_frame_retain(PongFrame *frame);
+void pong_frame_release(PongFrame *frame);
+
+void pong_stream_init(PongStream *stream, uint64_t seed);
+void pong_stream_free(PongStream *stream);
+
+// Encode state (quantized, as the authority keeps it) at tick, which must be
+// newer than the previous push. Replaces stream->full and stream->delta; the
+// first push has no delta. False if out of memory.
+bool pong_stream_push(PongStream *stream, const PongState *state, uint32_t tick);
+
+void pong_watcher_init(PongWatcher *watcher);
+PongFrameResult pong_watcher_read(PongWatcher *watcher, const unsigned char *data, size_t size);
+
+// SPECTATE packet: match, newest tick decoded, whether a keyframe is needed.
+#define PONG_SPECTATE_BYTES 10
+size_t pong_spectate_write(uint32_t match, const PongWatcher *watcher, bool needKey, unsigned char *out, size_t cap);
+bool pong_spectate_read(const unsigned char *data, size_t size, uint32_t *match, uint32_t *tick, bool *needKey);
+
+#endif // PONG_SPECTATE_H
@@ -0,0 +1,72 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "pong_clock.h"
+#include "pong_sweep.h"
+
+static int CompareU32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Sorts values in place; scale turns them into the reported unit
+static void Summarise(uint32_t *values, int count, double scale, PongSweepDist *out) {
+    memset(out, 0, sizeof(*out));
+    if (count == 0) return;
+
+    qsort(values, (size_t)count, sizeof(uint32_t), CompareU32);
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += values[i];
+    out->mean = sum / count * scale;
+    out->p10 = (float)(values[count * 10 / 100] * scale);
+    out->p50 = (float)(values[count * 50 / 100] * scale);
+    out->p90 = (float)(values[count * 90 / 100] * scale);
+    out->max = (float)(values[count - 1] * scale);
+}
+
+bool pong_sweep_point(const PongRules *rules, const PongSweepConfig *config, PongSweepStats *out) {
+    memset(out, 0, sizeof(*out));
+    int maxRallies = config->matches * (2 * WINNING_SCORE - 1);
+    uint32_t *rallyTicks = malloc((size_t)maxRallies * sizeof(uint32_t));
+    uint32_t *rallyHits = malloc((size_t)maxRallies * sizeof(uint32_t));
+    uint32_t *matchTicks = malloc((size_t)config->matches * sizeof(uint32_t));
+    if (!rallyTicks || !rallyHits || !matchTicks) {
+        free(rallyTicks);
+        free(rallyHits);
+        free(matchTicks);
+        return false;
+    }
+
+    uint64_t maxTicks = (uint64_t)(config->maxMatchSeconds * PONG_TICK_RATE);
+    for (int i = 0; i < config->matches; i++) {
+        // Match, CPU 1 and CPU 2 streams never share a seed
+        uint64_t seed = 4u * (config->seed + (uint64_t)i);
+        PongEventMatch m;
+        pong_event_init(&m, seed, config->player1, config->player2, seed + 1u);
+        m.rules = *rules;
+
+        uint64_t rallyStart = 0, hitsStart = 0;
+        while (pong_event_run_point(&m, maxTicks)) {
+            rallyTicks[out->rallies] = (uint32_t)(m.tick - rallyStart);
+            rallyHits[out->rallies] = (uint32_t)(m.hits - hitsStart);
+            out->rallies++;
+            rallyStart = m.tick;
+            hitsStart = m.hits;
+        }
+
+        if (m.state.gameState != GAME_OVER) {
+            out->capped++;
+            continue;
+        }
+        matchTicks[out->matches++] = (uint32_t)m.tick;
+        out->player1Wins += m.state.score1 > m.state.score2;
+    }
+
+    Summarise(rallyTicks, out->rallies, PONG_TICK_DT, &out->rallySeconds);
+    Summarise(rallyHits, out->rallies, 1.0, &out->rallyHits);
+    Summarise(matchTicks, out->matches, PONG_TICK_DT, &out->matchSeconds);
+    free(rallyTicks);
+    free(rallyHits);
+    free(matchTicks);
+    return true;
+}
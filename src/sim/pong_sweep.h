@@ -0,0 +1,49 @@
+#ifndef PONG_SWEEP_H
+#define PONG_SWEEP_H
+
+#include "pong_event.h"
+
+/*
+*  Gameplay tuning sweeps
+*  ----------------------------------------------------------------------------------
+*  Plays a set of CPU-vs-CPU matches under one PongRules (a point of a sweep) on
+*  the event-driven engine and sums up how they went: how long rallies last, how
+*  many paddle hits they see, and how long a match takes, each as a distribution.
+*
+*  Match i of every point uses the same match and CPU seeds, so two points differ
+*  only by their rules, and a point's results never depend on which thread ran it.
+*  The float rules are what take PongRules; fixed-point builds cannot sweep.
+*
+*  PongSweepConfig config = { cpu1, cpu2, 1000, seed, 600.0f };
+*  PongSweepStats stats;
+*  pong_sweep_point(&rules, &config, &stats);
+*/
+
+typedef struct {
+    PongCpuConfig player1;
+    PongCpuConfig player2;
+    int matches;
+    uint64_t seed;
+    float maxMatchSeconds;          // Game time after which a match is abandoned (never-ending rallies)
+} PongSweepConfig;
+
+typedef struct {
+    double mean;
+    float p10, p50, p90, max;
+} PongSweepDist;
+
+typedef struct {
+    int matches;                    // Played to the end
+    int capped;                     // Abandoned at maxMatchSeconds; not in the match distribution
+    int player1Wins;
+    int rallies;                    // Points scored
+
+    PongSweepDist rallySeconds;     // Serve to point
+    PongSweepDist rallyHits;        // Paddle hits per point
+    PongSweepDist matchSeconds;
+} PongSweepStats;
+
+// Play config->matches matches under rules. False if out of memory.
+bool pong_sweep_point(const PongRules *rules, const PongSweepConfig *config, PongSweepStats *out);
+
+#endif // PONG_SWEEP_H
@@ -0,0 +1,29 @@
+#include "pong_triple.h"
+
+#define SLOT_MASK 3u
+
+void pong_triple_init(PongTripleBuffer *tb, const PongSimFrame *first) {
+    for (int i = 0; i < 3; i++) tb->slots[i] = *first;
+    tb->back = 0;
+    tb->front = 1;
+    atomic_init(&tb->shared, 2u);
+}
+
+PongSimFrame *pong_triple_back(PongTripleBuffer *tb) {
+    return &tb->slots[tb->back];
+}
+
+void pong_triple_publish(PongTripleBuffer *tb) {
+    // Release: the frame's contents are visible before its index is
+    unsigned int old = atomic_exchange_explicit(&tb->shared, tb->back | PONG_TRIPLE_FRESH, memory_order_acq_rel);
+    tb->back = old & SLOT_MASK;
+}
+
+const PongSimFrame *pong_triple_latest(PongTripleBuffer *tb) {
+    if (atomic_load_explicit(&tb->shared, memory_order_relaxed) & PONG_TRIPLE_FRESH) {
+        // Acquire: pairs with the publish that set FRESH
+        unsigned int old = atomic_exchange_explicit(&tb->shared, tb->front, memory_order_acq_rel);
+        tb->front = old & SLOT_MASK;
+    }
+    return &tb->slots[tb->front];
+}
@@ -0,0 +1,55 @@
+#ifndef PONG_TRIPLE_H
+#define PONG_TRIPLE_H
+
+#include <stdatomic.h>
+
+#include "pong.h"
+
+/*
+*  Triple-buffered frames
+*  ----------------------------------------------------------------------------------
+*  Hands simulation results from one thread to another without either waiting.
+*  Three slots: the writer fills its own, then swaps it with the shared one in a
+*  single atomic exchange; the reader swaps the shared one with its own whenever a
+*  fresh frame sits there. Neither side ever touches the other's slot, so a frame
+*  is immutable from the moment it is published until the reader lets go of it,
+*  and a slow reader only ever skips frames - it never stalls the writer.
+*
+*  One writer thread and one reader thread:
+*
+*  PongSimFrame *frame = pong_triple_back(&tb);          // writer
+*  ... fill *frame ...
+*  pong_triple_publish(&tb);
+*
+*  const PongSimFrame *latest = pong_triple_latest(&tb); // reader; valid until its next call
+*/
+
+#define PONG_TRIPLE_FRESH 4u        // Set in shared while the slot there is unread
+
+typedef struct {
+    PongState previous;             // The two newest ticks, for interpolation
+    PongState current;
+    uint64_t tick;                  // Ticks simulated up to current
+    double time;                    // pong_clock_now() at which current was due
+} PongSimFrame;
+
+typedef struct {
+    PongSimFrame slots[3];
+    _Alignas(64) _Atomic unsigned int shared;       // Slot index, | PONG_TRIPLE_FRESH
+    _Alignas(64) unsigned int back;                 // Writer's slot
+    _Alignas(64) unsigned int front;                // Reader's slot
+} PongTripleBuffer;
+
+// Every slot starts as a copy of first, so the reader always has a frame.
+void pong_triple_init(PongTripleBuffer *tb, const PongSimFrame *first);
+
+// Writer: the slot to fill next (its old contents are stale).
+PongSimFrame *pong_triple_back(PongTripleBuffer *tb);
+
+// Writer: make the filled slot the latest frame.
+void pong_triple_publish(PongTripleBuffer *tb);
+
+// Reader: the latest published frame (the same one again if nothing new).
+const PongSimFrame *pong_triple_latest(PongTripleBuffer *tb);
+
+#endif // PONG_TRIPLE_H
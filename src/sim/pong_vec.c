@@ -0,0 +1,122 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "pong_vec.h"
+
+static PongInput ActionBits(int action, PongInput up, PongInput down) {
+    if (action == PONG_ACTION_UP) return up;
+    if (action == PONG_ACTION_DOWN) return down;
+    return 0;
+}
+
+// Press serve until the match is in open play. dt = 0: nothing moves, the ball
+// is just placed and launched, exactly as a SERVE press would do it.
+static void ServeNow(PongState *state) {
+    while (state->gameState != GAME_PLAYING) pong_step(state, PONG_INPUT_SERVE, 0.0f);
+}
+
+// New match on the same random stream, with the serve direction drawn the way
+// the GAME_OVER rule draws it.
+static void RestartLane(PongBatch *batch, int lane) {
+    PongState state;
+    pong_batch_get(batch, lane, &state);
+
+    uint64_t key = state.rngKey;
+    uint32_t counter = state.rngCounter;
+    pong_init(&state, 0);
+    state.rngKey = key;
+    state.rngCounter = counter;
+    state.serveDirection = (pong_random_value(&state, 0, 1) == 0) ? -1 : 1;
+
+    ServeNow(&state);
+    pong_batch_set(batch, lane, &state);
+}
+
+static void ServeLane(PongBatch *batch, int lane) {
+    PongState state;
+    pong_batch_get(batch, lane, &state);
+    ServeNow(&state);
+    pong_batch_set(batch, lane, &state);
+}
+
+static void WriteObservations(const PongBatch *batch, float *obs) {
+    const float invW = 1.0f / ARENA_WIDTH, invH = 1.0f / ARENA_HEIGHT, invV = 1.0f / BALL_MAX_SPEED;
+
+    for (int i = 0; i < batch->count; i++) {
+        float x = pong_lane_to_float(batch->ballX[i]) * invW;
+        float y = pong_lane_to_float(batch->ballY[i]) * invH;
+        float vx = pong_lane_to_float(batch->ballVX[i]) * invV;
+        float vy = pong_lane_to_float(batch->ballVY[i]) * invV;
+        float c1 = (pong_lane_to_float(batch->paddle1Y[i]) + PADDLE_HEIGHT * 0.5f) * invH;
+        float c2 = (pong_lane_to_float(batch->paddle2Y[i]) + PADDLE_HEIGHT * 0.5f) * invH;
+
+        float *p1 = obs + (size_t)i * PONG_VEC_AGENTS * PONG_VEC_OBS_SIZE;
+        float *p2 = p1 + PONG_VEC_OBS_SIZE;
+        p1[PONG_OBS_BALL_X] = x;        p2[PONG_OBS_BALL_X] = 1.0f - x;
+        p1[PONG_OBS_BALL_Y] = y;        p2[PONG_OBS_BALL_Y] = y;
+        p1[PONG_OBS_BALL_VX] = vx;      p2[PONG_OBS_BALL_VX] = -vx;
+        p1[PONG_OBS_BALL_VY] = vy;      p2[PONG_OBS_BALL_VY] = vy;
+        p1[PONG_OBS_OWN_PADDLE] = c1;   p2[PONG_OBS_OWN_PADDLE] = c2;
+        p1[PONG_OBS_OTHER_PADDLE] = c2; p2[PONG_OBS_OTHER_PADDLE] = c1;
+    }
+}
+
+bool pong_vec_init(PongVecEnv *env, int n, float dt, PongPool *pool) {
+    memset(env, 0, sizeof(*env));
+    if (!pong_batch_init(&env->batch, n, 0)) return false;
+
+    env->pool = pool;
+    env->dt = dt;
+    env->inputs = calloc((size_t)n, sizeof(PongInput));
+    env->margin = calloc((size_t)n, sizeof(int));
+    if (!env->inputs || !env->margin) {
+        pong_vec_free(env);
+        return false;
+    }
+
+    return true;
+}
+
+void pong_vec_free(PongVecEnv *env) {
+    pong_batch_free(&env->batch);
+    free(env->inputs);
+    free(env->margin);
+    memset(env, 0, sizeof(*env));
+}
+
+void pong_vec_reset(PongVecEnv *env, const uint64_t *seeds, float *obs) {
+    for (int i = 0; i < env->batch.count; i++) {
+        PongState state;
+        pong_init(&state, seeds ? seeds[i] : (uint64_t)i);
+        ServeNow(&state);
+        pong_batch_set(&env->batch, i, &state);
+    }
+
+    WriteObservations(&env->batch, obs);
+}
+
+void pong_vec_step(PongVecEnv *env, const int *actions, float *obs, float *rewards, unsigned char *dones) {
+    PongBatch *batch = &env->batch;
+    int n = batch->count;
+
+    for (int i = 0; i < n; i++) {
+        env->inputs[i] = ActionBits(actions[2 * i], PONG_INPUT_P1_UP, PONG_INPUT_P1_DOWN) |
+                         ActionBits(actions[2 * i + 1], PONG_INPUT_P2_UP, PONG_INPUT_P2_DOWN);
+        env->margin[i] = batch->score1[i] - batch->score2[i];
+    }
+
+    if (env->pool) pong_batch_step_parallel(batch, env->pool, env->inputs, env->dt);
+    else pong_batch_step(batch, env->inputs, env->dt);
+
+    for (int i = 0; i < n; i++) {
+        float reward = (float)(batch->score1[i] - batch->score2[i] - env->margin[i]);
+        rewards[2 * i] = reward;
+        rewards[2 * i + 1] = -reward;
+        dones[i] = batch->gameState[i] == GAME_OVER;
+
+        if (dones[i]) RestartLane(batch, i);
+        else if (batch->gameState[i] != GAME_PLAYING) ServeLane(batch, i);
+    }
+
+    WriteObservations(batch, obs);
+}
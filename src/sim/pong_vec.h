@@ -0,0 +1,74 @@
+#ifndef PONG_VEC_H
+#define PONG_VEC_H
+
+#include "pong_batch.h"
+
+/*
+*  Vectorised training environment
+*  ----------------------------------------------------------------------------------
+*  N matches behind a Gym-style vector-env interface, for training paddle agents.
+*  Every match has two agents (player 1 and player 2), so one policy can play both
+*  sides in self-play:
+*
+*  PongVecEnv env;
+*  pong_vec_init(&env, n, PONG_TICK_DT, NULL);
+*  pong_vec_reset(&env, seeds, obs);                       // obs[n * 2 * PONG_VEC_OBS_SIZE]
+*  for (;;) pong_vec_step(&env, actions, obs, rewards, dones);
+*
+*  Per-agent arrays are [env][player]: entry 2 * i is player 1 of env i, 2 * i + 1
+*  its player 2. Observations are written in place into the caller's buffers, and
+*  a step allocates nothing.
+*
+*  The matches run the normal rules (pong_batch_step()); the environment only
+*  presses serve for the agents, so every observation is taken in open play. When
+*  a side reaches WINNING_SCORE the env reports done and starts a fresh match in
+*  the same step - the obs returned for it is the first of the new episode. The
+*  new match continues the env's random stream, so a run is reproducible from the
+*  seeds and the actions alone.
+*/
+
+// What an agent does with its paddle this step
+typedef enum {
+    PONG_ACTION_STAY,
+    PONG_ACTION_UP,
+    PONG_ACTION_DOWN
+} PongAction;
+
+#define PONG_VEC_AGENTS 2       // Agents per env
+#define PONG_VEC_OBS_SIZE 6     // Floats per agent observation
+
+// Observation layout, from the agent's own side of the arena: x runs from its
+// own goal line (0) to the opponent's (1), so both players see the same game.
+typedef enum {
+    PONG_OBS_BALL_X,            // Ball x / ARENA_WIDTH, mirrored for player 2
+    PONG_OBS_BALL_Y,            // Ball y / ARENA_HEIGHT
+    PONG_OBS_BALL_VX,           // Ball x speed towards the opponent / BALL_MAX_SPEED
+    PONG_OBS_BALL_VY,           // Ball y speed / BALL_MAX_SPEED
+    PONG_OBS_OWN_PADDLE,        // Own paddle centre y / ARENA_HEIGHT
+    PONG_OBS_OTHER_PADDLE       // Opponent paddle centre y / ARENA_HEIGHT
+} PongObsField;
+
+typedef struct {
+    PongBatch batch;
+    PongPool *pool;             // Optional: steps the batch in parallel when set
+    float dt;
+
+    // Scratch, sized once at init
+    PongInput *inputs;
+    int *margin;                // score1 - score2 before the step
+} PongVecEnv;
+
+// Allocate n environments stepped dt seconds at a time. pool may be NULL.
+bool pong_vec_init(PongVecEnv *env, int n, float dt, PongPool *pool);
+void pong_vec_free(PongVecEnv *env);
+
+// Start a new match in every env (seeds[i], or i when seeds is NULL) and write
+// the first observations.
+void pong_vec_reset(PongVecEnv *env, const uint64_t *seeds, float *obs);
+
+// Apply one PongAction per agent and advance every env by dt. Rewards are +1 to
+// the agent that scored a point and -1 to the one that conceded; dones[i] is 1
+// when env i finished a match this step (and has already been reset).
+void pong_vec_step(PongVecEnv *env, const int *actions, float *obs, float *rewards, unsigned char *dones);
+
+#endif // PONG_VEC_H
@@ -0,0 +1,176 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/sim/pong_ai.h"
+#include "../src/sim/pong_clock.h"
+
+/*
+*  Trajectory predictor and CPU opponent
+*  ----------------------------------------------------------------------------------
+*  predictor: every time the ball sets off on a new course in a bot match, asks
+*  pong_predict_intercept() where it will meet the paddle it is heading for, then
+*  finds out by stepping a copy of the match (paddles moved out of the way) up to
+*  that paddle's face with the real rules. Prints the worst disagreement in px and
+*  ms and what each way costs.
+*
+*  cpu: the CPU opponent at each level (or the ones given) as player 2 against a
+*  reference CPU that never reacts late and aims anywhere on its paddle, like the
+*  headless bot: matches won and the share of balls it returned. The predictor's
+*  matches are two reference CPUs.
+*
+*  make headless
+*  ./bin/pong_ai [matches] [cpu ...]       (cpu: easy, normal, hard or reaction_ms,error_px)
+*/
+
+#define MAX_TICKS_PER_MATCH (PONG_TICK_RATE * 600)
+#define MAX_COURSES 100000
+
+// No reaction delay; the aim spread of the headless bot
+static const PongCpuConfig referenceCpu = { 0.0f, PADDLE_HEIGHT * 0.65f };
+
+// Both paddles' keys for one tick, serving whenever the ball is not in play
+static PongInput CpuMatchInput(PongCpu *cpu1, PongCpu *cpu2, const PongState *state) {
+    PongInput input = (state->gameState != GAME_PLAYING) ? PONG_INPUT_SERVE : 0;
+    return input | pong_cpu_input(cpu1, state) | pong_cpu_input(cpu2, state);
+}
+
+// Step a copy with both paddles far off to the sides until the ball reaches the
+// face of player's paddle; the last step is cut to end exactly there
+static bool SteppedIntercept(const PongState *state, int player, PongIntercept *out) {
+    PongState copy = *state;
+    copy.player1.position.x = -1e6f;
+    copy.player2.position.x = 1e6f;
+    float faceX = (player == 0) ? PADDLE1_X + PADDLE_WIDTH + copy.ball.radius : PADDLE2_X - copy.ball.radius;
+
+    for (int ticks = 0; ticks < MAX_TICKS_PER_MATCH; ticks++) {
+        float rest = (faceX - copy.ball.position.x) / copy.ball.velocity.x;
+        if (rest < 0.0f) return false;
+        if (rest <= PONG_TICK_DT) {
+            pong_float_step(&copy, 0, rest);
+            *out = (PongIntercept){ copy.ball.position.y, ticks * PONG_TICK_DT + rest, 0 };
+            return true;
+        }
+        pong_float_step(&copy, 0, PONG_TICK_DT);
+    }
+    return false;
+}
+
+static int Predictor(int matches) {
+    Ball *courses = malloc(MAX_COURSES * sizeof(Ball));
+    int *players = malloc(MAX_COURSES * sizeof(int));
+    if (!courses || !players) return 1;
+
+    int count = 0, bounces = 0;
+    double worstY = 0.0, worstTime = 0.0, sumY = 0.0, stepSeconds = 0.0;
+    for (int m = 0; m < matches && count < MAX_COURSES; m++) {
+        PongCpu cpus[2];
+        pong_cpu_init(&cpus[0], 0, referenceCpu, 2654435761u + (uint64_t)m);
+        pong_cpu_init(&cpus[1], 1, referenceCpu, 2246822519u + (uint64_t)m);
+        PongState state;
+        pong_init(&state, 1000u + (uint64_t)m);
+
+        float lastVelocityX = 0.0f;
+        for (int t = 0; t < MAX_TICKS_PER_MATCH && count < MAX_COURSES; t++) {
+            pong_float_step(&state, CpuMatchInput(&cpus[0], &cpus[1], &state), PONG_TICK_DT);
+            if (state.gameState == GAME_OVER) break;
+
+            float vx = state.ball.velocity.x;
+            bool newCourse = state.gameState == GAME_PLAYING && vx != 0.0f && (vx > 0.0f) != (lastVelocityX > 0.0f);
+            lastVelocityX = (state.gameState == GAME_PLAYING) ? vx : 0.0f;
+            if (!newCourse) continue;
+
+            int player = (vx > 0.0f) ? 1 : 0;
+            PongIntercept predicted, stepped;
+            double t0 = pong_clock_now();
+            bool reached = SteppedIntercept(&state, player, &stepped);
+            stepSeconds += pong_clock_now() - t0;
+            if (!reached || !pong_predict_intercept(&state.ball, player, &predicted)) continue;
+
+            double dy = fabs((double)predicted.y - stepped.y), dt = fabs((double)predicted.time - stepped.time);
+            if (dy > worstY) worstY = dy;
+            if (dt > worstTime) worstTime = dt;
+            sumY += dy;
+            bounces += predicted.bounces;
+            courses[count] = state.ball;
+            players[count] = player;
+            count++;
+        }
+    }
+    if (count == 0) return 1;
+
+    // The closed form on its own, over the same courses
+    const int rounds = 200;
+    volatile float sink = 0.0f;
+    double t0 = pong_clock_now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < count; i++) {
+            PongIntercept hit;
+            if (pong_predict_intercept(&courses[i], players[i], &hit)) sink += hit.y;
+        }
+    }
+    double predictSeconds = pong_clock_now() - t0;
+    (void)sink;
+
+    printf("predictor      %d courses from %d matches, %.2f wall bounces each on average\n", count, matches, (double)bounces / count);
+    printf("               vs stepping the rules: y off by %.4f px on average, %.4f px worst; time off by %.4f ms worst\n",
+           sumY / count, worstY, worstTime * 1e3);
+    printf("               %.1f ns per prediction, %.1f us per stepped intercept\n",
+           predictSeconds / ((double)rounds * count) * 1e9, stepSeconds / count * 1e6);
+    free(courses);
+    free(players);
+    return worstY < 0.5 ? 0 : 1;
+}
+
+static void CpuMatches(const char *name, PongCpuConfig config, int matches) {
+    int won = 0;
+    long returned = 0, reached = 0;
+    for (int m = 0; m < matches; m++) {
+        PongCpu reference, cpu;
+        pong_cpu_init(&reference, 0, referenceCpu, 2654435761u + (uint64_t)m);
+        pong_cpu_init(&cpu, 1, config, 77u + (uint64_t)m);
+        PongState state;
+        pong_init(&state, 1000u + (uint64_t)m);
+
+        float lastVelocityX = 0.0f;
+        for (int t = 0; t < MAX_TICKS_PER_MATCH && state.gameState != GAME_OVER; t++) {
+            PongInput input = CpuMatchInput(&reference, &cpu, &state);
+            int score1 = state.score1;
+            pong_step(&state, input, PONG_TICK_DT);
+
+            // A ball on its way to the CPU either comes back or scores for player 1
+            float vx = state.ball.velocity.x;
+            if (state.gameState == GAME_PLAYING && lastVelocityX > 0.0f && vx < 0.0f) returned++, reached++;
+            if (state.score1 != score1) reached++;
+            lastVelocityX = (state.gameState == GAME_PLAYING) ? vx : 0.0f;
+        }
+        won += state.score2 >= WINNING_SCORE;
+    }
+
+    printf("cpu %-18s reaction %3.0f ms, error %4.1f px: won %3d/%d matches, returned %5.1f%% of %ld balls\n", name,
+           config.reaction * 1e3, config.error, won, matches, reached ? 100.0 * (double)returned / reached : 0.0, reached);
+}
+
+int main(int argc, char **argv) {
+    int matches = (argc > 1) ? atoi(argv[1]) : 200;
+    if (matches <= 0) {
+        fprintf(stderr, "usage: %s [matches] [cpu ...]\n", argv[0]);
+        return 1;
+    }
+
+    int result = Predictor(matches);
+
+    if (argc > 2) {
+        for (int i = 2; i < argc; i++) {
+            PongCpuConfig config;
+            if (!pong_cpu_parse(argv[i], &config)) {
+                fprintf(stderr, "bad cpu: %s (easy, normal, hard or reaction_ms,error_px)\n", argv[i]);
+                return 1;
+            }
+            CpuMatches(argv[i], config, matches);
+        }
+    } else {
+        for (int i = 0; i < pong_cpu_level_count; i++) CpuMatches(pong_cpu_levels[i].name, pong_cpu_levels[i].config, matches);
+    }
+    return result;
+}
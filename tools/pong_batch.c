@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_batch.h"
+#include "../src/sim/pong_clock.h"
+#include "pong_tool_common.h"
+
+/*
+*  Batched match runner
+*  ----------------------------------------------------------------------------------
+*  Steps N bot-vs-bot matches in one PongBatch and reports match-steps per second.
+*  Finished matches are restarted in place, so every lane stays busy. The first
+*  lanes are also replayed through the scalar pong_step() and compared bit for bit.
+*
+*  make headless
+*  ./bin/pong_batch [lanes] [ticks] [tick_hz]
+*/
+
+#define VERIFY_LANES 64
+
+typedef struct {
+    float *aimOffset;
+    float *lastVX;
+    unsigned int *rng;
+} Bots;
+
+static PongInput PaddleInput(float target, float paddleY, PongInput upBit, PongInput downBit) {
+    float center = paddleY + PADDLE_HEIGHT * 0.5f;
+    if (target < center - 4.0f) return upBit;
+    if (target > center + 4.0f) return downBit;
+    return 0;
+}
+
+// Same bots as pong_headless: chase the incoming ball with a per-leg aim error
+static PongInput BotsInput(Bots *bots, int lane, GameState gameState, float ballY, float ballVX, float paddle1Y, float paddle2Y) {
+    if (gameState != GAME_PLAYING && gameState != GAME_PAUSE) return PONG_INPUT_SERVE;
+
+    if ((ballVX > 0) != (bots->lastVX[lane] > 0)) {
+        bots->aimOffset[lane] = ((float)(NextRandom(&bots->rng[lane]) % 1000) / 999.0f * 2.0f - 1.0f) * PADDLE_HEIGHT * 0.65f;
+    }
+    bots->lastVX[lane] = ballVX;
+
+    float target1 = (ballVX < 0) ? ballY + bots->aimOffset[lane] : ARENA_HEIGHT * 0.5f;
+    float target2 = (ballVX > 0) ? ballY + bots->aimOffset[lane] : ARENA_HEIGHT * 0.5f;
+
+    return PaddleInput(target1, paddle1Y, PONG_INPUT_P1_UP, PONG_INPUT_P1_DOWN) |
+           PaddleInput(target2, paddle2Y, PONG_INPUT_P2_UP, PONG_INPUT_P2_DOWN);
+}
+
+// FNV-1a over every lane's state: equal across machines when the simulation is
+// bit-exact (PONG_FIXED_POINT builds)
+static unsigned int HashBytes(unsigned int h, const void *data, size_t size) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < size; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+static unsigned int BatchChecksum(const PongBatch *batch) {
+    size_t n = (size_t)batch->count;
+    unsigned int h = 2166136261u;
+    h = HashBytes(h, batch->ballX, n * sizeof(PongLaneValue));
+    h = HashBytes(h, batch->ballY, n * sizeof(PongLaneValue));
+    h = HashBytes(h, batch->ballVX, n * sizeof(PongLaneValue));
+    h = HashBytes(h, batch->ballVY, n * sizeof(PongLaneValue));
+    h = HashBytes(h, batch->paddle1Y, n * sizeof(PongLaneValue));
+    h = HashBytes(h, batch->paddle2Y, n * sizeof(PongLaneValue));
+    h = HashBytes(h, batch->score1, n * sizeof(int));
+    h = HashBytes(h, batch->score2, n * sizeof(int));
+    h = HashBytes(h, batch->rngCounter, n * sizeof(uint32_t));
+    return HashBytes(h, batch->gameState, n);
+}
+
+static bool SameBits(float a, float b) {
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static bool StatesEqual(const PongState *a, const PongState *b) {
+    return SameBits(a->player1.position.y, b->player1.position.y) &&
+           SameBits(a->player2.position.y, b->player2.position.y) &&
+           SameBits(a->ball.position.x, b->ball.position.x) &&
+           SameBits(a->ball.position.y, b->ball.position.y) &&
+           SameBits(a->ball.velocity.x, b->ball.velocity.x) &&
+           SameBits(a->ball.velocity.y, b->ball.velocity.y) &&
+           a->gameState == b->gameState && a->score1 == b->score1 && a->score2 == b->score2 &&
+           a->serveDirection == b->serveDirection && a->serveJustHappened == b->serveJustHappened &&
+           a->rngKey == b->rngKey && a->rngCounter == b->rngCounter;
+}
+
+int main(int argc, char **argv) {
+    int lanes = (argc > 1) ? atoi(argv[1]) : 4096;
+    int ticks = (argc > 2) ? atoi(argv[2]) : 10000;
+    int tickRate = (argc > 3) ? atoi(argv[3]) : PONG_TICK_RATE;
+
+    if (lanes <= 0 || ticks <= 0 || tickRate <= 0) {
+        fprintf(stderr, "usage: %s [lanes] [ticks] [tick_hz]\n", argv[0]);
+        return 1;
+    }
+
+    float dt = 1.0f / (float)tickRate;
+    int verifyLanes = (lanes < VERIFY_LANES) ? lanes : VERIFY_LANES;
+
+    PongBatch batch;
+    if (!pong_batch_init(&batch, lanes, 1)) {
+        fprintf(stderr, "out of memory for %d lanes\n", lanes);
+        return 1;
+    }
+
+    PongInput *inputs = calloc((size_t)lanes, sizeof(PongInput));
+    Bots bots = { calloc((size_t)lanes, sizeof(float)), calloc((size_t)lanes, sizeof(float)), calloc((size_t)lanes, sizeof(unsigned int)) };
+    PongState *reference = calloc((size_t)verifyLanes, sizeof(PongState));
+    Bots refBots = { calloc((size_t)verifyLanes, sizeof(float)), calloc((size_t)verifyLanes, sizeof(float)), calloc((size_t)verifyLanes, sizeof(unsigned int)) };
+
+    for (int i = 0; i < lanes; i++) bots.rng[i] = (unsigned int)i * 2654435761u | 1u;
+    for (int i = 0; i < verifyLanes; i++) {
+        pong_init(&reference[i], 1 + (unsigned int)i);
+        refBots.rng[i] = bots.rng[i];
+    }
+
+    long long matchesDone = 0;
+    double inputTime = 0.0, stepTime = 0.0;
+
+    for (int t = 0; t < ticks; t++) {
+        double t0 = pong_clock_now();
+        for (int i = 0; i < lanes; i++) {
+            if (batch.gameState[i] == GAME_OVER) matchesDone++;
+            inputs[i] = BotsInput(&bots, i, (GameState)batch.gameState[i], pong_lane_to_float(batch.ballY[i]), pong_lane_to_float(batch.ballVX[i]),
+                                  pong_lane_to_float(batch.paddle1Y[i]), pong_lane_to_float(batch.paddle2Y[i]));
+        }
+        double t1 = pong_clock_now();
+        pong_batch_step(&batch, inputs, dt);
+        double t2 = pong_clock_now();
+
+        inputTime += t1 - t0;
+        stepTime += t2 - t1;
+
+        for (int i = 0; i < verifyLanes; i++) {
+            PongState *s = &reference[i];
+            PongInput in = BotsInput(&refBots, i, s->gameState, s->ball.position.y, s->ball.velocity.x, s->player1.position.y, s->player2.position.y);
+            pong_step(s, in, dt);
+        }
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < verifyLanes; i++) {
+        PongState fromBatch;
+        pong_batch_get(&batch, i, &fromBatch);
+        if (!StatesEqual(&fromBatch, &reference[i])) mismatches++;
+    }
+
+    double laneSteps = (double)lanes * ticks;
+#ifdef PONG_FIXED_POINT
+    const char *mode = "fixed point";
+#else
+    const char *mode = "float";
+#endif
+    printf("lanes          %d x %d ticks at %d Hz (%s)\n", lanes, ticks, tickRate, mode);
+    printf("matches done   %lld\n", matchesDone);
+    printf("step time      %.3f s (bots %.3f s)\n", stepTime, inputTime);
+    printf("match-steps/s  %.0f\n", laneSteps / stepTime);
+    printf("verify         %d/%d lanes match pong_step bit for bit\n", verifyLanes - mismatches, verifyLanes);
+    printf("checksum       %08x\n", BatchChecksum(&batch));
+
+    free(inputs);
+    free(bots.aimOffset); free(bots.lastVX); free(bots.rng);
+    free(refBots.aimOffset); free(refBots.lastVX); free(refBots.rng);
+    free(reference);
+    pong_batch_free(&batch);
+
+    return (mismatches == 0) ? 0 : 1;
+}
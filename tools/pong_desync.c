@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_desync.h"
+#include "../src/sim/pong_link.h"
+#include "../src/sim/pong_rollback.h"
+#include "pong_tool_common.h"
+
+/*
+*  Desync detector
+*  ----------------------------------------------------------------------------------
+*  First times the per-tick cost: pong_state_hash() alone and a full record
+*  (hash, rolling hash, state kept for the search) over the states of a bot match.
+*
+*  Then plays two rollback peers over an emulated link (src/sim/pong_link.h, on
+*  virtual time like pong_netsim) and, once the ball is in play after
+*  inject_second, flips the lowest bit of the ball's x position in peer 2's
+*  newest confirmed state - the kind of one-ulp difference a different compiler
+*  or FPU produces. Reports how long each peer took to notice and to have both
+*  states, the tick they settled on against the true first divergent tick (from
+*  two straight runs over the same inputs, one flipped), and both dumps.
+*
+*  make headless
+*  ./bin/pong_desync [link] [inject_second]
+*/
+
+#define BENCH_STATES 4096        // A few hundred KB: a live state is in cache too
+#define BENCH_ROUNDS 1024
+#define GIVE_UP_SECONDS 10
+
+static bool SameImage(const PongState *a, const PongState *b) {
+    unsigned char x[PONG_STATE_BYTES], y[PONG_STATE_BYTES];
+    pong_state_pack(a, x);
+    pong_state_pack(b, y);
+    return memcmp(x, y, PONG_STATE_BYTES) == 0;
+}
+
+static void FlipBallX(PongState *state) {
+    uint32_t bits;
+    memcpy(&bits, &state->ball.position.x, sizeof(bits));
+    bits ^= 1;
+    memcpy(&state->ball.position.x, &bits, sizeof(bits));
+}
+
+static void Bench(uint64_t seed) {
+    PongState *states = malloc(BENCH_STATES * sizeof(PongState));
+    PongDesync *d = malloc(sizeof(PongDesync));
+    if (!states || !d) return;
+
+    Bot bots[2] = { { 0.0f, 0.0f, 2654435761u }, { 0.0f, 0.0f, 2246822519u } };
+    pong_init(&states[0], seed);
+    for (int i = 1; i < BENCH_STATES; i++) {
+        states[i] = states[i - 1];
+        pong_step(&states[i], BotInput(&bots[0], &states[i], 0) | BotInput(&bots[1], &states[i], 1), PONG_TICK_DT);
+    }
+
+    volatile uint32_t sink = 0;
+    double t0 = pong_clock_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        uint32_t acc = 0;
+        for (int i = 0; i < BENCH_STATES; i++) acc += pong_state_hash(&states[i]);
+        sink += acc;
+    }
+    double t1 = pong_clock_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        pong_desync_init(d, &states[0]);
+        for (int i = 1; i < BENCH_STATES; i++) pong_desync_record(d, &states[i]);
+        sink += d->running;
+    }
+    double t2 = pong_clock_now();
+
+    double count = (double)BENCH_STATES * BENCH_ROUNDS;
+    printf("hash           %.1f ns per state; record (hash + rolling hash + kept state) %.1f ns per tick\n",
+           (t1 - t0) / count * 1e9, (t2 - t1) / count * 1e9);
+    (void)sink;
+    free(d);
+    free(states);
+}
+
+static void PrintSide(const char *name, const PongDesync *d, double noticedMs, double resolvedMs) {
+    char local[PONG_DESYNC_DUMP_TEXT], remote[PONG_DESYNC_DUMP_TEXT];
+    if (d->status != PONG_DESYNC_FOUND || !d->haveLocal || !d->haveRemote) {
+        printf("%s         %s\n", name, (d->status == PONG_DESYNC_NONE) ? "noticed nothing" : "did not get the peer's state");
+        return;
+    }
+
+    pong_desync_dump(&d->local, local, sizeof(local));
+    pong_desync_dump(&d->remote, remote, sizeof(remote));
+    printf("%s         noticed %.0f ms after the flip, both states %.0f ms after; first divergent tick %u%s\n",
+           name, noticedMs, resolvedMs, d->divergedAt, d->exact ? "" : " (or earlier: history too short)");
+    printf(" own state\n%s peer's state\n%s", local, remote);
+}
+
+int main(int argc, char **argv) {
+    const char *linkText = (argc > 1) ? argv[1] : "transatlantic";
+    double injectSecond = (argc > 2) ? atof(argv[2]) : 5.0;
+    PongLinkScript script;
+    if (!pong_link_parse(linkText, &script) || injectSecond < 0.0) {
+        fprintf(stderr, "usage: %s [link] [inject_second]\n", argv[0]);
+        return 1;
+    }
+
+    const uint64_t seed = 42;
+    const double tickMs = 1000.0 / PONG_TICK_RATE;
+    Bench(seed);
+
+    uint32_t ticks = (uint32_t)((injectSecond + GIVE_UP_SECONDS + 5) * PONG_TICK_RATE);
+    PongRollback *peers = calloc(2, sizeof(PongRollback));
+    PongInput *history[2] = { calloc(ticks, sizeof(PongInput)), calloc(ticks, sizeof(PongInput)) };
+    PongLink links[2];
+    bool linked = pong_link_init(&links[0], &script, seed) & pong_link_init(&links[1], &script, seed + 1);
+    if (!peers || !history[0] || !history[1] || !linked) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    Bot bots[2] = { { 0.0f, 0.0f, 2654435761u }, { 0.0f, 0.0f, 2246822519u } };
+    for (int p = 0; p < 2; p++) pong_rollback_init(&peers[p], seed, p, 2);
+
+    uint32_t injectedAt = UINT32_MAX;      // Peer 2's state after this many ticks was flipped, once hashed
+    uint32_t injectedOn = 0;                // Loop tick of the flip
+    uint32_t noticed[2] = { 0 }, resolved[2] = { 0 };
+    uint32_t t = 0;
+    for (; t < ticks; t++) {
+        double now = t * tickMs;
+        for (int p = 0; p < 2; p++) {
+            PongRollback *rb = &peers[p];
+            uint32_t slot = rb->localEnd;
+            if (slot < ticks && pong_rollback_add_local(rb, BotInput(&bots[p], &rb->state, p))) {
+                history[p][slot] = rb->local[slot % PONG_ROLLBACK_HISTORY];
+            }
+
+            unsigned char packet[PONG_ROLLBACK_PACKET_MAX];
+            pong_link_send(&links[p], now, packet, pong_rollback_write_packet(rb, packet, sizeof(packet)), 0);
+            size_t desync = pong_rollback_write_desync(rb, packet, sizeof(packet));
+            if (desync) pong_link_send(&links[p], now, packet, desync, 0);
+        }
+
+        for (int p = 0; p < 2; p++) {
+            PongLinkPacket arrived;
+            while (pong_link_due(&links[1 - p], now, &arrived)) pong_rollback_read_packet(&peers[p], arrived.data, arrived.size);
+        }
+        for (int p = 0; p < 2; p++) pong_rollback_advance(&peers[p]);
+
+        // Flip the newest confirmed state (already hashed) and re-simulate from it: every
+        // input before it is in, so no rollback undoes the flip, and the states after it inherit it
+        PongRollback *victim = &peers[1];
+        uint32_t confirmed = (victim->remoteEnd < victim->tick) ? victim->remoteEnd : victim->tick;
+        PongState *target = (confirmed == victim->tick) ? &victim->state : &victim->snapshots[confirmed % PONG_ROLLBACK_WINDOW];
+        if (injectedAt == UINT32_MAX && now >= injectSecond * 1000.0 && target->gameState == GAME_PLAYING) {
+            FlipBallX(target);
+            if (confirmed < victim->rollbackFrom && confirmed < victim->tick) victim->rollbackFrom = confirmed;
+            injectedAt = confirmed;
+            injectedOn = t;
+        }
+
+        for (int p = 0; p < 2; p++) {
+            const PongDesync *d = &peers[p].desync;
+            if (!noticed[p] && d->status != PONG_DESYNC_NONE) noticed[p] = t;
+            if (!resolved[p] && d->status == PONG_DESYNC_FOUND && d->haveRemote) resolved[p] = t;
+        }
+        if (resolved[0] && resolved[1]) break;
+        if (injectedAt != UINT32_MAX && t - injectedOn > GIVE_UP_SECONDS * PONG_TICK_RATE) break;
+    }
+
+    printf("link           %s; %u ticks played, ", linkText, t);
+    if (injectedAt == UINT32_MAX) {
+        printf("no chance to inject\n");
+        return 1;
+    }
+
+    // Where the two sides really parted: straight runs over the inputs, one of them flipped
+    PongState straight[2];
+    uint32_t truth = UINT32_MAX;
+    pong_init(&straight[0], seed);
+    pong_init(&straight[1], seed);
+    for (uint32_t n = 0; n < ticks && truth == UINT32_MAX; n++) {
+        if (n > injectedAt && !SameImage(&straight[0], &straight[1])) truth = n;
+        if (n == injectedAt) FlipBallX(&straight[1]);
+        for (int s = 0; s < 2; s++) pong_step(&straight[s], history[0][n] | history[1][n], PONG_TICK_DT);
+    }
+    printf("ball x flipped in peer 2's state after %u ticks; the confirmed states first differ after %u\n", injectedAt, truth);
+
+    bool ok = true;
+    for (int p = 0; p < 2; p++) {
+        const PongDesync *d = &peers[p].desync;
+        PrintSide(p ? "peer 2" : "peer 1", d, (noticed[p] - injectedOn) * tickMs, (resolved[p] - injectedOn) * tickMs);
+        ok &= d->status == PONG_DESYNC_FOUND && d->haveRemote && d->divergedAt == truth && !SameImage(&d->local, &d->remote);
+    }
+    printf("verify         %s\n", ok ? "both peers found the first divergent tick and traded its states" : "FAILED");
+
+    pong_link_free(&links[0]);
+    pong_link_free(&links[1]);
+    free(history[0]);
+    free(history[1]);
+    free(peers);
+    return ok ? 0 : 1;
+}
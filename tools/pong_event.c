@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_event.h"
+#include "pong_tool_common.h"
+
+/*
+*  Event-driven engine
+*  ----------------------------------------------------------------------------------
+*  check: plays CPU-vs-CPU matches twice side by side, once a tick at a time with
+*  pong_event_step() and once with pong_event_run() to random checkpoints (with
+*  the odd single step mixed in), and compares the state image and both CPUs at
+*  every checkpoint. Any difference is a failure.
+*
+*  speed: the same matches played to the end each way, timed, with the share of
+*  ticks that still went through pong_step().
+*
+*  Build with SIM_MODE=-DPONG_FIXED_POINT to check the fixed-point rules.
+*
+*  make headless
+*  ./bin/pong_event [matches] [cpu1 cpu2]       (cpu: easy, normal, hard or reaction_ms,error_px)
+*/
+
+#define MAX_TICKS_PER_MATCH ((uint64_t)PONG_TICK_RATE * 3600)
+
+static bool SameCpu(const PongCpu *a, const PongCpu *b) {
+    return a->draws == b->draws && a->reactIn == b->reactIn &&
+           memcmp(&a->target, &b->target, sizeof(a->target)) == 0 &&
+           memcmp(&a->seenVelocity, &b->seenVelocity, sizeof(a->seenVelocity)) == 0;
+}
+
+static bool SameMatch(const PongEventMatch *a, const PongEventMatch *b) {
+    unsigned char x[PONG_STATE_BYTES], y[PONG_STATE_BYTES];
+    pong_state_pack(&a->state, x);
+    pong_state_pack(&b->state, y);
+    return a->tick == b->tick && memcmp(x, y, PONG_STATE_BYTES) == 0 &&
+           SameCpu(&a->cpus[0], &b->cpus[0]) && SameCpu(&a->cpus[1], &b->cpus[1]);
+}
+
+static void InitMatch(PongEventMatch *m, int index, PongCpuConfig player1, PongCpuConfig player2) {
+    pong_event_init(m, 1000u + (uint64_t)index, player1, player2, 77u + 2u * (uint64_t)index);
+}
+
+static bool Check(int matches, PongCpuConfig player1, PongCpuConfig player2) {
+    long checkpoints = 0;
+    for (int i = 0; i < matches; i++) {
+        PongEventMatch stepped, event;
+        InitMatch(&stepped, i, player1, player2);
+        InitMatch(&event, i, player1, player2);
+        unsigned int rng = 2654435761u + (unsigned)i;
+
+        while (stepped.state.gameState != GAME_OVER && stepped.tick < MAX_TICKS_PER_MATCH) {
+            uint64_t checkpoint = stepped.tick + 1 + NextRandom(&rng) % 2000;
+            while (stepped.tick < checkpoint && stepped.state.gameState != GAME_OVER) pong_event_step(&stepped);
+            pong_event_run(&event, checkpoint);
+            checkpoints++;
+
+            if (!SameMatch(&stepped, &event)) {
+                printf("check          FAILED: match %d differs at tick %llu (event engine at %llu)\n", i,
+                       (unsigned long long)stepped.tick, (unsigned long long)event.tick);
+                return false;
+            }
+            if (NextRandom(&rng) % 8 == 0 && stepped.state.gameState != GAME_OVER) {
+                pong_event_step(&stepped);
+                pong_event_step(&event);
+            }
+        }
+    }
+    printf("check          %d matches identical at %ld checkpoints\n", matches, checkpoints);
+    return true;
+}
+
+static void Speed(int matches, PongCpuConfig player1, PongCpuConfig player2) {
+    uint64_t ticks = 0, stepped = 0, jumps = 0, checksum = 0;
+    int rallies = 0;
+
+    double t0 = pong_clock_now();
+    for (int i = 0; i < matches; i++) {
+        PongEventMatch m;
+        InitMatch(&m, i, player1, player2);
+        while (m.state.gameState != GAME_OVER && m.tick < MAX_TICKS_PER_MATCH) pong_event_step(&m);
+        checksum += m.tick;
+    }
+    double fixedSeconds = pong_clock_now() - t0;
+
+    t0 = pong_clock_now();
+    for (int i = 0; i < matches; i++) {
+        PongEventMatch m;
+        InitMatch(&m, i, player1, player2);
+        pong_event_run(&m, MAX_TICKS_PER_MATCH);
+        ticks += m.tick;
+        stepped += m.stepped;
+        jumps += m.jumps;
+        rallies += m.state.score1 + m.state.score2;
+    }
+    double eventSeconds = pong_clock_now() - t0;
+
+    printf("speed          %d matches, %d rallies, %llu ticks%s\n", matches, rallies, (unsigned long long)ticks,
+           checksum == ticks ? "" : " (tick counts differ!)");
+    printf("               fixed step   %8.2f ms   %6.1f ns per tick\n", fixedSeconds * 1e3, fixedSeconds / ticks * 1e9);
+    printf("               event driven %8.2f ms   %6.1f ns per tick   %.1fx\n", eventSeconds * 1e3, eventSeconds / ticks * 1e9,
+           fixedSeconds / eventSeconds);
+    printf("               per rally %.1f ticks stepped, %.1f skipped in %.1f jumps\n", (double)stepped / rallies,
+           (double)(ticks - stepped) / rallies, (double)jumps / rallies);
+}
+
+int main(int argc, char **argv) {
+    int matches = (argc > 1) ? atoi(argv[1]) : 200;
+    PongCpuConfig player1 = pong_cpu_levels[1].config, player2 = pong_cpu_levels[2].config;
+    if (matches <= 0 || argc == 3 || argc > 4 ||
+        (argc == 4 && (!pong_cpu_parse(argv[2], &player1) || !pong_cpu_parse(argv[3], &player2)))) {
+        fprintf(stderr, "usage: %s [matches] [cpu1 cpu2]   (cpu: easy, normal, hard or reaction_ms,error_px)\n", argv[0]);
+        return 1;
+    }
+
+    if (!Check(matches, player1, player2)) return 1;
+    Speed(matches, player1, player2);
+    return 0;
+}
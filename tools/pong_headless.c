@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/sim/pong.h"
+#include "../src/sim/pong_clock.h"
+#include "pong_tool_common.h"
+
+/*
+*  Headless match runner
+*  ----------------------------------------------------------------------------------
+*  Plays bot-vs-bot matches through pong_step() without a window and reports how
+*  many simulation steps per second the core sustains.
+*
+*  make headless
+*  ./bin/pong_headless [matches] [tick_hz] [seed]
+*/
+
+#define MAX_STEPS_PER_MATCH 10000000    // Safety net against a rally that never ends
+
+int main(int argc, char **argv) {
+    int matches = (argc > 1) ? atoi(argv[1]) : 10000;
+    int tickRate = (argc > 2) ? atoi(argv[2]) : PONG_TICK_RATE;
+    unsigned int seed = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 10) : 1;
+
+    if (matches <= 0 || tickRate <= 0) {
+        fprintf(stderr, "usage: %s [matches] [tick_hz] [seed]\n", argv[0]);
+        return 1;
+    }
+
+    float dt = 1.0f / (float)tickRate;
+    long long totalSteps = 0;
+    int wins1 = 0, wins2 = 0, unfinished = 0;
+
+    double start = pong_clock_now();
+
+    for (int m = 0; m < matches; m++) {
+        PongState state;
+        pong_init(&state, seed + (unsigned int)m);
+
+        Bot bot1 = { 0.0f, 0.0f, (seed + (unsigned int)m) * 2654435761u | 1u };
+        Bot bot2 = { 0.0f, 0.0f, (seed + (unsigned int)m) * 2246822519u | 1u };
+
+        long long steps = 0;
+        while (state.gameState != GAME_OVER && steps < MAX_STEPS_PER_MATCH) {
+            PongInput input = BotInput(&bot1, &state, 0) | BotInput(&bot2, &state, 1);
+
+            pong_step(&state, input, dt);
+            steps++;
+        }
+
+        totalSteps += steps;
+        if (state.gameState != GAME_OVER) unfinished++;
+        else if (state.score1 >= WINNING_SCORE) wins1++;
+        else wins2++;
+    }
+
+    double elapsed = pong_clock_now() - start;
+
+    printf("matches        %d (p1 %d, p2 %d, unfinished %d)\n", matches, wins1, wins2, unfinished);
+    printf("tick rate      %d Hz\n", tickRate);
+    printf("steps          %lld (%.1f per match, %.1f s game time each)\n",
+           totalSteps, (double)totalSteps / matches, (double)totalSteps / matches / tickRate);
+    printf("wall time      %.3f s\n", elapsed);
+    printf("steps/sec      %.0f\n", (double)totalSteps / elapsed);
+    printf("matches/min    %.0f\n", matches / elapsed * 60.0);
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_input.h"
+#include "pong_tool_common.h"
+
+/*
+*  Input latency benchmark
+*  ----------------------------------------------------------------------------------
+*  Plays a scripted player holding W or S for random stretches (60-400 ms, with
+*  both keys up for some of them) and feeds the same keys to the simulation three
+*  ways, each stepping its own paddle with pong_step():
+*
+*  frame:    the keys as seen once per display frame, whole ticks (the old loop)
+*  polled:   the keys polled every poll_ms, whole ticks
+*  stamped:  the keys polled every poll_ms into a PongKeyLog, sub-tick holds
+*
+*  A key change's latency is how long the paddle kept its old speed: the distance
+*  it is behind the ideal paddle (which changes speed exactly at the change) once
+*  things settle, over the change in speed. Negative means it moved early - a
+*  whole tick takes a change from the start of the tick it happened in.
+*
+*  make headless
+*  ./bin/pong_input_bench [seconds] [display_hz] [poll_ms]
+*/
+
+#define SETTLE_SECONDS 0.04             // Every mode has answered a change by then
+#define MIN_HOLD       0.06
+#define FRAME_PHASE    0.0013           // Display frames do not line up with tick ends
+
+typedef struct {
+    double time;                        // When the keys changed
+    PongInput keys;                     // W/S state from then on
+} Change;
+
+typedef struct {
+    Change *changes;
+    int count;
+} Script;
+
+static double Uniform(unsigned int *rng, double lo, double hi) {
+    return lo + (hi - lo) * (double)(NextRandom(rng) % 1000000u) / 999999.0;
+}
+
+static bool MakeScript(Script *script, double seconds, unsigned int seed) {
+    int capacity = (int)(seconds / MIN_HOLD) + 2;
+    script->changes = malloc((size_t)capacity * sizeof(Change));
+    script->count = 0;
+    if (!script->changes) return false;
+
+    unsigned int rng = seed;
+    double t = 0.05;
+    while (t < seconds && script->count < capacity) {
+        unsigned int pick = NextRandom(&rng) % 3;
+        PongInput keys = (pick == 0) ? 0 : (pick == 1) ? PONG_INPUT_P1_UP : PONG_INPUT_P1_DOWN;
+        script->changes[script->count++] = (Change){ t, keys };
+        t += Uniform(&rng, MIN_HOLD, 0.4);
+    }
+    return true;
+}
+
+// Keys down at time t
+static PongInput KeysAt(const Script *script, double t) {
+    PongInput keys = 0;
+    for (int i = 0; i < script->count && script->changes[i].time <= t; i++) keys = script->changes[i].keys;
+    return keys;
+}
+
+// Paddle travel of one tick under input, from pong_step() on a paddle far from the walls
+static float TickTravel(const PongState *serve, PongInput input) {
+    PongState state = *serve;
+    pong_step(&state, input, PONG_TICK_DT);
+    return state.player1.position.y - serve->player1.position.y;
+}
+
+// Ideal paddle at time t: moves at full speed exactly while a key is down
+static double IdealAt(const Script *script, double t, double speed) {
+    double y = 0.0, from = 0.0;
+    PongInput keys = 0;
+    for (int i = 0; i < script->count && script->changes[i].time < t; i++) {
+        if (keys & PONG_INPUT_P1_UP)   y -= speed * (script->changes[i].time - from);
+        if (keys & PONG_INPUT_P1_DOWN) y += speed * (script->changes[i].time - from);
+        from = script->changes[i].time;
+        keys = script->changes[i].keys;
+    }
+    if (keys & PONG_INPUT_P1_UP)   y -= speed * (t - from);
+    if (keys & PONG_INPUT_P1_DOWN) y += speed * (t - from);
+    return y;
+}
+
+static double Velocity(PongInput keys, double speed) {
+    return (keys & PONG_INPUT_P1_UP) ? -speed : (keys & PONG_INPUT_P1_DOWN) ? speed : 0.0;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// y and ideal: ticks + 1 paddle positions, at the end of each tick
+static void Report(const char *name, const double *y, const double *ideal, int ticks, const Script *script, double speed) {
+    double *lags = malloc((size_t)script->count * sizeof(double));
+    int count = 0;
+    if (!lags) return;
+
+    for (int j = 1; j < script->count; j++) {
+        const Change *change = &script->changes[j];
+        double dv = Velocity(change->keys, speed) - Velocity(change[-1].keys, speed);
+        int a = (int)floor(change->time / PONG_TICK_DT);            // The last tick end at or before the change
+        int b = a + (int)ceil(SETTLE_SECONDS / PONG_TICK_DT);
+        if (dv == 0.0 || b > ticks || (j + 1 < script->count && change[1].time <= b * (double)PONG_TICK_DT)) continue;
+
+        lags[count++] = ((ideal[b] - ideal[a]) - (y[b] - y[a])) / dv;
+    }
+    if (count == 0) {
+        free(lags);
+        return;
+    }
+
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) sum += lags[i];
+    qsort(lags, (size_t)count, sizeof(double), CompareDouble);
+    printf("%-9s latency %6.2f ms mean, %6.2f p1, %6.2f p50, %6.2f p99 (%.2f ms spread) over %d changes\n", name,
+           sum / count * 1e3, lags[count / 100] * 1e3, lags[count / 2] * 1e3, lags[count * 99 / 100] * 1e3,
+           (lags[count * 99 / 100] - lags[count / 100]) * 1e3, count);
+    free(lags);
+}
+
+int main(int argc, char **argv) {
+    double seconds = (argc > 1) ? atof(argv[1]) : 600.0;
+    int displayHz = (argc > 2) ? atoi(argv[2]) : 60;
+    double pollMs = (argc > 3) ? atof(argv[3]) : 1.0;
+    if (seconds <= 0.0 || displayHz <= 0 || pollMs <= 0.0) {
+        fprintf(stderr, "usage: %s [seconds] [display_hz] [poll_ms]\n", argv[0]);
+        return 1;
+    }
+
+    Script script;
+    if (!MakeScript(&script, seconds, 2463534242u)) return 1;
+
+    // A paddle in the serve state moves without the ball going anywhere
+    PongState serve;
+    pong_init(&serve, 1u);
+    pong_step(&serve, PONG_INPUT_SERVE, PONG_TICK_DT);
+    double speed = TickTravel(&serve, PONG_INPUT_P1_DOWN) / (double)PONG_TICK_DT;
+
+    int ticks = (int)(seconds * PONG_TICK_RATE);
+    double *ideal = malloc((size_t)(ticks + 1) * sizeof(double));
+    double *frame = malloc((size_t)(ticks + 1) * sizeof(double));
+    double *polled = malloc((size_t)(ticks + 1) * sizeof(double));
+    double *stamped = malloc((size_t)(ticks + 1) * sizeof(double));
+    static PongKeyLog log;
+    if (!ideal || !frame || !polled || !stamped) return 1;
+    pong_keylog_init(&log);
+
+    double poll = pollMs * 1e-3, framePeriod = 1.0 / displayHz;
+    double nextPoll = 0.0;
+    PongInput logged = 0;
+    ideal[0] = frame[0] = polled[0] = stamped[0] = 0.0;
+    for (int i = 1; i <= ticks; i++) {
+        double start = (i - 1) * (double)PONG_TICK_DT, end = i * (double)PONG_TICK_DT;
+
+        // A tick runs once it is over, with whatever its loop has seen by then
+        double lastFrame = floor((end - FRAME_PHASE) / framePeriod) * framePeriod + FRAME_PHASE;
+        double lastPoll = floor(end / poll) * poll;
+        frame[i] = frame[i - 1] + TickTravel(&serve, KeysAt(&script, lastFrame));
+        polled[i] = polled[i - 1] + TickTravel(&serve, KeysAt(&script, lastPoll));
+
+        for (; nextPoll <= end; nextPoll += poll) {
+            PongInput keys = KeysAt(&script, nextPoll);
+            for (PongInput key = PONG_INPUT_P1_UP; key <= PONG_INPUT_P1_DOWN; key <<= 1) {
+                if ((keys ^ logged) & key) pong_keylog_push(&log, nextPoll, key, (keys & key) != 0);
+            }
+            logged = keys;
+        }
+        stamped[i] = stamped[i - 1] + TickTravel(&serve, pong_keylog_tick(&log, start, end));
+        ideal[i] = IdealAt(&script, end, speed);
+    }
+
+    printf("%.0f s of play, %d key changes, %d Hz display, %g ms polls, %d Hz ticks\n", seconds, script.count, displayHz,
+           pollMs, PONG_TICK_RATE);
+    Report("frame", frame, ideal, ticks, &script, speed);
+    Report("polled", polled, ideal, ticks, &script, speed);
+    Report("stamped", stamped, ideal, ticks, &script, speed);
+
+    free(ideal);
+    free(frame);
+    free(polled);
+    free(stamped);
+    free(script.changes);
+    return 0;
+}
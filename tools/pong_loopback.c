@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/net/pong_udp.h"
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_link.h"
+#include "../src/sim/pong_rollback.h"
+#include "pong_tool_common.h"
+
+/*
+*  Rollback loopback harness
+*  ----------------------------------------------------------------------------------
+*  Two rollback peers in one process, each with its own UDP socket on 127.0.0.1,
+*  played by bots. Every packet crosses an emulated link (src/sim/pong_link.h:
+*  a profile name such as bad-wifi, or keys like delay=50,jitter=10,loss=1)
+*  before it goes out on the socket. Time is virtual - one loop iteration per
+*  tick - so a two-minute match runs in well under a second and always sees
+*  exactly what the link script says.
+*
+*  At the end each peer's last confirmed state is compared with a plain pong_step()
+*  run over the inputs both bots actually produced.
+*
+*  make headless
+*  ./bin/pong_loopback [link] [seconds] [input_delay_ticks]
+*/
+
+static bool SameState(const PongState *a, const PongState *b) {
+    return memcmp(&a->ball.position, &b->ball.position, sizeof(Vector2)) == 0 &&
+           memcmp(&a->ball.velocity, &b->ball.velocity, sizeof(Vector2)) == 0 &&
+           a->player1.position.y == b->player1.position.y && a->player2.position.y == b->player2.position.y &&
+           a->score1 == b->score1 && a->score2 == b->score2 && a->gameState == b->gameState &&
+           a->serveDirection == b->serveDirection && a->rngCounter == b->rngCounter;
+}
+
+int main(int argc, char **argv) {
+    const char *linkText = (argc > 1) ? argv[1] : "delay=50,jitter=10";
+    int seconds = (argc > 2) ? atoi(argv[2]) : 120;
+    int inputDelay = (argc > 3) ? atoi(argv[3]) : 2;
+    PongLinkScript script;
+    if (!pong_link_parse(linkText, &script) || seconds <= 0 || inputDelay < 0) {
+        fprintf(stderr, "usage: %s [link] [seconds] [input_delay_ticks]\n", argv[0]);
+        return 1;
+    }
+
+    const uint64_t seed = 42;
+    const double tickMs = 1000.0 / PONG_TICK_RATE;
+    uint32_t ticks = (uint32_t)seconds * PONG_TICK_RATE;
+
+    PongRollback *peers = calloc(2, sizeof(PongRollback));
+    PongInput *history[2] = { calloc(ticks + PONG_ROLLBACK_WINDOW, sizeof(PongInput)),
+                              calloc(ticks + PONG_ROLLBACK_WINDOW, sizeof(PongInput)) };
+    PongLink links[2];
+    PongUdp sockets[2];
+    bool linked = pong_link_init(&links[0], &script, seed) & pong_link_init(&links[1], &script, seed + 1);
+    if (!peers || !history[0] || !history[1] || !linked) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    if (!pong_udp_open(&sockets[0], 0) || !pong_udp_open(&sockets[1], 0) ||
+        !pong_udp_connect(&sockets[0], "127.0.0.1", pong_udp_port(&sockets[1])) ||
+        !pong_udp_connect(&sockets[1], "127.0.0.1", pong_udp_port(&sockets[0]))) {
+        fprintf(stderr, "could not open loopback UDP sockets\n");
+        return 1;
+    }
+
+    Bot bots[2] = { { 0.0f, 0.0f, 2654435761u }, { 0.0f, 0.0f, 2246822519u } };
+    long packets = 0, packetBytes = 0;
+    double simSeconds = 0.0;
+
+    pong_rollback_init(&peers[0], seed, 0, inputDelay);
+    pong_rollback_init(&peers[1], seed, 1, inputDelay);
+
+    for (uint32_t t = 0; t < ticks; t++) {
+        double now = t * tickMs;
+
+        for (int p = 0; p < 2; p++) {
+            PongRollback *rb = &peers[p];
+            uint32_t slot = rb->localEnd;
+            if (slot < ticks && pong_rollback_add_local(rb, BotInput(&bots[p], &rb->state, p))) {
+                history[p][slot] = rb->local[slot % PONG_ROLLBACK_HISTORY];
+            }
+
+            unsigned char packet[PONG_ROLLBACK_PACKET_MAX];
+            size_t size = pong_rollback_write_packet(rb, packet, sizeof(packet));
+            pong_link_send(&links[p], now, packet, size, 0);
+            packets++;
+            packetBytes += (long)size;
+        }
+
+        // Put every packet that has crossed the link on the wire, in arrival order
+        for (int p = 0; p < 2; p++) {
+            PongLinkPacket arrived;
+            while (pong_link_due(&links[p], now, &arrived)) pong_udp_send(&sockets[p], arrived.data, arrived.size);
+        }
+
+        for (int p = 0; p < 2; p++) {
+            unsigned char packet[PONG_ROLLBACK_PACKET_MAX];
+            int size;
+            while ((size = pong_udp_recv(&sockets[p], packet, sizeof(packet))) > 0) {
+                pong_rollback_read_packet(&peers[p], packet, (size_t)size);
+            }
+        }
+
+        double t0 = pong_clock_now();
+        for (int p = 0; p < 2; p++) pong_rollback_advance(&peers[p]);
+        simSeconds += pong_clock_now() - t0;
+    }
+
+    // Check each peer's confirmed state against a straight run over the real inputs
+    int agreed = 0;
+    uint32_t confirmedTicks[2];
+    for (int p = 0; p < 2; p++) {
+        const PongState *confirmed = pong_rollback_confirmed(&peers[p], &confirmedTicks[p]);
+        PongState reference;
+        pong_init(&reference, seed);
+        for (uint32_t t = 0; t < confirmedTicks[p]; t++) pong_step(&reference, history[0][t] | history[1][t], PONG_TICK_DT);
+        agreed += confirmed && SameState(confirmed, &reference);
+    }
+
+    printf("link           %s one way, input delay %d ticks (%.1f ms)\n", linkText, inputDelay, inputDelay * tickMs);
+    for (int p = 0; p < 2; p++) {
+        const PongLink *link = &links[p];
+        printf("  %d -> %d       %llu sent, %llu lost, %llu duplicated, %llu reordered\n", p + 1, 2 - p,
+               (unsigned long long)link->sent, (unsigned long long)link->lost, (unsigned long long)link->duplicated,
+               (unsigned long long)link->reordered);
+    }
+    for (int p = 0; p < 2; p++) {
+        const PongRollback *rb = &peers[p];
+        printf("peer %d         tick %u, score %d-%d, %llu rollbacks (%.1f ticks avg, %u max), %llu stalls\n",
+               p + 1, rb->tick, rb->state.score1, rb->state.score2, (unsigned long long)rb->rollbacks,
+               rb->rollbacks ? (double)rb->resimulated / (double)rb->rollbacks : 0.0, rb->maxRollback,
+               (unsigned long long)rb->stalls);
+    }
+    printf("packets        %ld, %.1f bytes average\n", packets, (double)packetBytes / (double)packets);
+    printf("cpu            %.0f ns per peer tick, rollbacks included\n", simSeconds / (2.0 * ticks) * 1e9);
+    printf("verify         %d/2 peers' confirmed state (tick %u, %u) matches a straight run\n",
+           agreed, confirmedTicks[0], confirmedTicks[1]);
+
+    pong_udp_close(&sockets[0]);
+    pong_udp_close(&sockets[1]);
+    pong_link_free(&links[0]);
+    pong_link_free(&links[1]);
+    free(history[0]);
+    free(history[1]);
+    free(peers);
+    return (agreed == 2) ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+#define _POSIX_C_SOURCE 200809L
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/net/pong_multiserver.h"
+#include "../src/net/pong_server.h"
+#include "../src/sim/pong_clock.h"
+#include "pong_tool_common.h"
+
+/*
+*  Multi-match server (Linux)
+*  ----------------------------------------------------------------------------------
+*  serve: host matches for real game clients until Ctrl-C, then print each
+*  shard's tick-time percentiles. Match m is on port base + m % shards:
+*  ./bin/build_osx --server host:<that port> --match m, twice.
+*
+*  bench: load test. Every match is pre-seated and played by bots on the shard
+*  threads; snapshots go out with sendmmsg() to a loopback socket nobody reads, so
+*  the tick includes the full send path. Prints per-shard percentiles and the
+*  number of matches one core can hold inside the tick budget.
+*
+*  clients: end to end over loopback. Opens two PongRemote clients per match
+*  that JOIN through the epoll path and play in real time.
+*
+*  make headless
+*  ./bin/pong_multiserver serve [base_port] [shards] [matches_per_shard] [tick_hz]
+*  ./bin/pong_multiserver bench [matches] [shards] [seconds] [tick_hz]
+*  ./bin/pong_multiserver clients [matches] [seconds]
+*/
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void OnInterrupt(int sig) {
+    (void)sig;
+    interrupted = 1;
+}
+
+static void SleepSeconds(double seconds) {
+    if (seconds <= 0.0) return;
+    struct timespec ts = { (time_t)seconds, (long)((seconds - (double)(time_t)seconds) * 1e9) };
+    nanosleep(&ts, NULL);
+}
+
+// Shard-thread callback: match ids are 0 .. matches - 1, each bot is touched by one shard only
+static PongInput ShardBot(void *user, uint32_t match, int player, const PongState *state) {
+    Bot *bots = user;
+    return BotInput(&bots[match * 2 + (uint32_t)player], state, player);
+}
+
+static Bot *MakeBots(int count) {
+    Bot *bots = malloc((size_t)count * sizeof(Bot));
+    if (!bots) return NULL;
+    for (int i = 0; i < count; i++) bots[i] = (Bot){ 0.0f, 0.0f, 2654435761u ^ (unsigned int)(i * 2246822519u) ^ 1u };
+    return bots;
+}
+
+static void PrintReports(const PongMultiServer *ms) {
+    printf("shard  matches   ticks  overruns   mean     p50     p90     p99   p99.9     max (us)  packets in/out\n");
+    for (int i = 0; i < ms->shardCount; i++) {
+        PongShardReport r;
+        pong_multiserver_report(ms, i, &r);
+        printf("%5d  %7d  %6llu  %8llu  %6.1f  %6.1f  %6.1f  %6.1f  %6.1f  %6.1f       %llu/%llu\n",
+               i, r.matches, (unsigned long long)r.ticks, (unsigned long long)r.overruns,
+               r.meanUs, r.p50Us, r.p90Us, r.p99Us, r.p999Us, r.maxUs,
+               (unsigned long long)r.packetsIn, (unsigned long long)r.packetsOut);
+    }
+}
+
+static int Serve(uint16_t basePort, int shards, int perShard, int tickRate) {
+    PongMultiServer ms;
+    if (!pong_multiserver_init(&ms, basePort, shards, perShard, tickRate, (uint64_t)time(NULL)) || !pong_multiserver_start(&ms)) {
+        fprintf(stderr, "cannot start: ports %u-%u in use, or the tick rate does not divide %d\n",
+                basePort, basePort + shards - 1, PONG_TICK_RATE);
+        return 1;
+    }
+
+    printf("%d shards on ports %u-%u, up to %d matches each, %d Hz; Ctrl-C to stop\n",
+           shards, basePort, basePort + shards - 1, perShard, tickRate);
+    signal(SIGINT, OnInterrupt);
+    while (!interrupted) SleepSeconds(0.1);
+
+    pong_multiserver_stop(&ms);
+    PrintReports(&ms);
+    pong_multiserver_free(&ms);
+    return 0;
+}
+
+// Simulation and snapshot encoding alone, one thread, no sockets
+static double SimNsPerMatchTick(Bot *bots, int matches, int stepsPerTick) {
+    PongAuthority *auths = malloc((size_t)matches * sizeof(PongAuthority));
+    unsigned char (*snapshots)[PONG_SNAPSHOT_PACKET_MAX] = malloc((size_t)matches * 2 * PONG_SNAPSHOT_PACKET_MAX);
+    if (!auths || !snapshots) return 0.0;
+    for (int m = 0; m < matches; m++) pong_authority_init(&auths[m], (uint64_t)m);
+
+    int ticks = 240;
+    double start = pong_clock_now();
+    for (int t = 0; t < ticks; t++) {
+        for (int m = 0; m < matches; m++) {
+            for (int s = 0; s < stepsPerTick; s++) {
+                for (int p = 0; p < 2; p++) pong_authority_queue_input(&auths[m], p, BotInput(&bots[m * 2 + p], &auths[m].state, p));
+                pong_authority_step(&auths[m]);
+            }
+            for (int p = 0; p < 2; p++) pong_authority_write_snapshot(&auths[m], p, snapshots[m * 2 + p], PONG_SNAPSHOT_PACKET_MAX);
+        }
+    }
+    double ns = (pong_clock_now() - start) / ((double)ticks * matches) * 1e9;
+
+    free(snapshots);
+    free(auths);
+    return ns;
+}
+
+static int Bench(int matches, int shards, double seconds, int tickRate) {
+    PongMultiServer ms;
+    Bot *bots = MakeBots(matches * 2);
+    int perShard = (matches + shards - 1) / shards;
+    if (!bots || !pong_multiserver_init(&ms, 0, shards, perShard, tickRate, 42)) {
+        fprintf(stderr, "cannot set up %d matches on %d shards (tick rate must divide %d)\n", matches, shards, PONG_TICK_RATE);
+        return 1;
+    }
+
+    // Every snapshot goes to one loopback socket that is never read: the kernel
+    // drops them at its full buffer, after the server has paid for the send
+    PongUdp sink;
+    if (!pong_udp_open(&sink, 0)) {
+        fprintf(stderr, "cannot open the sink socket\n");
+        return 1;
+    }
+    PongUdpAddr to = { 0x7F000001u, pong_udp_port(&sink) };
+    for (int m = 0; m < matches; m++) pong_multiserver_seat(&ms, (uint32_t)m, &to, &to);
+
+    ms.botInput = ShardBot;
+    ms.botUser = bots;
+    pong_multiserver_start(&ms);
+    SleepSeconds(seconds);
+    pong_multiserver_stop(&ms);
+
+    double budgetUs = 1e6 / tickRate;
+    double busiest = 0.0, totalUs = 0.0, perMatchNs = 0.0;
+    uint64_t overruns = 0;
+    for (int i = 0; i < shards; i++) {
+        PongShardReport r;
+        pong_multiserver_report(&ms, i, &r);
+        if (r.p99Us > busiest) busiest = r.p99Us;
+        if (r.matches > 0) perMatchNs += r.meanUs * 1e3 / r.matches / shards;
+        totalUs += r.meanUs * (double)r.ticks;
+        overruns += r.overruns;
+    }
+
+    // Fresh bots for the socket-free run, so both see matches from their start
+    Bot *simBots = MakeBots(perShard * 2);
+    double simNs = simBots ? SimNsPerMatchTick(simBots, perShard, ms.stepsPerTick) : 0.0;
+
+    printf("%d matches on %d shards, %d Hz server tick (%d simulation ticks each, budget %.0f us)\n",
+           matches, shards, tickRate, ms.stepsPerTick, budgetUs);
+    PrintReports(&ms);
+    printf("busiest p99    %.0f us of %.0f us budget, %llu overruns\n", busiest, budgetUs, (unsigned long long)overruns);
+    printf("per match      %.0f ns per server tick (%.0f ns simulation + snapshots, the rest sendmmsg)\n", perMatchNs, simNs);
+    printf("capacity       %.0f matches per core at %d Hz (100%% of a core), %.0f simulating only\n",
+           perMatchNs > 0.0 ? budgetUs * 1e3 / perMatchNs : 0.0, tickRate, simNs > 0.0 ? budgetUs * 1e3 / simNs : 0.0);
+    printf("cpu            %.2f s of shard time in %.1f s\n", totalUs * 1e-6, seconds);
+
+    pong_udp_close(&sink);
+    pong_multiserver_free(&ms);
+    free(simBots);
+    free(bots);
+    return 0;
+}
+
+static int Clients(int matches, double seconds) {
+    const int shards = 2;
+    PongMultiServer ms;
+    PongRemote *remotes = calloc((size_t)matches * 2, sizeof(PongRemote));
+    Bot *bots = MakeBots(matches * 2);
+    if (!remotes || !bots || !pong_multiserver_init(&ms, 0, shards, matches, 120, 7) || !pong_multiserver_start(&ms)) {
+        fprintf(stderr, "cannot start the server\n");
+        return 1;
+    }
+
+    for (int i = 0; i < matches * 2; i++) {
+        uint32_t match = (uint32_t)(i / 2);
+        if (!pong_remote_connect(&remotes[i], "127.0.0.1", pong_multiserver_port(&ms, match), match)) {
+            fprintf(stderr, "cannot open client sockets\n");
+            return 1;
+        }
+    }
+
+    // Clients tick at the simulation rate in real time, like the game does
+    double start = pong_clock_now(), next = start;
+    uint64_t ticks = 0;
+    while (pong_clock_now() - start < seconds) {
+        for (int i = 0; i < matches * 2; i++) {
+            PongState view = pong_client_view(&remotes[i].client);
+            int player = remotes[i].client.player;
+            pong_remote_tick(&remotes[i], BotInput(&bots[i], &view, player));
+        }
+        ticks++;
+        next += 1.0 / PONG_TICK_RATE;
+        SleepSeconds(next - pong_clock_now());
+    }
+    pong_multiserver_stop(&ms);
+
+    int playing = 0, scored = 0;
+    uint64_t corrections = 0, snapshots = 0;
+    for (int i = 0; i < matches * 2; i++) {
+        const PongClient *client = &remotes[i].client;
+        playing += client->snapshots > 0;
+        scored += (i % 2 == 0) && client->server.score1 + client->server.score2 > 0;
+        corrections += client->corrections;
+        snapshots += client->snapshots;
+    }
+
+    PrintReports(&ms);
+    printf("clients        %d/%d got snapshots, %llu per client on average over %llu client ticks\n",
+           playing, matches * 2, (unsigned long long)(snapshots / (uint64_t)(matches * 2)), (unsigned long long)ticks);
+    printf("matches        %d/%d have a goal on the board\n", scored, matches);
+    printf("corrections    %llu own-paddle corrections in total\n", (unsigned long long)corrections);
+
+    for (int i = 0; i < matches * 2; i++) pong_remote_close(&remotes[i]);
+    pong_multiserver_free(&ms);
+    free(remotes);
+    free(bots);
+    return (playing == matches * 2) ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    const char *mode = (argc > 1) ? argv[1] : "";
+
+    if (strcmp(mode, "serve") == 0) {
+        int port = (argc > 2) ? atoi(argv[2]) : 7777;
+        int shards = (argc > 3) ? atoi(argv[3]) : 1;
+        int perShard = (argc > 4) ? atoi(argv[4]) : 4096;
+        int tickRate = (argc > 5) ? atoi(argv[5]) : 120;
+        if (port > 0 && shards > 0 && port + shards <= 65536 && perShard > 0 && tickRate > 0) {
+            return Serve((uint16_t)port, shards, perShard, tickRate);
+        }
+    } else if (strcmp(mode, "bench") == 0) {
+        int matches = (argc > 2) ? atoi(argv[2]) : 10000;
+        int shards = (argc > 3) ? atoi(argv[3]) : 1;
+        double seconds = (argc > 4) ? atof(argv[4]) : 5.0;
+        int tickRate = (argc > 5) ? atoi(argv[5]) : 120;
+        if (matches > 0 && shards > 0 && seconds > 0.0 && tickRate > 0) return Bench(matches, shards, seconds, tickRate);
+    } else if (strcmp(mode, "clients") == 0) {
+        int matches = (argc > 2) ? atoi(argv[2]) : 50;
+        double seconds = (argc > 3) ? atof(argv[3]) : 10.0;
+        if (matches > 0 && seconds > 0.0) return Clients(matches, seconds);
+    }
+
+    fprintf(stderr, "usage: %s serve [base_port] [shards] [matches_per_shard] [tick_hz]\n"
+                    "       %s bench [matches] [shards] [seconds] [tick_hz]\n"
+                    "       %s clients [matches] [seconds]\n", argv[0], argv[0], argv[0]);
+    return 1;
+}
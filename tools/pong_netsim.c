@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_authority.h"
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_link.h"
+#include "../src/sim/pong_rollback.h"
+#include "pong_tool_common.h"
+
+/*
+*  Netcode under emulated links
+*  ----------------------------------------------------------------------------------
+*  Plays the same bot match over each link script (src/sim/pong_link.h), once
+*  as two rollback peers and once as an authoritative server with two predicting
+*  clients, and prints what the link cost each: how many rollbacks and
+*  re-simulated frames per second the peers ran, and how often reconciliation
+*  had to move a client's own paddle. Packets pass straight from link to session
+*  (no sockets) on virtual time, so every profile sees exactly its script.
+*
+*  Both runs are checked: the peers' confirmed state against a straight run over
+*  the inputs both bots produced (and their desync detectors must not have
+*  fired), and each client's last snapshot against the server's final state.
+*
+*  make headless
+*  ./bin/pong_netsim [seconds] [link ...]      (default: every built-in profile)
+*/
+
+typedef struct {
+    double rollbacks;           // Per second, both peers
+    double resimulated;         // Frames per second, both peers
+    uint32_t maxRollback;
+    uint64_t stalls;
+    bool agreed;
+} RollbackResult;
+
+typedef struct {
+    double corrections;         // Per second, both clients
+    float maxCorrection;
+    uint64_t starved;
+    uint64_t skipped;
+    bool agreed;
+} AuthorityResult;
+
+typedef struct {
+    uint64_t sent;
+    uint64_t lost;
+    uint64_t duplicated;
+    uint64_t reordered;
+} LinkTotals;
+
+static bool SameImage(const PongState *a, const PongState *b) {
+    unsigned char x[PONG_STATE_BYTES], y[PONG_STATE_BYTES];
+    pong_state_pack(a, x);
+    pong_state_pack(b, y);
+    return memcmp(x, y, PONG_STATE_BYTES) == 0;
+}
+
+static void AddTotals(LinkTotals *totals, const PongLink *link) {
+    totals->sent += link->sent;
+    totals->lost += link->lost;
+    totals->duplicated += link->duplicated;
+    totals->reordered += link->reordered;
+}
+
+static bool RunRollback(const PongLinkScript *script, int seconds, uint64_t seed, RollbackResult *result, LinkTotals *totals) {
+    const double tickMs = 1000.0 / PONG_TICK_RATE;
+    uint32_t ticks = (uint32_t)seconds * PONG_TICK_RATE;
+
+    PongRollback *peers = calloc(2, sizeof(PongRollback));
+    PongInput *history[2] = { calloc(ticks, sizeof(PongInput)), calloc(ticks, sizeof(PongInput)) };
+    PongLink links[2];          // From peer 1, from peer 2
+    bool linked = pong_link_init(&links[0], script, seed) & pong_link_init(&links[1], script, seed + 1);
+    if (!peers || !history[0] || !history[1] || !linked) return false;
+
+    Bot bots[2] = { { 0.0f, 0.0f, 2654435761u }, { 0.0f, 0.0f, 2246822519u } };
+    for (int p = 0; p < 2; p++) pong_rollback_init(&peers[p], seed, p, 2);
+
+    for (uint32_t t = 0; t < ticks; t++) {
+        double now = t * tickMs;
+        for (int p = 0; p < 2; p++) {
+            PongRollback *rb = &peers[p];
+            uint32_t slot = rb->localEnd;
+            if (slot < ticks && pong_rollback_add_local(rb, BotInput(&bots[p], &rb->state, p))) {
+                history[p][slot] = rb->local[slot % PONG_ROLLBACK_HISTORY];
+            }
+
+            unsigned char packet[PONG_ROLLBACK_PACKET_MAX];
+            pong_link_send(&links[p], now, packet, pong_rollback_write_packet(rb, packet, sizeof(packet)), 0);
+            size_t desync = pong_rollback_write_desync(rb, packet, sizeof(packet));
+            if (desync) pong_link_send(&links[p], now, packet, desync, 0);
+        }
+
+        for (int p = 0; p < 2; p++) {
+            PongLinkPacket arrived;
+            while (pong_link_due(&links[1 - p], now, &arrived)) pong_rollback_read_packet(&peers[p], arrived.data, arrived.size);
+        }
+        for (int p = 0; p < 2; p++) pong_rollback_advance(&peers[p]);
+    }
+
+    *result = (RollbackResult){ .agreed = true };
+    for (int p = 0; p < 2; p++) {
+        const PongRollback *rb = &peers[p];
+        result->rollbacks += (double)rb->rollbacks / seconds;
+        result->resimulated += (double)rb->resimulated / seconds;
+        if (rb->maxRollback > result->maxRollback) result->maxRollback = rb->maxRollback;
+        result->stalls += rb->stalls;
+
+        uint32_t confirmedTick;
+        const PongState *confirmed = pong_rollback_confirmed(rb, &confirmedTick);
+        PongState reference;
+        pong_init(&reference, seed);
+        for (uint32_t t = 0; t < confirmedTick; t++) pong_step(&reference, history[0][t] | history[1][t], PONG_TICK_DT);
+        result->agreed &= confirmed && SameImage(confirmed, &reference) && rb->desync.status == PONG_DESYNC_NONE;
+        AddTotals(totals, &links[p]);
+    }
+
+    pong_link_free(&links[0]);
+    pong_link_free(&links[1]);
+    free(history[0]);
+    free(history[1]);
+    free(peers);
+    return true;
+}
+
+static bool RunAuthority(const PongLinkScript *script, int seconds, uint64_t seed, AuthorityResult *result, LinkTotals *totals) {
+    const double tickMs = 1000.0 / PONG_TICK_RATE;
+    uint32_t ticks = (uint32_t)seconds * PONG_TICK_RATE;
+
+    PongAuthority *auth = malloc(sizeof(PongAuthority));
+    PongClient *clients = calloc(2, sizeof(PongClient));
+    PongLink up[2], down[2];
+    bool linked = true;
+    for (int p = 0; p < 2; p++) {
+        linked &= pong_link_init(&up[p], script, seed + 2 + 2 * (uint64_t)p) & pong_link_init(&down[p], script, seed + 3 + 2 * (uint64_t)p);
+    }
+    if (!auth || !clients || !linked) return false;
+
+    pong_authority_init(auth, seed);
+    for (int p = 0; p < 2; p++) {
+        unsigned char welcome[PONG_AUTHORITY_PACKET_MAX];
+        pong_client_init(&clients[p]);
+        pong_client_read(&clients[p], welcome, pong_authority_write_welcome(auth, p, welcome, sizeof(welcome)));
+    }
+
+    // The last stretch only exchanges packets, so the final snapshot gets through loss
+    Bot bots[2] = { { 0.0f, 0.0f, 2654435761u }, { 0.0f, 0.0f, 2246822519u } };
+    uint32_t drain = 4 * PONG_TICK_RATE;
+    for (uint32_t t = 0; t < ticks + drain; t++) {
+        double now = t * tickMs;
+        bool playing = t < ticks;
+        PongLinkPacket packet;
+        unsigned char data[PONG_AUTHORITY_PACKET_MAX];
+
+        for (int p = 0; p < 2; p++) {
+            while (pong_link_due(&down[p], now, &packet)) pong_client_read(&clients[p], packet.data, packet.size);
+            if (playing) {
+                PongState view = pong_client_view(&clients[p]);
+                pong_client_input(&clients[p], BotInput(&bots[p], &view, p));
+            }
+            pong_link_send(&up[p], now, data, pong_client_write_input(&clients[p], data, sizeof(data)), 0);
+        }
+
+        for (int p = 0; p < 2; p++) {
+            while (pong_link_due(&up[p], now, &packet)) pong_authority_read_input(auth, p, packet.data, packet.size);
+        }
+        if (playing) pong_authority_step(auth);
+        for (int p = 0; p < 2; p++) pong_link_send(&down[p], now, data, pong_authority_write_snapshot(auth, p, data, sizeof(data)), 0);
+    }
+
+    *result = (AuthorityResult){ .agreed = true };
+    for (int p = 0; p < 2; p++) {
+        result->corrections += (double)clients[p].corrections / seconds;
+        if (clients[p].maxCorrection > result->maxCorrection) result->maxCorrection = clients[p].maxCorrection;
+        result->starved += auth->queues[p].starved;
+        result->skipped += auth->queues[p].skipped;
+        result->agreed &= clients[p].serverTick == auth->tick && SameImage(&clients[p].server, &auth->state);
+        AddTotals(totals, &up[p]);
+        AddTotals(totals, &down[p]);
+        pong_link_free(&up[p]);
+        pong_link_free(&down[p]);
+    }
+
+    free(clients);
+    free(auth);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    int seconds = (argc > 1) ? atoi(argv[1]) : 120;
+    if (seconds <= 0) {
+        fprintf(stderr, "usage: %s [seconds] [link ...]\n", argv[0]);
+        return 1;
+    }
+
+    int scriptCount = (argc > 2) ? argc - 2 : pong_link_profile_count;
+    const uint64_t seed = 42;
+    int failed = 0;
+
+    printf("%d s bot match per link; rollback: input delay 2 ticks; rates are per second, both sides together\n", seconds);
+    printf("%-22s %6s %6s %6s | %9s %9s %5s %6s | %11s %7s %7s %7s | %s\n", "link", "lost%", "dup%", "reord%",
+           "rollbacks", "resim", "max", "stalls", "corrections", "max px", "starved", "skipped", "verify");
+
+    for (int s = 0; s < scriptCount; s++) {
+        const char *text = (argc > 2) ? argv[2 + s] : pong_link_profiles[s].name;
+        PongLinkScript script;
+        if (!pong_link_parse(text, &script)) {
+            fprintf(stderr, "bad link script: %s\n", text);
+            return 1;
+        }
+
+        RollbackResult rollback;
+        AuthorityResult authority;
+        LinkTotals totals = { 0 };
+        if (!RunRollback(&script, seconds, seed, &rollback, &totals) || !RunAuthority(&script, seconds, seed, &authority, &totals)) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+
+        double sent = totals.sent ? (double)totals.sent : 1.0;
+        bool agreed = rollback.agreed && authority.agreed;
+        failed += !agreed;
+        printf("%-22s %6.2f %6.2f %6.2f | %9.1f %9.1f %5u %6llu | %11.2f %7.1f %7llu %7llu | %s\n", text,
+               100.0 * (double)totals.lost / sent, 100.0 * (double)totals.duplicated / sent, 100.0 * (double)totals.reordered / sent,
+               rollback.rollbacks, rollback.resimulated, rollback.maxRollback, (unsigned long long)rollback.stalls,
+               authority.corrections, authority.maxCorrection, (unsigned long long)authority.starved,
+               (unsigned long long)authority.skipped, agreed ? "ok" : (rollback.agreed ? "server FAILED" : "rollback FAILED"));
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/sim/pong_pacer.h"
+#include "pong_tool_common.h"
+
+/*
+*  Frame pacing benchmark
+*  ----------------------------------------------------------------------------------
+*  Replays the game's window loop against an emulated vsync display, on a virtual
+*  clock (no sleeping): vblanks every 1/display_hz, a swap returning at the first
+*  vblank after the frame is submitted, drawing that takes draw_ms give or take 30%
+*  with a three-times spike on one frame in a hundred, and key changes at random
+*  times.
+*
+*  vsync:  a frame starts and reads the keys as soon as the swap returns
+*  paced:  PongPacer picks the latch, and keys are polled until then (the
+*          millisecond granularity of the polling is left out)
+*
+*  Either way the view is the newest tick run on to the latch with the keys read,
+*  so a key change is on screen from the first frame that read it.
+*
+*  Prints input-to-present latency (key change to the vblank that first shows it)
+*  and how many frames missed their vblank.
+*
+*  make headless
+*  ./bin/pong_pacer_bench [seconds] [display_hz] [draw_ms]
+*/
+
+#define SWAP_RETURN     0.0001          // From the vblank to the swap call returning
+#define CHANGES_PER_SEC 5.0
+
+typedef struct {
+    double *latency;
+    int count;
+    int frames;
+    int missed;                         // Vblanks skipped because a frame was not ready
+} Result;
+
+static double Uniform(unsigned int *rng) {
+    return (double)(NextRandom(rng) % 1000000u) / 1000000.0;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void Run(bool paced, const double *changes, int changeCount, double seconds, double period,
+                double drawSeconds, Result *result) {
+    unsigned int rng = 88172645u;       // Same draw times for both modes
+    PongPacer pacer;
+    pong_pacer_init(&pacer, period, SWAP_RETURN);
+
+    int shownUpTo = 0;                  // Changes on screen
+    double presented = SWAP_RETURN;
+    long vblank = 0;                    // Index of the vblank the last frame went out on
+    result->count = result->frames = result->missed = 0;
+    while (presented < seconds && shownUpTo < changeCount) {
+        double latched = paced ? fmax(pong_pacer_latch_time(&pacer), presented) : presented;
+        double cost = drawSeconds * (0.7 + 0.6 * Uniform(&rng)) * ((NextRandom(&rng) % 100 == 0) ? 3.0 : 1.0);
+        double submitted = latched + cost;
+        long shownAt = (long)floor(submitted / period) + 1;
+        double shown = shownAt * period;
+
+        // Every key change up to the latch is in this frame's view
+        for (; shownUpTo < changeCount && changes[shownUpTo] <= latched; shownUpTo++) {
+            result->latency[result->count++] = shown - changes[shownUpTo];
+        }
+
+        if (shownAt > vblank + 1) result->missed++;
+        vblank = shownAt;
+        result->frames++;
+        presented = shown + SWAP_RETURN;
+        pong_pacer_frame(&pacer, latched, submitted, presented);
+    }
+}
+
+static void Report(const char *name, Result *r, double period) {
+    if (r->count == 0) return;
+    qsort(r->latency, (size_t)r->count, sizeof(double), CompareDouble);
+    double sum = 0.0;
+    for (int i = 0; i < r->count; i++) sum += r->latency[i];
+    printf("%-6s input to present %5.2f ms mean, %5.2f p50, %5.2f p99 (%.2f refreshes); %d of %d frames missed their vblank\n",
+           name, sum / r->count * 1e3, r->latency[r->count / 2] * 1e3, r->latency[r->count * 99 / 100] * 1e3,
+           sum / r->count / period, r->missed, r->frames);
+}
+
+int main(int argc, char **argv) {
+    double seconds = (argc > 1) ? atof(argv[1]) : 600.0;
+    int displayHz = (argc > 2) ? atoi(argv[2]) : 60;
+    double drawMs = (argc > 3) ? atof(argv[3]) : 2.0;
+    if (seconds <= 0.0 || displayHz <= 0 || drawMs <= 0.0) {
+        fprintf(stderr, "usage: %s [seconds] [display_hz] [draw_ms]\n", argv[0]);
+        return 1;
+    }
+
+    // Key changes as a Poisson process
+    int capacity = (int)(seconds * CHANGES_PER_SEC * 2.0) + 16;
+    double *changes = malloc((size_t)capacity * sizeof(double));
+    Result results[2] = { { .latency = malloc((size_t)capacity * sizeof(double)) }, { .latency = malloc((size_t)capacity * sizeof(double)) } };
+    if (!changes || !results[0].latency || !results[1].latency) return 1;
+
+    unsigned int rng = 2463534242u;
+    int changeCount = 0;
+    for (double t = 0.1; changeCount < capacity; changeCount++) {
+        t += -log(1.0 - Uniform(&rng)) / CHANGES_PER_SEC;
+        if (t >= seconds - 1.0) break;
+        changes[changeCount] = t;
+    }
+
+    double period = 1.0 / displayHz;
+    Run(false, changes, changeCount, seconds, period, drawMs * 1e-3, &results[0]);
+    Run(true, changes, changeCount, seconds, period, drawMs * 1e-3, &results[1]);
+
+    printf("%.0f s, %d key changes, %d Hz display, %.1f ms draws\n", seconds, changeCount, displayHz, drawMs);
+    Report("vsync", &results[0], period);
+    Report("paced", &results[1], period);
+
+    free(changes);
+    free(results[0].latency);
+    free(results[1].latency);
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_batch.h"
+#include "../src/sim/pong_clock.h"
+
+/*
+*  Thread pool scaling benchmark
+*  ----------------------------------------------------------------------------------
+*  Steps the same batch of matches with pong_batch_step() on one thread, then with
+*  pong_batch_step_parallel() at 1, 2, 4, ... threads, and reports throughput, the
+*  speedup over one thread and whether every run ends in exactly the same state.
+*
+*  make headless
+*  ./bin/pong_pool_bench [lanes] [ticks] [max_threads]     (max_threads 0 = all cores)
+*/
+
+// Serve whenever possible, and track the ball with a per-lane aim error so rallies
+// end in both hits and misses
+static void BuildInputs(const PongBatch *batch, PongInput *inputs, int tick) {
+    for (int i = 0; i < batch->count; i++) {
+        if (batch->gameState[i] != GAME_PLAYING) { inputs[i] = PONG_INPUT_SERVE; continue; }
+
+        unsigned int h = (unsigned int)i * 2654435761u ^ (unsigned int)(tick / 240) * 2246822519u;
+        float aim = (float)(h % 160) - 80.0f;
+        float target = pong_lane_to_float(batch->ballY[i]) + aim;
+        float c1 = pong_lane_to_float(batch->paddle1Y[i]) + PADDLE_HEIGHT * 0.5f;
+        float c2 = pong_lane_to_float(batch->paddle2Y[i]) + PADDLE_HEIGHT * 0.5f;
+
+        PongInput in = 0;
+        if (target < c1 - 4.0f) in |= PONG_INPUT_P1_UP;
+        if (target > c1 + 4.0f) in |= PONG_INPUT_P1_DOWN;
+        if (target < c2 - 4.0f) in |= PONG_INPUT_P2_UP;
+        if (target > c2 + 4.0f) in |= PONG_INPUT_P2_DOWN;
+        inputs[i] = in;
+    }
+}
+
+static bool SameLanes(const PongBatch *a, const PongBatch *b) {
+    size_t n = (size_t)a->count;
+    return memcmp(a->ballX, b->ballX, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->ballY, b->ballY, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->ballVX, b->ballVX, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->ballVY, b->ballVY, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->paddle1Y, b->paddle1Y, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->paddle2Y, b->paddle2Y, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->score1, b->score1, n * sizeof(int)) == 0 &&
+           memcmp(a->score2, b->score2, n * sizeof(int)) == 0 &&
+           memcmp(a->gameState, b->gameState, n) == 0 &&
+           memcmp(a->rngKey, b->rngKey, n * sizeof(uint64_t)) == 0 &&
+           memcmp(a->rngCounter, b->rngCounter, n * sizeof(uint32_t)) == 0;
+}
+
+static double RunBatch(PongBatch *batch, PongPool *pool, PongInput *inputs, int ticks) {
+    double seconds = 0.0;
+
+    for (int t = 0; t < ticks; t++) {
+        BuildInputs(batch, inputs, t);
+
+        double t0 = pong_clock_now();
+        if (pool) pong_batch_step_parallel(batch, pool, inputs, PONG_TICK_DT);
+        else pong_batch_step(batch, inputs, PONG_TICK_DT);
+        seconds += pong_clock_now() - t0;
+    }
+
+    return seconds;
+}
+
+int main(int argc, char **argv) {
+    int lanes = (argc > 1) ? atoi(argv[1]) : 262144;
+    int ticks = (argc > 2) ? atoi(argv[2]) : 500;
+    int maxThreads = (argc > 3) ? atoi(argv[3]) : 0;
+
+    if (lanes <= 0 || ticks <= 0 || maxThreads < 0) {
+        fprintf(stderr, "usage: %s [lanes] [ticks] [max_threads]\n", argv[0]);
+        return 1;
+    }
+
+    PongPool pool;
+    if (!pong_pool_init(&pool, maxThreads)) {
+        fprintf(stderr, "could not start the thread pool\n");
+        return 1;
+    }
+    maxThreads = pool.threads;
+    pong_pool_free(&pool);
+
+    PongBatch reference;
+    PongInput *inputs = calloc((size_t)lanes, sizeof(PongInput));
+    if (!inputs || !pong_batch_init(&reference, lanes, 1)) {
+        fprintf(stderr, "out of memory for %d lanes\n", lanes);
+        return 1;
+    }
+
+    double single = RunBatch(&reference, NULL, inputs, ticks);
+    double steps = (double)lanes * ticks;
+    int failures = 0;
+
+    printf("%d lanes x %d ticks, %s kernel, chunks of %d lanes\n", lanes, ticks, pong_simd_name(reference.simd), PONG_BATCH_CHUNK);
+    printf("%-8s %14s %10s %11s  %s\n", "threads", "match-steps/s", "speedup", "efficiency", "state");
+    printf("%-8s %14.0f %9.2fx %10.0f%%  %s\n", "serial", steps / single, 1.0, 100.0, "reference");
+
+    for (int threads = 1; threads <= maxThreads; threads = (threads * 2 > maxThreads && threads != maxThreads) ? maxThreads : threads * 2) {
+        PongBatch batch;
+        if (!pong_pool_init(&pool, threads) || !pong_batch_init(&batch, lanes, 1)) {
+            fprintf(stderr, "could not set up a run with %d threads\n", threads);
+            return 1;
+        }
+
+        double seconds = RunBatch(&batch, &pool, inputs, ticks);
+        bool same = SameLanes(&reference, &batch);
+        if (!same) failures++;
+
+        printf("%-8d %14.0f %9.2fx %10.0f%%  %s\n", pool.threads, steps / seconds, single / seconds,
+               100.0 * single / seconds / pool.threads, same ? "identical to serial" : "MISMATCH");
+
+        pong_batch_free(&batch);
+        pong_pool_free(&pool);
+    }
+
+    pong_batch_free(&reference);
+    free(inputs);
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/net/pong_relay.h"
+#include "../src/sim/pong_clock.h"
+#include "pong_tool_common.h"
+
+/*
+*  Spectator relay benchmark
+*  ----------------------------------------------------------------------------------
+*  One bot match streamed to thousands of spectators over loopback, all in one
+*  process and in real time. Every frame the match state is pushed into the
+*  stream once and the relay fans it out; each spectator is a real socket that
+*  reads its backlog every few frames, the way an overlay process drawing at its
+*  own pace would. A share of them read only every few seconds, so they fall
+*  behind and exercise the keyframe catch-up.
+*
+*  Reports the relay's cost per frame (reading acknowledgements plus the fan-out)
+*  and per datagram, what a spectator receives, how many were catching up, and
+*  checks every spectator's decoded state against the match at that tick.
+*
+*  make headless
+*  ./bin/pong_relay [spectators] [seconds] [frame_hz] [slow_percent]
+*/
+
+#define HISTORY     1024    // Published states kept for checking, by frame
+#define READ_EVERY  4       // Frames between reads of a normal spectator
+#define SLOW_EVERY  3.0     // Seconds between reads of a slow one
+#define POLL_EVERY  256     // Spectators read between relay polls
+
+static void SleepUntil(double deadline) {
+    double wait = deadline - pong_clock_now();
+    if (wait <= 0.0) return;
+    struct timespec ts = { (time_t)wait, (long)((wait - (double)(time_t)wait) * 1e9) };
+    nanosleep(&ts, NULL);
+}
+
+static bool SameImage(const PongState *a, const PongState *b) {
+    unsigned char x[PONG_STATE_BYTES], y[PONG_STATE_BYTES];
+    pong_state_pack(a, x);
+    pong_state_pack(b, y);
+    return memcmp(x, y, PONG_STATE_BYTES) == 0;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv) {
+    int count = (argc > 1) ? atoi(argv[1]) : 10000;
+    double seconds = (argc > 2) ? atof(argv[2]) : 10.0;
+    int frameHz = (argc > 3) ? atoi(argv[3]) : 20;
+    int slowPercent = (argc > 4) ? atoi(argv[4]) : 5;
+    if (count <= 0 || seconds <= 0.0 || frameHz <= 0 || frameHz > PONG_TICK_RATE || slowPercent < 0 || slowPercent > 100) {
+        fprintf(stderr, "usage: %s [spectators] [seconds] [frame_hz] [slow_percent]\n", argv[0]);
+        return 1;
+    }
+
+    int ticksPerFrame = PONG_TICK_RATE / frameHz;
+    int frames = (int)(seconds * frameHz);
+    int slowFrames = (int)(SLOW_EVERY * frameHz);
+    const uint64_t seed = 0x5eed;
+    const uint32_t match = 7;
+
+    PongRelay relay;
+    if (!pong_relay_open(&relay, 0, match, count)) {
+        fprintf(stderr, "could not open the relay\n");
+        return 1;
+    }
+
+    PongSpectator *spectators = malloc((size_t)count * sizeof(PongSpectator));
+    PongState *history = malloc(HISTORY * sizeof(PongState));
+    double *relaySeconds = malloc((size_t)frames * sizeof(double));
+    if (!spectators || !history || !relaySeconds) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!pong_spectator_connect(&spectators[i], "127.0.0.1", pong_udp_port(&relay.udp), match)) {
+            fprintf(stderr, "could not open spectator %d (raise ulimit -n)\n", i);
+            return 1;
+        }
+    }
+
+    Bot bots[2] = { { 0.0f, 0.0f, 2654435761u }, { 0.0f, 0.0f, 2246822519u } };
+    PongState state;
+    pong_init(&state, seed);
+    pong_snapshot_quantize(&state);
+    PongStream stream;
+    pong_stream_init(&stream, seed);
+
+    double pushSeconds = 0.0, spectatorSeconds = 0.0, fullBytes = 0.0, deltaBytes = 0.0;
+    long mismatches = 0, late = 0, lagging = 0;
+    uint64_t catchingUpFrames = 0;
+    uint32_t tick = 0;
+
+    double start = pong_clock_now();
+    for (int f = 0; f < frames; f++) {
+        for (int t = 0; t < ticksPerFrame; t++) {
+            pong_step(&state, BotInput(&bots[0], &state, 0) | BotInput(&bots[1], &state, 1), PONG_TICK_DT);
+            pong_snapshot_quantize(&state);
+            tick++;
+        }
+        history[f % HISTORY] = state;
+
+        double t0 = pong_clock_now();
+        if (!pong_stream_push(&stream, &state, tick)) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        double t1 = pong_clock_now();
+        pong_relay_poll(&relay);
+        pong_relay_send(&relay, stream.full, stream.delta);
+        double t2 = pong_clock_now();
+        pushSeconds += t1 - t0;
+        fullBytes += (double)stream.full->size;
+        deltaBytes += stream.delta ? (double)stream.delta->size : (double)stream.full->size;
+        for (int i = 0; i < relay.count; i++) catchingUpFrames += relay.spectators[i].catchingUp;
+
+        // Spectators read their backlogs; acknowledgements are drained as they come in
+        double relayPoll = 0.0;
+        for (int i = 0; i < count; i++) {
+            bool slow = (i % 100) < slowPercent;
+            if ((f + i) % (slow ? slowFrames : READ_EVERY) != 0) continue;
+
+            PongSpectator *spectator = &spectators[i];
+            pong_spectator_tick(spectator);
+            if (spectator->watcher.synced) {
+                uint32_t frame = spectator->watcher.tick / (uint32_t)ticksPerFrame - 1;
+                if ((uint32_t)f - frame < HISTORY) mismatches += !SameImage(&spectator->watcher.state, &history[frame % HISTORY]);
+            }
+
+            if (i % POLL_EVERY == POLL_EVERY - 1) {
+                double p0 = pong_clock_now();
+                pong_relay_poll(&relay);
+                relayPoll += pong_clock_now() - p0;
+            }
+        }
+        double t3 = pong_clock_now();
+        relaySeconds[f] = t2 - t1 + relayPoll;
+        spectatorSeconds += t3 - t2 - relayPoll;
+
+        double deadline = start + (double)(f + 1) / frameHz;
+        if (pong_clock_now() > deadline) late++;
+        SleepUntil(deadline);
+    }
+    double wall = pong_clock_now() - start;
+
+    // Where each normal spectator is now, in frames behind the match
+    for (int i = 0; i < count; i++) {
+        const PongWatcher *watcher = &spectators[i].watcher;
+        if ((i % 100) >= slowPercent && (!watcher->synced || tick - watcher->tick > (uint32_t)(READ_EVERY * ticksPerFrame))) lagging++;
+    }
+
+    uint64_t decoded = 0, gaps = 0, keyframes = 0;
+    for (int i = 0; i < count; i++) {
+        decoded += spectators[i].watcher.decoded;
+        gaps += spectators[i].watcher.gaps;
+        keyframes += spectators[i].watcher.keyframes;
+    }
+
+    double relayTotal = 0.0;
+    for (int f = 0; f < frames; f++) relayTotal += relaySeconds[f];
+    qsort(relaySeconds, (size_t)frames, sizeof(double), CompareDouble);
+
+    printf("%d spectators (%d%% read every %.0f s, the rest every %d frames), %d Hz frames (%d ticks), %d frames in %.2f s\n",
+           count, slowPercent, SLOW_EVERY, READ_EVERY, frameHz, ticksPerFrame, frames, wall);
+    printf("stream         %.0f ns per push (one full + one delta encode); full frame %.1f bytes, delta %.1f bytes\n",
+           pushSeconds / frames * 1e9, fullBytes / frames, deltaBytes / frames);
+    printf("relay          per frame: mean %.2f ms, p50 %.2f, p99 %.2f, max %.2f; %.0f%% of the %.0f ms frame budget\n",
+           relayTotal / frames * 1e3, relaySeconds[frames / 2] * 1e3, relaySeconds[(int)(frames * 0.99)] * 1e3,
+           relaySeconds[frames - 1] * 1e3, relayTotal / wall * 100.0, 1e3 / frameHz);
+    printf("               %.2f us per datagram; %llu datagrams (%llu keyframes), %.1f bytes/s per spectator, %llu send errors\n",
+           relay.frames ? relayTotal / (double)relay.frames * 1e6 : 0.0, (unsigned long long)relay.frames,
+           (unsigned long long)relay.keyframes, (double)relay.bytes / count / wall, (unsigned long long)relay.sendErrors);
+    printf("catch-up       %llu fall-behinds; %.1f spectators catching up on an average frame\n",
+           (unsigned long long)relay.catchups, (double)catchingUpFrames / frames);
+    printf("spectators     %d joined, %llu frames decoded (%llu keyframes), %llu gaps; %.0f ms per frame reading them\n",
+           relay.count, (unsigned long long)decoded, (unsigned long long)keyframes, (unsigned long long)gaps,
+           spectatorSeconds / frames * 1e3);
+    printf("verify         %ld decoded states differ from the match, %ld normal spectators behind, %ld frames late\n",
+           mismatches, lagging, late);
+
+    for (int i = 0; i < count; i++) pong_spectator_close(&spectators[i]);
+    pong_stream_free(&stream);
+    pong_relay_close(&relay);
+    free(relaySeconds);
+    free(history);
+    free(spectators);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,346 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong.h"
+#include "../src/sim/pong_bytes.h"
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_desync.h"
+#include "../src/sim/pong_replay.h"
+#include "pong_tool_common.h"
+
+/*
+*  Replay recorder / player
+*  ----------------------------------------------------------------------------------
+*  record: plays one bot-vs-bot match and saves its inputs as a .pongrec
+*  play:   re-runs a .pongrec (from the game or from record) and prints the result
+*  verify: records and plays back many matches, checking every final state matches
+*  seek:   records a long bot session (back-to-back matches), then times random
+*          seeks through its keyframes and checks each against straight playback
+*  trace:  plays a .pongrec and saves every tick's state hash and image (.ponghash)
+*  diff:   compares two traces - say, one recording played by two builds or on two
+*          machines - and prints the first tick where they differ, both states
+*
+*  make headless
+*  ./bin/pong_replay record match.pongrec [seed]
+*  ./bin/pong_replay play match.pongrec
+*  ./bin/pong_replay verify scratch.pongrec [matches]
+*  ./bin/pong_replay seek scratch.pongrec [minutes] [seeks]
+*  ./bin/pong_replay trace match.pongrec match.ponghash
+*  ./bin/pong_replay diff a.ponghash b.ponghash
+*/
+
+#define MAX_TICKS_PER_MATCH 10000000
+#define TRACE_MAGIC  0x48534850u    // "PHSH"
+#define TRACE_HEADER 12             // magic, seed u64
+#define TRACE_RECORD (4 + PONG_STATE_BYTES)     // hash, image; one per state from tick 0
+
+// Bot matches from the start screen, every tick's input recorded. Stops at the
+// first GAME_OVER, or keeps restarting until maxTicks when session is set.
+static bool RecordMatch(uint64_t seed, const char *path, PongState *final, uint32_t *ticks,
+                        bool session, uint32_t maxTicks) {
+    PongState state;
+    PongRecorder rec;
+    pong_init(&state, seed);
+    pong_record_init(&rec, seed, PONG_TICK_RATE);
+
+    Bot bot1 = { 0.0f, 0.0f, (unsigned int)seed * 2654435761u | 1u };
+    Bot bot2 = { 0.0f, 0.0f, (unsigned int)seed * 2246822519u | 1u };
+
+    bool ok = true;
+    for (uint32_t t = 0; ok && (session || state.gameState != GAME_OVER) && t < maxTicks; t++) {
+        PongInput input = BotInput(&bot1, &state, 0) | BotInput(&bot2, &state, 1);
+
+        ok = pong_record_tick(&rec, &state, input);
+        pong_step(&state, input, PONG_TICK_DT);
+    }
+
+    ok = ok && pong_record_save(&rec, path);
+    *final = state;
+    *ticks = rec.ticks;
+    pong_record_free(&rec);
+    return ok;
+}
+
+static bool PlayMatch(const char *path, PongState *final, uint32_t *ticks) {
+    PongReplay replay;
+    if (!pong_replay_load(&replay, path)) return false;
+
+    PongState state;
+    PongInput input;
+    float dt = 1.0f / (float)replay.tickRate;
+    pong_init(&state, replay.seed);
+    while (pong_replay_next(&replay, &input)) pong_step(&state, input, dt);
+
+    *final = state;
+    *ticks = replay.ticks;
+    pong_replay_free(&replay);
+    return true;
+}
+
+static long FileSize(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+static bool SameState(const PongState *a, const PongState *b) {
+    return memcmp(&a->ball.position, &b->ball.position, sizeof(Vector2)) == 0 &&
+           memcmp(&a->ball.velocity, &b->ball.velocity, sizeof(Vector2)) == 0 &&
+           a->player1.position.y == b->player1.position.y && a->player2.position.y == b->player2.position.y &&
+           a->score1 == b->score1 && a->score2 == b->score2 && a->gameState == b->gameState &&
+           a->rngCounter == b->rngCounter && a->serveDirection == b->serveDirection &&
+           a->serveJustHappened == b->serveJustHappened;
+}
+
+static int CompareTicks(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Random seeks into a long session: time them, then check each against one
+// straight pass of playback
+static int SeekBench(const char *path, int minutes, int seeks) {
+    PongState state;
+    uint32_t ticks;
+    uint32_t sessionTicks = (uint32_t)minutes * 60u * PONG_TICK_RATE;
+    if (!RecordMatch(1, path, &state, &ticks, true, sessionTicks)) {
+        fprintf(stderr, "could not write %s\n", path);
+        return 1;
+    }
+
+    PongReplay replay;
+    if (!pong_replay_load(&replay, path)) {
+        fprintf(stderr, "could not read %s\n", path);
+        return 1;
+    }
+
+    uint32_t *targets = malloc((size_t)seeks * sizeof(uint32_t));
+    PongState *seeked = malloc((size_t)seeks * sizeof(PongState));
+    if (!targets || !seeked) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    unsigned int x = 2463534242u;
+    for (int i = 0; i < seeks; i++) targets[i] = NextRandom(&x) % (replay.ticks + 1);
+    qsort(targets, (size_t)seeks, sizeof(uint32_t), CompareTicks);
+
+    // Shuffled order so consecutive seeks don't share cache-warm keyframes
+    double worst = 0.0, total = 0.0;
+    for (int n = 0; n < seeks; n++) {
+        int i = (int)(((uint64_t)n * 2654435761u) % (uint64_t)seeks);
+        double t0 = pong_clock_now();
+        pong_replay_seek(&replay, targets[i], &seeked[i]);
+        double elapsed = pong_clock_now() - t0;
+        total += elapsed;
+        if (elapsed > worst) worst = elapsed;
+    }
+
+    int matched = 0;
+    PongInput input;
+    pong_replay_rewind(&replay);
+    pong_init(&state, replay.seed);
+    for (int i = 0; i < seeks; i++) {
+        while (replay.tick < targets[i] && pong_replay_next(&replay, &input)) pong_step(&state, input, PONG_TICK_DT);
+        matched += SameState(&state, &seeked[i]);
+    }
+
+    printf("session        %d min, %u ticks, %ld bytes (%d keyframes every %u ticks)\n",
+           minutes, replay.ticks, FileSize(path), replay.keyframeCount, replay.keyframeTicks);
+    printf("seek           %.1f us average, %.1f us worst over %d seeks\n", total / seeks * 1e6, worst * 1e6, seeks);
+    printf("verify         %d/%d seeks land on the state straight playback reaches\n", matched, seeks);
+
+    free(targets);
+    free(seeked);
+    pong_replay_free(&replay);
+    return (matched == seeks) ? 0 : 1;
+}
+
+static bool WriteTraceRecord(FILE *file, const PongState *state) {
+    unsigned char record[TRACE_RECORD];
+    pong_put_u32(record, pong_state_hash(state));
+    pong_state_pack(state, record + 4);
+    return fwrite(record, sizeof(record), 1, file) == 1;
+}
+
+static int Trace(const char *path, const char *out) {
+    PongReplay replay;
+    if (!pong_replay_load(&replay, path)) {
+        fprintf(stderr, "could not read %s\n", path);
+        return 1;
+    }
+    FILE *file = fopen(out, "wb");
+    if (!file) {
+        fprintf(stderr, "could not write %s\n", out);
+        pong_replay_free(&replay);
+        return 1;
+    }
+
+    unsigned char header[TRACE_HEADER];
+    pong_put_u32(header, TRACE_MAGIC);
+    pong_put_u32(header + 4, (uint32_t)replay.seed);
+    pong_put_u32(header + 8, (uint32_t)(replay.seed >> 32));
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1;
+
+    PongState state;
+    PongInput input;
+    float dt = 1.0f / (float)replay.tickRate;
+    pong_init(&state, replay.seed);
+    ok &= WriteTraceRecord(file, &state);
+    while (ok && pong_replay_next(&replay, &input)) {
+        pong_step(&state, input, dt);
+        ok &= WriteTraceRecord(file, &state);
+    }
+    ok &= fclose(file) == 0;
+
+    if (ok) printf("traced         %s: %u ticks -> %s, final hash %08x\n", path, replay.ticks, out, pong_state_hash(&state));
+    else fprintf(stderr, "could not write %s\n", out);
+    pong_replay_free(&replay);
+    return ok ? 0 : 1;
+}
+
+// A whole trace in memory; NULL if it is not one
+static unsigned char *LoadTrace(const char *path, uint64_t *seed, uint32_t *states) {
+    long size = FileSize(path);
+    FILE *file = fopen(path, "rb");
+    if (!file || size < TRACE_HEADER || (size - TRACE_HEADER) % TRACE_RECORD != 0) {
+        if (file) fclose(file);
+        return NULL;
+    }
+
+    unsigned char *data = malloc((size_t)size);
+    bool ok = data && fread(data, (size_t)size, 1, file) == 1 && pong_get_u32(data) == TRACE_MAGIC;
+    fclose(file);
+    if (!ok) {
+        free(data);
+        return NULL;
+    }
+    *seed = pong_get_u32(data + 4) | (uint64_t)pong_get_u32(data + 8) << 32;
+    *states = (uint32_t)((size - TRACE_HEADER) / TRACE_RECORD);
+    return data;
+}
+
+static void PrintTraceState(const char *label, uint64_t seed, const unsigned char *record) {
+    PongState state;
+    pong_init(&state, seed);
+    pong_state_unpack(&state, record + 4);
+
+    char text[PONG_DESYNC_DUMP_TEXT];
+    pong_desync_dump(&state, text, sizeof(text));
+    printf("%s\n%s", label, text);
+}
+
+static int Diff(const char *pathA, const char *pathB) {
+    uint64_t seedA, seedB;
+    uint32_t statesA, statesB;
+    unsigned char *a = LoadTrace(pathA, &seedA, &statesA);
+    unsigned char *b = LoadTrace(pathB, &seedB, &statesB);
+    if (!a || !b) {
+        fprintf(stderr, "could not read %s\n", a ? pathB : pathA);
+        free(a);
+        free(b);
+        return 1;
+    }
+
+    uint32_t common = (statesA < statesB) ? statesA : statesB;
+    uint32_t t = 0;
+    while (t < common && pong_get_u32(a + TRACE_HEADER + (size_t)t * TRACE_RECORD) == pong_get_u32(b + TRACE_HEADER + (size_t)t * TRACE_RECORD)) t++;
+
+    int result = 0;
+    if (seedA != seedB) {
+        printf("seeds differ   %llu vs %llu: not the same match\n", (unsigned long long)seedA, (unsigned long long)seedB);
+        result = 1;
+    } else if (t < common) {
+        printf("diverged       at tick %u (state after %u ticks) of %u\n", t, t, common - 1);
+        PrintTraceState(pathA, seedA, a + TRACE_HEADER + (size_t)t * TRACE_RECORD);
+        PrintTraceState(pathB, seedB, b + TRACE_HEADER + (size_t)t * TRACE_RECORD);
+        if (t > 0) PrintTraceState("last agreed state", seedA, a + TRACE_HEADER + (size_t)(t - 1) * TRACE_RECORD);
+        result = 1;
+    } else if (statesA != statesB) {
+        printf("same           for all %u common ticks, but one trace is longer (%u vs %u)\n", common - 1, statesA - 1, statesB - 1);
+        result = 1;
+    } else {
+        printf("same           all %u ticks hash alike\n", common - 1);
+    }
+
+    free(a);
+    free(b);
+    return result;
+}
+
+static int Usage(const char *name) {
+    fprintf(stderr, "usage: %s record <file> [seed] | play <file> | verify <file> [matches] | seek <file> [minutes] [seeks]"
+                    " | trace <file> <out> | diff <a> <b>\n", name);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) return Usage(argv[0]);
+    const char *mode = argv[1], *path = argv[2];
+    PongState state;
+    uint32_t ticks;
+
+    if (strcmp(mode, "record") == 0) {
+        uint64_t seed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 1;
+        if (!RecordMatch(seed, path, &state, &ticks, false, MAX_TICKS_PER_MATCH)) {
+            fprintf(stderr, "could not write %s\n", path);
+            return 1;
+        }
+        printf("recorded       %s: %u ticks, score %d-%d, %ld bytes\n", path, ticks, state.score1, state.score2, FileSize(path));
+        return 0;
+    }
+
+    if (strcmp(mode, "play") == 0) {
+        if (!PlayMatch(path, &state, &ticks)) {
+            fprintf(stderr, "could not read %s (missing, corrupt, or recorded in the other physics mode)\n", path);
+            return 1;
+        }
+        printf("played         %s: %u ticks, score %d-%d\n", path, ticks, state.score1, state.score2);
+        return 0;
+    }
+
+    if (strcmp(mode, "verify") == 0) {
+        int matches = (argc > 3) ? atoi(argv[3]) : 1000;
+        if (matches <= 0) return Usage(argv[0]);
+
+        int matched = 0;
+        long totalBytes = 0, maxBytes = 0;
+        double totalTicks = 0.0;
+        for (int m = 0; m < matches; m++) {
+            PongState recorded, played;
+            uint32_t recordedTicks, playedTicks;
+            if (!RecordMatch(1000u + (uint64_t)m, path, &recorded, &recordedTicks, false, MAX_TICKS_PER_MATCH) ||
+                !PlayMatch(path, &played, &playedTicks)) {
+                fprintf(stderr, "I/O error on %s\n", path);
+                return 1;
+            }
+
+            long bytes = FileSize(path);
+            totalBytes += bytes;
+            if (bytes > maxBytes) maxBytes = bytes;
+            totalTicks += recordedTicks;
+            matched += SameState(&recorded, &played) && recordedTicks == playedTicks;
+        }
+
+        printf("matches        %d, %.0f ticks (%.1f s) each on average\n", matches, totalTicks / matches, totalTicks / matches / PONG_TICK_RATE);
+        printf("file size      %.0f bytes average, %ld max (%.2f bits per tick)\n",
+               (double)totalBytes / matches, maxBytes, (double)totalBytes * 8.0 / totalTicks);
+        printf("verify         %d/%d playbacks end in the recorded state\n", matched, matches);
+        return (matched == matches) ? 0 : 1;
+    }
+
+    if (strcmp(mode, "seek") == 0) {
+        int minutes = (argc > 3) ? atoi(argv[3]) : 60;
+        int seeks = (argc > 4) ? atoi(argv[4]) : 1000;
+        if (minutes <= 0 || seeks <= 0) return Usage(argv[0]);
+        return SeekBench(path, minutes, seeks);
+    }
+
+    if (strcmp(mode, "trace") == 0 && argc > 3) return Trace(path, argv[3]);
+    if (strcmp(mode, "diff") == 0 && argc > 3) return Diff(path, argv[3]);
+
+    return Usage(argv[0]);
+}
@@ -0,0 +1,198 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/net/pong_server.h"
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_link.h"
+#include "pong_tool_common.h"
+
+/*
+*  Authoritative match server
+*  ----------------------------------------------------------------------------------
+*  serve: a real server. Listens on the port, seats the first two clients that
+*  join (./bin/build_osx --server host:port) and runs the match at PONG_TICK_RATE
+*  until killed.
+*
+*  bots: the server and two predicting bot clients in one process, every packet
+*  crossing an emulated link (src/sim/pong_link.h: a profile name such as
+*  transatlantic, or keys like delay=50,jitter=10,loss=1) in each direction.
+*  Time is virtual, one loop iteration per tick. Reports how often reconciliation had to move a
+*  client's own paddle, how often the server ran dry of a client's input, and
+*  checks that each client ends on exactly the server's state.
+*
+*  make headless
+*  ./bin/pong_server serve [port]
+*  ./bin/pong_server bots [link] [seconds]
+*/
+
+static int Serve(uint16_t port) {
+    PongServer server;
+    uint64_t seed = (uint64_t)time(NULL);
+    if (!pong_server_open(&server, port, seed)) {
+        fprintf(stderr, "cannot listen on port %u\n", port);
+        return 1;
+    }
+    printf("listening on port %u, %d Hz, seed %llu\n", pong_udp_port(&server.udp), PONG_TICK_RATE, (unsigned long long)seed);
+
+    // Sleep to each tick's deadline; a late tick is run at once, never skipped
+    const double tickSeconds = 1.0 / PONG_TICK_RATE;
+    double next = pong_clock_now();
+    int lastScore1 = 0, lastScore2 = 0, joined = 0;
+    for (;;) {
+        pong_server_tick(&server);
+
+        const PongState *state = &server.auth.state;
+        while (joined < server.joined) printf("player %d joined\n", ++joined);
+        if (state->score1 != lastScore1 || state->score2 != lastScore2) {
+            lastScore1 = state->score1;
+            lastScore2 = state->score2;
+            printf("tick %u  score %d-%d%s\n", server.auth.tick, lastScore1, lastScore2,
+                   (state->gameState == GAME_OVER) ? "  game over" : "");
+        }
+        fflush(stdout);
+
+        next += tickSeconds;
+        double wait = next - pong_clock_now();
+        if (wait > 0.0) {
+            struct timespec ts = { (time_t)wait, (long)((wait - (double)(time_t)wait) * 1e9) };
+            nanosleep(&ts, NULL);
+        } else if (wait < -0.25) {
+            next = pong_clock_now();    // Fell far behind (suspended?): do not race to catch up
+        }
+    }
+}
+
+static int Bots(const char *linkText, const PongLinkScript *script, int seconds) {
+    const uint64_t seed = 42;
+    const double tickMs = 1000.0 / PONG_TICK_RATE;
+    uint32_t ticks = (uint32_t)seconds * PONG_TICK_RATE;
+
+    PongAuthority *auth = malloc(sizeof(PongAuthority));
+    PongClient *clients = calloc(2, sizeof(PongClient));
+    PongLink up[2], down[2];        // Client -> server, server -> client
+    for (int p = 0; p < 2; p++) {
+        bool linked = pong_link_init(&up[p], script, seed + 2 * (uint64_t)p) & pong_link_init(&down[p], script, seed + 2 * (uint64_t)p + 1);
+        if (!linked) auth = NULL;
+    }
+    if (!auth || !clients) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    // Seats are handed out in-process; the JOIN/WELCOME exchange is the same two packets over UDP
+    pong_authority_init(auth, seed);
+    for (int p = 0; p < 2; p++) {
+        unsigned char welcome[PONG_AUTHORITY_PACKET_MAX];
+        pong_client_init(&clients[p]);
+        pong_client_read(&clients[p], welcome, pong_authority_write_welcome(auth, p, welcome, sizeof(welcome)));
+    }
+
+    Bot bots[2] = { { 0.0f, 0.0f, 2654435761u }, { 0.0f, 0.0f, 2246822519u } };
+    long upBytes = 0, downBytes = 0;
+    double clientSeconds = 0.0;
+    uint32_t lag[2] = { 0, 0 };
+
+    double now = 0.0;
+    for (uint32_t t = 0; t < ticks; t++) {
+        now = t * tickMs;
+        PongLinkPacket packet;
+
+        for (int p = 0; p < 2; p++) {
+            PongClient *client = &clients[p];
+            while (pong_link_due(&down[p], now, &packet)) pong_client_read(client, packet.data, packet.size);
+
+            PongState view = pong_client_view(client);
+            double t0 = pong_clock_now();
+            pong_client_input(client, BotInput(&bots[p], &view, p));
+            clientSeconds += pong_clock_now() - t0;
+            if (client->sent - client->acked > lag[p]) lag[p] = client->sent - client->acked;
+
+            unsigned char data[PONG_AUTHORITY_PACKET_MAX];
+            size_t size = pong_client_write_input(client, data, sizeof(data));
+            pong_link_send(&up[p], now, data, size, 0);
+            upBytes += (long)size;
+        }
+
+        for (int p = 0; p < 2; p++) {
+            while (pong_link_due(&up[p], now, &packet)) pong_authority_read_input(auth, p, packet.data, packet.size);
+        }
+        pong_authority_step(auth);
+
+        for (int p = 0; p < 2; p++) {
+            unsigned char data[PONG_SNAPSHOT_PACKET_MAX];
+            size_t size = pong_authority_write_snapshot(auth, p, data, sizeof(data));
+            pong_link_send(&down[p], now, data, size, 0);
+            downBytes += (long)size;
+        }
+    }
+
+    // Stop stepping and keep exchanging packets for a few seconds so the final
+    // snapshot gets through a lossy link; then every client must hold it
+    for (uint32_t t = 0; t < 4 * PONG_TICK_RATE; t++) {
+        now += tickMs;
+        PongLinkPacket packet;
+        for (int p = 0; p < 2; p++) {
+            unsigned char data[PONG_AUTHORITY_PACKET_MAX];
+            while (pong_link_due(&down[p], now, &packet)) pong_client_read(&clients[p], packet.data, packet.size);
+            pong_link_send(&up[p], now, data, pong_client_write_input(&clients[p], data, sizeof(data)), 0);
+            while (pong_link_due(&up[p], now, &packet)) pong_authority_read_input(auth, p, packet.data, packet.size);
+            pong_link_send(&down[p], now, data, pong_authority_write_snapshot(auth, p, data, sizeof(data)), 0);
+        }
+    }
+
+    int agreed = 0;
+    unsigned char serverImage[PONG_STATE_BYTES];
+    pong_state_pack(&auth->state, serverImage);
+    for (int p = 0; p < 2; p++) {
+        unsigned char clientImage[PONG_STATE_BYTES];
+        pong_state_pack(&clients[p].server, clientImage);
+        agreed += clients[p].serverTick == auth->tick && memcmp(clientImage, serverImage, PONG_STATE_BYTES) == 0;
+    }
+
+    printf("link           %s one way, each direction\n", linkText);
+    for (int p = 0; p < 2; p++) {
+        printf("  client %d     %llu/%llu packets lost up/down, %llu/%llu duplicated, %llu/%llu reordered\n", p + 1,
+               (unsigned long long)up[p].lost, (unsigned long long)down[p].lost, (unsigned long long)up[p].duplicated,
+               (unsigned long long)down[p].duplicated, (unsigned long long)up[p].reordered, (unsigned long long)down[p].reordered);
+    }
+    printf("server         tick %u, score %d-%d\n", auth->tick, auth->state.score1, auth->state.score2);
+    for (int p = 0; p < 2; p++) {
+        const PongClient *client = &clients[p];
+        const PongInputQueue *queue = &auth->queues[p];
+        printf("client %d       %llu corrections in %llu snapshots (max %.2f px), %u inputs max in flight, "
+               "server ran dry %llu ticks, skipped %llu\n",
+               p + 1, (unsigned long long)client->corrections, (unsigned long long)client->snapshots,
+               client->maxCorrection, lag[p], (unsigned long long)queue->starved, (unsigned long long)queue->skipped);
+    }
+    printf("bandwidth      %.1f bytes/tick up, %.1f bytes/tick down per client\n",
+           (double)upBytes / (2.0 * ticks), (double)downBytes / (2.0 * ticks));
+    printf("cpu            %.0f ns per client tick, reconciliation included\n", clientSeconds / (2.0 * ticks) * 1e9);
+    printf("own paddle     0 ticks of local latency; scores and game state from the server\n");
+    printf("verify         %d/2 clients hold the server's final state\n", agreed);
+
+    for (int p = 0; p < 2; p++) {
+        pong_link_free(&up[p]);
+        pong_link_free(&down[p]);
+    }
+    free(clients);
+    free(auth);
+    return (agreed == 2) ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "serve") == 0) {
+        return Serve((uint16_t)((argc > 2) ? atoi(argv[2]) : 7777));
+    }
+    if (argc > 1 && strcmp(argv[1], "bots") == 0) {
+        const char *linkText = (argc > 2) ? argv[2] : "delay=50,jitter=10";
+        int seconds = (argc > 3) ? atoi(argv[3]) : 120;
+        PongLinkScript script;
+        if (pong_link_parse(linkText, &script) && seconds > 0) return Bots(linkText, &script, seconds);
+    }
+
+    fprintf(stderr, "usage: %s serve [port]\n       %s bots [link] [seconds]\n", argv[0], argv[0]);
+    return 1;
+}
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_batch.h"
+#include "../src/sim/pong_clock.h"
+
+/*
+*  SIMD kernel benchmark
+*  ----------------------------------------------------------------------------------
+*  Runs the same batch of matches once per instruction set this CPU supports and
+*  reports the cost per match-step, the share of lanes the vector kernel resolved,
+*  and whether every level ends in exactly the same state as the scalar path.
+*
+*  make headless
+*  ./bin/pong_simd_bench [lanes] [ticks]
+*/
+
+typedef struct {
+    PongSimdLevel level;
+    double seconds;
+    long long slowLanes;
+    PongBatch batch;
+} Run;
+
+// Serve whenever possible, and track the ball with a per-lane aim error so rallies
+// end in both hits and misses
+static void BuildInputs(const PongBatch *batch, PongInput *inputs, int tick) {
+    for (int i = 0; i < batch->count; i++) {
+        if (batch->gameState[i] != GAME_PLAYING) { inputs[i] = PONG_INPUT_SERVE; continue; }
+
+        unsigned int h = (unsigned int)i * 2654435761u ^ (unsigned int)(tick / 240) * 2246822519u;
+        float aim = (float)(h % 160) - 80.0f;
+        float target = pong_lane_to_float(batch->ballY[i]) + aim;
+        float c1 = pong_lane_to_float(batch->paddle1Y[i]) + PADDLE_HEIGHT * 0.5f;
+        float c2 = pong_lane_to_float(batch->paddle2Y[i]) + PADDLE_HEIGHT * 0.5f;
+
+        PongInput in = 0;
+        if (target < c1 - 4.0f) in |= PONG_INPUT_P1_UP;
+        if (target > c1 + 4.0f) in |= PONG_INPUT_P1_DOWN;
+        if (target < c2 - 4.0f) in |= PONG_INPUT_P2_UP;
+        if (target > c2 + 4.0f) in |= PONG_INPUT_P2_DOWN;
+        inputs[i] = in;
+    }
+}
+
+static bool SameLanes(const PongBatch *a, const PongBatch *b) {
+    size_t n = (size_t)a->count;
+    return memcmp(a->ballX, b->ballX, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->ballY, b->ballY, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->ballVX, b->ballVX, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->ballVY, b->ballVY, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->paddle1Y, b->paddle1Y, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->paddle2Y, b->paddle2Y, n * sizeof(PongLaneValue)) == 0 &&
+           memcmp(a->score1, b->score1, n * sizeof(int)) == 0 &&
+           memcmp(a->score2, b->score2, n * sizeof(int)) == 0 &&
+           memcmp(a->gameState, b->gameState, n) == 0 &&
+           memcmp(a->rngKey, b->rngKey, n * sizeof(uint64_t)) == 0 &&
+           memcmp(a->rngCounter, b->rngCounter, n * sizeof(uint32_t)) == 0;
+}
+
+int main(int argc, char **argv) {
+    int lanes = (argc > 1) ? atoi(argv[1]) : 4096;
+    int ticks = (argc > 2) ? atoi(argv[2]) : 5000;
+
+    if (lanes <= 0 || ticks <= 0) {
+        fprintf(stderr, "usage: %s [lanes] [ticks]\n", argv[0]);
+        return 1;
+    }
+
+    PongSimdLevel best = pong_simd_best();
+    Run runs[PONG_SIMD_AVX2 + 1];
+    PongInput *inputs = calloc((size_t)lanes, sizeof(PongInput));
+    int failures = 0;
+
+    printf("%-8s %12s %14s %10s %10s  %s\n", "level", "ns/step", "match-steps/s", "speedup", "vector %", "state");
+
+    for (int level = PONG_SIMD_SCALAR; level <= (int)best; level++) {
+        Run *run = &runs[level];
+        run->level = (PongSimdLevel)level;
+        run->seconds = 0.0;
+        run->slowLanes = 0;
+
+        if (!pong_batch_init(&run->batch, lanes, 1)) {
+            fprintf(stderr, "out of memory for %d lanes\n", lanes);
+            return 1;
+        }
+        run->batch.simd = run->level;
+
+        for (int t = 0; t < ticks; t++) {
+            BuildInputs(&run->batch, inputs, t);
+
+            double t0 = pong_clock_now();
+            pong_batch_step(&run->batch, inputs, PONG_TICK_DT);
+            run->seconds += pong_clock_now() - t0;
+
+            for (int i = 0; i < lanes; i++) run->slowLanes += run->batch.slow[i];
+        }
+
+        bool same = (level == PONG_SIMD_SCALAR) || SameLanes(&runs[PONG_SIMD_SCALAR].batch, &run->batch);
+        if (!same) failures++;
+
+        double steps = (double)lanes * ticks;
+        printf("%-8s %12.2f %14.0f %9.2fx %9.1f%%  %s\n",
+               pong_simd_name(run->level),
+               run->seconds / steps * 1e9,
+               steps / run->seconds,
+               runs[PONG_SIMD_SCALAR].seconds / run->seconds,
+               100.0 * (1.0 - (double)run->slowLanes / steps),
+               same ? "identical to scalar" : "MISMATCH");
+    }
+
+    for (int level = PONG_SIMD_SCALAR; level <= (int)best; level++) pong_batch_free(&runs[level].batch);
+    free(inputs);
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_snapshot.h"
+#include "pong_tool_common.h"
+
+/*
+*  Snapshot codec benchmark
+*  ----------------------------------------------------------------------------------
+*  Plays bot matches on the snapshot grid (pong_step + pong_snapshot_quantize, as
+*  the server does), then encodes every tick's state against the state a given
+*  number of ticks earlier - the baseline a client a round trip behind would have
+*  acknowledged - and against nothing. Reports bytes per snapshot, encode and
+*  decode cost, and checks every decode against the original.
+*
+*  make headless
+*  ./bin/pong_snapshot_bench [matches] [ticks]
+*/
+
+static bool SameImage(const PongState *a, const PongState *b) {
+    unsigned char x[PONG_STATE_BYTES], y[PONG_STATE_BYTES];
+    pong_state_pack(a, x);
+    pong_state_pack(b, y);
+    return memcmp(x, y, PONG_STATE_BYTES) == 0;
+}
+
+int main(int argc, char **argv) {
+    int matches = (argc > 1) ? atoi(argv[1]) : 20;
+    int ticks = (argc > 2) ? atoi(argv[2]) : 28800;
+    if (matches <= 0 || ticks <= 0) {
+        fprintf(stderr, "usage: %s [matches] [ticks]\n", argv[0]);
+        return 1;
+    }
+
+    // Baseline age in ticks; 0 = full snapshot
+    const int ages[] = { 0, 1, 2, 12, 24, 31 };
+    const int ageCount = (int)(sizeof(ages) / sizeof(ages[0]));
+
+    PongState *states = malloc((size_t)ticks * sizeof(PongState));
+    PongState *decoded = malloc((size_t)ticks * sizeof(PongState));
+    unsigned char *encoded = malloc((size_t)ticks * PONG_SNAPSHOT_MAX);
+    size_t *sizes = malloc((size_t)ticks * sizeof(size_t));
+    if (!states || !decoded || !encoded || !sizes) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    double bytes[8] = { 0 }, encodeSeconds[8] = { 0 }, decodeSeconds[8] = { 0 };
+    long snapshots[8] = { 0 }, mismatches = 0;
+
+    for (int m = 0; m < matches; m++) {
+        Bot bots[2] = { { 0.0f, 0.0f, 2654435761u ^ (unsigned int)m }, { 0.0f, 0.0f, 2246822519u ^ (unsigned int)m } };
+        PongState state;
+        pong_init(&state, (uint64_t)m);
+        pong_snapshot_quantize(&state);
+        for (int t = 0; t < ticks; t++) {
+            states[t] = state;
+            pong_step(&state, BotInput(&bots[0], &state, 0) | BotInput(&bots[1], &state, 1), PONG_TICK_DT);
+            pong_snapshot_quantize(&state);
+        }
+
+        for (int a = 0; a < ageCount; a++) {
+            int age = ages[a];
+
+            double t0 = pong_clock_now();
+            for (int t = age; t < ticks; t++) {
+                const PongState *base = age ? &states[t - age] : NULL;
+                sizes[t] = pong_snapshot_encode(&states[t], base, (uint32_t)age, encoded + (size_t)t * PONG_SNAPSHOT_MAX, PONG_SNAPSHOT_MAX);
+            }
+            double t1 = pong_clock_now();
+
+            // Full snapshots decode over the match template, as a client's do
+            bool valid = true;
+            for (int t = age; t < ticks; t++) {
+                const PongState *base = age ? &states[t - age] : NULL;
+                if (!age) pong_init(&decoded[t], (uint64_t)m);
+                valid &= pong_snapshot_decode(&decoded[t], base, (uint32_t)age, encoded + (size_t)t * PONG_SNAPSHOT_MAX, sizes[t]);
+            }
+            double t2 = pong_clock_now();
+
+            for (int t = age; t < ticks; t++) mismatches += !valid || !SameImage(&decoded[t], &states[t]);
+
+            for (int t = age; t < ticks; t++) bytes[a] += (double)sizes[t];
+            encodeSeconds[a] += t1 - t0;
+            decodeSeconds[a] += t2 - t1;
+            snapshots[a] += ticks - age;
+        }
+    }
+
+    printf("%d bot matches x %d ticks; pong_state_pack() image is %d bytes, float fields alone 24\n", matches, ticks, PONG_STATE_BYTES);
+    printf("baseline                   bytes/tick   encode ns   decode ns\n");
+    for (int a = 0; a < ageCount; a++) {
+        char label[32];
+        if (ages[a] == 0) snprintf(label, sizeof(label), "none (full)");
+        else snprintf(label, sizeof(label), "%d ticks old (%.0f ms)", ages[a], ages[a] * 1000.0 / PONG_TICK_RATE);
+        printf("%-26s %10.2f   %9.1f   %9.1f\n", label, bytes[a] / (double)snapshots[a],
+               encodeSeconds[a] / (double)snapshots[a] * 1e9, decodeSeconds[a] / (double)snapshots[a] * 1e9);
+    }
+    printf("verify         %ld snapshots did not decode to the original\n", mismatches);
+
+    free(sizes);
+    free(encoded);
+    free(decoded);
+    free(states);
+    return mismatches ? 1 : 0;
+}
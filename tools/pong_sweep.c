@@ -0,0 +1,251 @@
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_pool.h"
+#include "../src/sim/pong_rng.h"
+#include "../src/sim/pong_sweep.h"
+
+/*
+*  Gameplay parameter sweep
+*  ----------------------------------------------------------------------------------
+*  Plays CPU-vs-CPU matches (src/sim/pong_sweep.h) at every point of a grid or of
+*  a random sample over the tunable constants and writes one CSV row per point:
+*  the constants, then mean, p10, p50, p90 and max of rally length (s), paddle
+*  hits per rally and match length (s). Points are spread over all cores.
+*
+*  grid:      each parameter given as name=lo:hi:count takes count evenly spaced
+*             values (count 1 = lo); the others keep the game's value.
+*  random:N:  N points, every parameter uniform over its range (name=lo:hi, or
+*             the default range below).
+*
+*  Parameters (game value, default range): paddle_speed px/s (600, 300:900),
+*  speed_increment (1.03, 1.0:1.1), max_speed px/s (1500, 800:2400), serve_speed
+*  px/s (480, 240:800), max_deflection degrees (75, 30:85). cpu1=/cpu2= pick the
+*  players (default normal; easy, normal, hard or reaction_ms,error_px), seed=
+*  the match seeds.
+*
+*  make headless
+*  ./bin/pong_sweep <out.csv> grid|random:N [matches] [threads] [name=value ...]
+*  ./bin/pong_sweep sweep.csv random:10000 1000 0
+*  ./bin/pong_sweep sweep.csv grid 1000 0 paddle_speed=400:800:5 max_deflection=45:85:5
+*/
+
+#define MAX_MATCH_SECONDS 600.0f
+#define DEG2RAD_F (3.14159265358979323846f / 180.0f)
+
+typedef struct {
+    const char *name;
+    size_t offset;                  // Into PongRules
+    float scale;                    // PongRules value per command-line unit
+    float lo, hi;                   // Default random range
+    float max;                      // Largest value the rules accept
+} Param;
+
+static const Param params[] = {
+    { "paddle_speed",    offsetof(PongRules, paddleSpeed),        1.0f,      300.0f, 900.0f,  1e5f },
+    { "speed_increment", offsetof(PongRules, ballSpeedIncrement), 1.0f,      1.0f,   1.1f,    10.0f },
+    { "max_speed",       offsetof(PongRules, ballMaxSpeed),       1.0f,      800.0f, 2400.0f, 1e5f },
+    { "serve_speed",     offsetof(PongRules, ballServeSpeed),     1.0f,      240.0f, 800.0f,  1e5f },
+    { "max_deflection",  offsetof(PongRules, maxDeflectionAngle), DEG2RAD_F, 30.0f,  85.0f,   89.0f },
+};
+#define PARAM_COUNT ((int)(sizeof(params) / sizeof(params[0])))
+
+typedef struct {
+    float lo, hi;
+    int count;                      // Grid values; 0 = not given
+} Axis;
+
+typedef struct {
+    PongRules *rules;
+    PongSweepStats *stats;
+    const PongSweepConfig *config;
+    _Atomic int failed;
+} Job;
+
+static float *Field(PongRules *rules, int param) {
+    return (float *)((char *)rules + params[param].offset);
+}
+
+static float Value(const PongRules *rules, int param) {
+    return *Field((PongRules *)rules, param) / params[param].scale;
+}
+
+// The first length chars of arg are exactly name
+static bool IsName(const char *arg, size_t length, const char *name) {
+    return strncmp(arg, name, length) == 0 && name[length] == '\0';
+}
+
+// "lo:hi" or "lo:hi:count"
+static bool ParseAxis(const char *text, const Param *param, Axis *axis) {
+    char *end;
+    axis->lo = strtof(text, &end);
+    if (end == text || *end != ':') return false;
+    const char *hiText = end + 1;
+    axis->hi = strtof(hiText, &end);
+    if (end == hiText) return false;
+    axis->count = 5;
+    if (*end == ':') {
+        const char *countText = end + 1;
+        axis->count = (int)strtol(countText, &end, 10);
+        if (end == countText || axis->count < 1) return false;
+    }
+    return *end == '\0' && axis->lo > 0.0f && axis->lo <= axis->hi && axis->hi <= param->max;
+}
+
+static void SweepTask(void *user, int first, int count) {
+    Job *job = user;
+    for (int i = first; i < first + count; i++) {
+        if (!pong_sweep_point(&job->rules[i], job->config, &job->stats[i])) job->failed = 1;
+    }
+}
+
+static void PrintDist(FILE *out, const PongSweepDist *d) {
+    fprintf(out, ",%.4g,%.4g,%.4g,%.4g,%.4g", d->mean, d->p10, d->p50, d->p90, d->max);
+}
+
+static void WriteCsv(FILE *out, const PongRules *rules, const PongSweepStats *stats, int points) {
+    fprintf(out, "point");
+    for (int p = 0; p < PARAM_COUNT; p++) fprintf(out, ",%s", params[p].name);
+    fprintf(out, ",matches,capped,player1_wins,rallies");
+    const char *dists[] = { "rally_s", "hits", "match_s" };
+    for (int d = 0; d < 3; d++) fprintf(out, ",%s_mean,%s_p10,%s_p50,%s_p90,%s_max", dists[d], dists[d], dists[d], dists[d], dists[d]);
+    fprintf(out, "\n");
+
+    for (int i = 0; i < points; i++) {
+        fprintf(out, "%d", i);
+        for (int p = 0; p < PARAM_COUNT; p++) fprintf(out, ",%.6g", Value(&rules[i], p));
+        fprintf(out, ",%d,%d,%d,%d", stats[i].matches, stats[i].capped, stats[i].player1Wins, stats[i].rallies);
+        PrintDist(out, &stats[i].rallySeconds);
+        PrintDist(out, &stats[i].rallyHits);
+        PrintDist(out, &stats[i].matchSeconds);
+        fprintf(out, "\n");
+    }
+}
+
+static int Usage(const char *argv0) {
+    fprintf(stderr, "usage: %s <out.csv> grid|random:N [matches] [threads] [name=lo:hi[:count] ...] [cpu1=..] [cpu2=..] [seed=..]\n", argv0);
+    fprintf(stderr, "       names:");
+    for (int p = 0; p < PARAM_COUNT; p++) fprintf(stderr, " %s", params[p].name);
+    fprintf(stderr, "\n");
+    return 1;
+}
+
+int main(int argc, char **argv) {
+#ifdef PONG_FIXED_POINT
+    fprintf(stderr, "sweeps change the float rules' constants: build without -DPONG_FIXED_POINT\n");
+    return 1;
+#endif
+    if (argc < 3) return Usage(argv[0]);
+
+    bool grid = strcmp(argv[2], "grid") == 0;
+    int samples = (strncmp(argv[2], "random:", 7) == 0) ? atoi(argv[2] + 7) : 0;
+    if (!grid && samples <= 0) return Usage(argv[0]);
+
+    PongSweepConfig config = { pong_cpu_levels[1].config, pong_cpu_levels[1].config, 1000, 1, MAX_MATCH_SECONDS };
+    int threads = 0;
+    int arg = 3;
+    if (arg < argc && !strchr(argv[arg], '=')) config.matches = atoi(argv[arg++]);
+    if (arg < argc && !strchr(argv[arg], '=')) threads = atoi(argv[arg++]);
+    if (config.matches <= 0 || threads < 0) return Usage(argv[0]);
+
+    Axis axes[PARAM_COUNT] = { 0 };
+    for (; arg < argc; arg++) {
+        const char *eq = strchr(argv[arg], '=');
+        if (!eq) return Usage(argv[0]);
+        size_t nameLength = (size_t)(eq - argv[arg]);
+        const char *value = eq + 1;
+
+        if (IsName(argv[arg], nameLength, "cpu1")) {
+            if (!pong_cpu_parse(value, &config.player1)) return Usage(argv[0]);
+            continue;
+        }
+        if (IsName(argv[arg], nameLength, "cpu2")) {
+            if (!pong_cpu_parse(value, &config.player2)) return Usage(argv[0]);
+            continue;
+        }
+        if (IsName(argv[arg], nameLength, "seed")) {
+            config.seed = strtoull(value, NULL, 10);
+            continue;
+        }
+
+        int p = 0;
+        while (p < PARAM_COUNT && !IsName(argv[arg], nameLength, params[p].name)) p++;
+        if (p == PARAM_COUNT || !ParseAxis(value, &params[p], &axes[p])) {
+            fprintf(stderr, "bad parameter: %s\n", argv[arg]);
+            return Usage(argv[0]);
+        }
+    }
+
+    // Points: the grid's cartesian product, or random draws over each range
+    long points = 1;
+    if (grid) {
+        for (int p = 0; p < PARAM_COUNT && points <= 10000000; p++) points *= axes[p].count ? axes[p].count : 1;
+    } else {
+        points = samples;
+    }
+    if (points > 10000000) {
+        fprintf(stderr, "%ld points is too many\n", points);
+        return 1;
+    }
+
+    PongRules *rules = malloc((size_t)points * sizeof(PongRules));
+    PongSweepStats *stats = malloc((size_t)points * sizeof(PongSweepStats));
+    FILE *out = fopen(argv[1], "w");
+    if (!rules || !stats || !out) {
+        fprintf(stderr, out ? "out of memory\n" : "cannot write %s\n", argv[1]);
+        return 1;
+    }
+
+    uint64_t key = pong_rng_key(config.seed);
+    for (long i = 0; i < points; i++) {
+        rules[i] = pong_default_rules;
+        long index = i;
+        for (int p = 0; p < PARAM_COUNT; p++) {
+            const Axis *axis = &axes[p];
+            float lo = axis->count ? axis->lo : params[p].lo, hi = axis->count ? axis->hi : params[p].hi;
+            float value;
+            if (grid) {
+                if (!axis->count) continue;
+                int step = (int)(index % axis->count);
+                index /= axis->count;
+                value = (axis->count > 1) ? lo + (hi - lo) * (float)step / (float)(axis->count - 1) : lo;
+            } else {
+                double u = pong_rng_draw(key, (uint64_t)i * PARAM_COUNT + (uint64_t)p) / 4294967295.0;
+                value = lo + (hi - lo) * (float)u;
+            }
+            *Field(&rules[i], p) = value * params[p].scale;
+        }
+    }
+
+    PongPool pool;
+    if (!pong_pool_init(&pool, threads)) {
+        fprintf(stderr, "could not start the thread pool\n");
+        return 1;
+    }
+
+    Job job = { rules, stats, &config, 0 };
+    double t0 = pong_clock_now();
+    pong_pool_run(&pool, (int)points, 1, SweepTask, &job);
+    double seconds = pong_clock_now() - t0;
+    if (job.failed) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    WriteCsv(out, rules, stats, (int)points);
+    fclose(out);
+
+    long matches = 0, capped = 0;
+    for (long i = 0; i < points; i++) matches += stats[i].matches, capped += stats[i].capped;
+    printf("%ld points x %d matches on %d threads in %.1f s: %.0f matches/s, %ld abandoned after %.0f s of play\n", points,
+           config.matches, pool.threads, seconds, (double)(matches + capped) / seconds, capped, MAX_MATCH_SECONDS);
+    printf("wrote %s\n", argv[1]);
+
+    pong_pool_free(&pool);
+    free(rules);
+    free(stats);
+    return 0;
+}
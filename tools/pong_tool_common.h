@@ -0,0 +1,53 @@
+#ifndef PONG_TOOL_COMMON_H
+#define PONG_TOOL_COMMON_H
+
+#include "../src/sim/pong.h"
+
+/*
+*  Shared tool helpers
+*  ----------------------------------------------------------------------------------
+*  The bot the headless tools play their matches with and its random numbers.
+*  Header only: every tool is a single translation unit.
+*
+*  Bot bots[2] = { { 0.0f, 0.0f, 2654435761u }, { 0.0f, 0.0f, 2246822519u } };
+*  PongInput input = BotInput(&bots[0], &state, 0) | BotInput(&bots[1], &state, 1);
+*/
+
+typedef struct {
+    float aimOffset;        // Where on the paddle this bot tries to meet the ball
+    float lastVelocityX;
+    unsigned int rng;       // xorshift state, never 0
+} Bot;
+
+// xorshift32 step
+static inline unsigned int NextRandom(unsigned int *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+// Chase the ball when it comes towards us, drift back to the middle otherwise.
+// Presses serve whenever the match is not in play.
+static inline PongInput BotInput(Bot *bot, const PongState *state, int player) {
+    const Ball *ball = &state->ball;
+    const Paddle *paddle = (player == 0) ? &state->player1 : &state->player2;
+
+    if ((ball->velocity.x > 0) != (bot->lastVelocityX > 0)) {
+        // New rally leg: pick a fresh aim point, occasionally a bad one
+        float spread = paddle->size.y * 0.65f;
+        bot->aimOffset = ((float)(NextRandom(&bot->rng) % 1000) / 999.0f * 2.0f - 1.0f) * spread;
+    }
+    bot->lastVelocityX = ball->velocity.x;
+
+    bool incoming = (player == 0) ? (ball->velocity.x < 0) : (ball->velocity.x > 0);
+    float target = incoming ? ball->position.y + bot->aimOffset : ARENA_HEIGHT * 0.5f;
+    float center = paddle->position.y + paddle->size.y * 0.5f;
+
+    PongInput input = (state->gameState != GAME_PLAYING) ? PONG_INPUT_SERVE : 0;
+    if (target < center - 4.0f) input |= (player == 0) ? PONG_INPUT_P1_UP : PONG_INPUT_P2_UP;
+    if (target > center + 4.0f) input |= (player == 0) ? PONG_INPUT_P1_DOWN : PONG_INPUT_P2_DOWN;
+    return input;
+}
+
+#endif // PONG_TOOL_COMMON_H
@@ -0,0 +1,106 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/sim/pong.h"
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_fastmath.h"
+
+/*
+*  Direction vector benchmark
+*  ----------------------------------------------------------------------------------
+*  Compares the two ways the simulation turns a deflection or serve angle into a
+*  unit vector: libm cosf/sinf + normalise (-DPONG_LIBM_TRIG) and the polynomials in
+*  pong_fastmath.h. Reports the error against double precision over every angle
+*  the game can produce, and the cost per direction.
+*
+*  make headless
+*  ./bin/pong_trig_bench [directions]
+*/
+
+#define ACCURACY_SAMPLES 1000001
+#define TIMING_ANGLES    4096
+
+typedef struct {
+    double sinError;        // Max |sin - true sin|
+    double cosError;
+    double lengthError;     // Max ||v| - 1|
+    double angleError;      // Max angle of v vs the requested angle, radians
+} Accuracy;
+
+static Vector2 LibmDirection(float angle) {
+    Vector2 v = { cosf(angle), sinf(angle) };
+    float length = sqrtf(v.x * v.x + v.y * v.y);
+    return (Vector2){ v.x / length, v.y / length };
+}
+
+static Vector2 FastDirection(float angle) {
+    return (Vector2){ pong_fast_cos(angle), pong_fast_sin(angle) };
+}
+
+static void Measure(Accuracy *acc, float angle, Vector2 v) {
+    double s = fabs((double)v.y - sin((double)angle));
+    double c = fabs((double)v.x - cos((double)angle));
+    double length = fabs(sqrt((double)v.x * v.x + (double)v.y * v.y) - 1.0);
+    double turn = fabs(atan2((double)v.y, (double)v.x) - (double)angle);
+
+    if (s > acc->sinError) acc->sinError = s;
+    if (c > acc->cosError) acc->cosError = c;
+    if (length > acc->lengthError) acc->lengthError = length;
+    if (turn > acc->angleError) acc->angleError = turn;
+}
+
+static void PrintAccuracy(const char *name, const Accuracy *acc) {
+    printf("%-6s %12.2e %12.2e %12.2e %14.3f\n", name, acc->sinError, acc->cosError, acc->lengthError, acc->angleError * 1e6);
+}
+
+int main(int argc, char **argv) {
+    long directions = (argc > 1) ? atol(argv[1]) : 50000000;
+    if (directions <= 0) {
+        fprintf(stderr, "usage: %s [directions]\n", argv[0]);
+        return 1;
+    }
+
+    // Accuracy: every deflection angle on a fine grid, plus every serve angle
+    Accuracy libm = { 0 }, fast = { 0 };
+    for (int i = 0; i < ACCURACY_SAMPLES; i++) {
+        float t = -1.0f + 2.0f * (float)i / (float)(ACCURACY_SAMPLES - 1);
+        float angle = t * MAX_DEFLECTION_ANGLE;
+        Measure(&libm, angle, LibmDirection(angle));
+        Measure(&fast, angle, FastDirection(angle));
+    }
+    for (int degrees = -20; degrees <= 20; degrees++) {
+        float angle = DEG2RAD * (float)degrees;
+        Measure(&libm, angle, LibmDirection(angle));
+        Measure(&fast, angle, FastDirection(angle));
+    }
+
+    printf("%-6s %12s %12s %12s %14s\n", "path", "sin error", "cos error", "|v| - 1", "angle (urad)");
+    PrintAccuracy("libm", &libm);
+    PrintAccuracy("fast", &fast);
+
+    // Speed: the same random deflection angles through each path
+    float angles[TIMING_ANGLES];
+    unsigned int x = 2463534242u;
+    for (int i = 0; i < TIMING_ANGLES; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        angles[i] = ((float)(x % 20001) / 10000.0f - 1.0f) * MAX_DEFLECTION_ANGLE;
+    }
+
+    static Vector2 out[TIMING_ANGLES];
+    double t0 = pong_clock_now();
+    for (long i = 0; i < directions; i++) out[i & (TIMING_ANGLES - 1)] = LibmDirection(angles[i & (TIMING_ANGLES - 1)]);
+    double t1 = pong_clock_now();
+    float check = out[0].x;
+    for (long i = 0; i < directions; i++) out[i & (TIMING_ANGLES - 1)] = FastDirection(angles[i & (TIMING_ANGLES - 1)]);
+    double t2 = pong_clock_now();
+    check += out[0].x;
+
+    double libmNs = (t1 - t0) / (double)directions * 1e9;
+    double fastNs = (t2 - t1) / (double)directions * 1e9;
+    printf("\n%-6s %12s\n", "path", "ns/dir");
+    printf("%-6s %12.2f\n", "libm", libmNs);
+    printf("%-6s %12.2f   (%.1fx)\n", "fast", fastNs, libmNs / fastNs);
+
+    return (check > 0.0f) ? 0 : 1;      // Keeps both loops' results live
+}
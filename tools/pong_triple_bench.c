@@ -0,0 +1,191 @@
+#define _POSIX_C_SOURCE 199309L
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/sim/pong_ai.h"
+#include "../src/sim/pong_clock.h"
+#include "../src/sim/pong_desync.h"
+#include "../src/sim/pong_triple.h"
+
+/*
+*  Triple buffer benchmark
+*  ----------------------------------------------------------------------------------
+*  stress: a writer thread steps a CPU-vs-CPU match and publishes every tick as fast as it
+*  can while a reader takes the latest frame in a tight loop. The writer notes
+*  every tick's state hash before publishing it; the reader checks both states of
+*  each new frame against the hashes for its tick, so a torn frame (or one mixing
+*  two ticks) shows up as a mismatch.
+*
+*  paced: the writer ticks at PONG_TICK_RATE like the game's simulation thread and
+*  the reader wakes at display_hz like its window thread; prints how old the
+*  newest frame is when a display frame picks it up.
+*
+*  make headless
+*  ./bin/pong_triple_bench [seconds] [display_hz]
+*/
+
+#define STRESS_MAX_TICKS (1u << 23)
+
+typedef struct {
+    PongState state;
+    PongState previous;
+    PongCpu cpus[2];
+    uint64_t tick;
+} Match;
+
+typedef struct {
+    PongTripleBuffer frames;
+    double seconds;
+    bool paced;
+    _Atomic bool done;
+    uint32_t *hashes;               // Stress: state hash of every tick, by tick
+    uint64_t published;
+    int late;                       // Paced ticks that started over a tick late
+} Shared;
+
+static void InitMatch(Match *m) {
+    memset(m, 0, sizeof(*m));
+    pong_init(&m->state, 1000u);
+    m->previous = m->state;
+    pong_cpu_init(&m->cpus[0], 0, pong_cpu_levels[1].config, 2654435761u);
+    pong_cpu_init(&m->cpus[1], 1, pong_cpu_levels[1].config, 2246822519u);
+}
+
+static void Advance(Match *m) {
+    m->previous = m->state;
+    PongInput input = (m->state.gameState != GAME_PLAYING) ? PONG_INPUT_SERVE : 0;
+    input |= pong_cpu_input(&m->cpus[0], &m->state) | pong_cpu_input(&m->cpus[1], &m->state);
+    pong_step(&m->state, input, PONG_TICK_DT);
+    m->tick++;
+}
+
+static void *Writer(void *arg) {
+    Shared *shared = arg;
+    Match m;
+    InitMatch(&m);
+
+    double start = pong_clock_now();
+    if (shared->hashes) shared->hashes[0] = pong_state_hash(&m.state);
+    while (pong_clock_now() - start < shared->seconds) {
+        if (shared->hashes && m.tick + 1 >= STRESS_MAX_TICKS) break;
+        Advance(&m);
+        if (shared->hashes) shared->hashes[m.tick] = pong_state_hash(&m.state);
+
+        PongSimFrame *frame = pong_triple_back(&shared->frames);
+        frame->previous = m.previous;
+        frame->current = m.state;
+        frame->tick = m.tick;
+        frame->time = shared->paced ? start + m.tick * (double)PONG_TICK_DT : pong_clock_now();
+        pong_triple_publish(&shared->frames);
+        shared->published++;
+
+        if (shared->paced) {
+            double due = start + (m.tick + 1) * (double)PONG_TICK_DT;
+            if (pong_clock_now() > due + PONG_TICK_DT) shared->late++;
+            pong_clock_sleep_until(due);
+        }
+    }
+    atomic_store(&shared->done, true);
+    return NULL;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static bool Stress(double seconds) {
+    Shared shared = { .seconds = seconds, .hashes = malloc(STRESS_MAX_TICKS * sizeof(uint32_t)) };
+    Match first;
+    InitMatch(&first);
+    pong_triple_init(&shared.frames, &(PongSimFrame){ first.previous, first.state, 0, pong_clock_now() });
+
+    pthread_t writer;
+    if (!shared.hashes || pthread_create(&writer, NULL, Writer, &shared) != 0) return false;
+
+    uint64_t reads = 0, frames = 0, skipped = 0, torn = 0, lastTick = 0;
+    while (!atomic_load(&shared.done)) {
+        const PongSimFrame *frame = pong_triple_latest(&shared.frames);
+        reads++;
+        if (frame->tick == lastTick) continue;
+        if (frame->tick < lastTick) {
+            torn++;     // Went backwards: an older frame resurfaced
+            continue;
+        }
+
+        skipped += frame->tick - lastTick - 1;
+        lastTick = frame->tick;
+        frames++;
+        if (pong_state_hash(&frame->current) != shared.hashes[frame->tick] ||
+            pong_state_hash(&frame->previous) != shared.hashes[frame->tick - 1]) torn++;
+    }
+    pthread_join(writer, NULL);
+    free(shared.hashes);
+
+    printf("stress         %llu frames published, %llu reads, %llu new frames checked, %llu skipped, %llu torn\n",
+           (unsigned long long)shared.published, (unsigned long long)reads, (unsigned long long)frames,
+           (unsigned long long)skipped, (unsigned long long)torn);
+    return torn == 0 && frames > 0;
+}
+
+static bool Paced(double seconds, int displayHz) {
+    Shared shared = { .seconds = seconds, .paced = true };
+    Match first;
+    InitMatch(&first);
+    pong_triple_init(&shared.frames, &(PongSimFrame){ first.previous, first.state, 0, pong_clock_now() });
+
+    int displayFrames = (int)(seconds * displayHz);
+    double *ages = malloc((size_t)(displayFrames > 0 ? displayFrames : 1) * sizeof(double));
+    pthread_t writer;
+    if (!ages || pthread_create(&writer, NULL, Writer, &shared) != 0) return false;
+
+    double start = pong_clock_now();
+    int count = 0;
+    for (int i = 1; i <= displayFrames && !atomic_load(&shared.done); i++) {
+        pong_clock_sleep_until(start + (double)i / displayHz);
+        const PongSimFrame *frame = pong_triple_latest(&shared.frames);
+        ages[count++] = pong_clock_now() - frame->time;
+    }
+    pthread_join(writer, NULL);
+    if (count == 0) return false;
+
+    qsort(ages, (size_t)count, sizeof(double), CompareDouble);
+    printf("paced          %d Hz display over %d Hz ticks: newest frame %.2f ms old (p50), %.2f ms (p99), %.2f ms (max); %d late ticks\n",
+           displayHz, PONG_TICK_RATE, ages[count / 2] * 1e3, ages[count * 99 / 100] * 1e3, ages[count - 1] * 1e3, shared.late);
+    free(ages);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    double seconds = (argc > 1) ? atof(argv[1]) : 2.0;
+    int displayHz = (argc > 2) ? atoi(argv[2]) : 60;
+    if (seconds <= 0.0 || displayHz <= 0) {
+        fprintf(stderr, "usage: %s [seconds] [display_hz]\n", argv[0]);
+        return 1;
+    }
+
+    // Uncontended cost of each side
+    static PongTripleBuffer tb;
+    PongSimFrame frame = { 0 };
+    pong_triple_init(&tb, &frame);
+    const int rounds = 1000000;
+    double t0 = pong_clock_now();
+    for (int i = 0; i < rounds; i++) {
+        pong_triple_back(&tb)->tick = (uint64_t)i;
+        pong_triple_publish(&tb);
+    }
+    double publishSeconds = pong_clock_now() - t0;
+    volatile uint64_t sink = 0;
+    t0 = pong_clock_now();
+    for (int i = 0; i < rounds; i++) sink += pong_triple_latest(&tb)->tick;
+    double readSeconds = pong_clock_now() - t0;
+    (void)sink;
+    printf("cost           publish %.1f ns, latest %.1f ns (one thread, no frame copy)\n",
+           publishSeconds / rounds * 1e9, readSeconds / rounds * 1e9);
+
+    bool ok = Stress(seconds);
+    ok = Paced(seconds, displayHz) && ok;
+    return ok ? 0 : 1;
+}